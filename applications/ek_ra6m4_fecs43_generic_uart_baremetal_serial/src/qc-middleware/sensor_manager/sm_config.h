@@ -0,0 +1,73 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+/*
+  Sensor Manager persistent configuration (used by Sensor Manager only)
+
+  The attributes set with sm_set_sensor_attribute() are saved in a record in data flash and restored by sm_init().
+  The storage area is split in slots of whole erase blocks that are used in turn (wear levelling): each save writes
+  a record with a higher sequence number in the next slot, the previous record stays intact until a later save
+  reuses its slot. The commit word of a record is written last, after the data and its CRC, so a record interrupted
+  by a reset is ignored and the previous one is loaded.
+
+  Record layout (4 byte aligned):
+  sm_config_header | sm_config_entry[count] | CRC-32 of header and entries | commit word
+*/
+#ifndef __SM_CONFIG_H
+#define __SM_CONFIG_H
+#include <stdint.h>
+#include "sm.h"
+
+#define SM_CONFIG_VERSION           (1U)
+#define SM_CONFIG_FLASH_BLOCK_SIZE  (64U)   // erase unit of the RA data flash, writes are multiples of 4 bytes
+
+// Attributes of an instance set by the application, the others keep their default value
+#define SM_CONFIG_ACQUISITION_INTERVAL  (1U << 0)
+#define SM_CONFIG_SAMPLE_INTERVAL       (1U << 1)
+
+typedef struct {
+    uint32_t flags;                 // SM_CONFIG_xxx, attributes saved in this entry
+    uint32_t acquisition_interval;
+    uint32_t sample_interval;
+} sm_config_entry;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;                 // number of entries
+    uint32_t sequence;              // incremented on each save, the valid record with the highest sequence is loaded
+    uint32_t layout;                // hash of the instance table, records written for other sensor definitions are ignored
+} sm_config_header;
+
+/*******************************************************************************************************************//**
+ * @brief       Load the newest valid record, the storage area is read once, in place
+ * @param[out]  entries, one per instance
+ * @param[in]   number of entries
+ * @param[in]   hash of the instance table
+ * @retval      SM_OK or SM_ERROR if there is no record for this instance table
+ ***********************************************************************************************************************/
+sm_result sm_config_load(sm_config_entry * entries, uint16_t count, uint32_t layout);
+/*******************************************************************************************************************//**
+ * @brief       Save a new record in the next slot
+ * @param[in]   entries, one per instance
+ * @param[in]   number of entries
+ * @param[in]   hash of the instance table
+ * @retval      one of sm_result
+ ***********************************************************************************************************************/
+sm_result sm_config_store(sm_config_entry const * entries, uint16_t count, uint32_t layout);
+/*******************************************************************************************************************//**
+ * @brief       Erase all records
+ * @param[in]   none
+ * @retval      one of sm_result
+ ***********************************************************************************************************************/
+sm_result sm_config_clear(void);
+
+// Storage port, sm_config_flash.c implements it with the data flash driver (offsets are relative to the area start)
+sm_result sm_config_flash_open(void);
+uint8_t const * sm_config_flash_data(void);
+sm_result sm_config_flash_erase(uint32_t offset, uint32_t size);
+sm_result sm_config_flash_write(uint32_t offset, uint8_t const * data, uint32_t size);
+
+#endif
@@ -0,0 +1,131 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+/*
+  Sensor Manager subscriptions
+
+  Any number of subscribers can receive the samples of an instance, of a sensor type or of all sensors.
+  Each published sample is stored once in a shared, reference counted record and every subscriber receives a
+  pointer to that same record, samples are never copied per subscriber.
+  A subscriber can use a callback (called from sm_run() context), a ring of pending samples that is drained by the
+  application with sm_subscriber_receive() / sm_sample_release(), or both (ie.: the callback only signals a task).
+
+  Usage:
+  static sm_sample const * mqtt_ring[8];
+  static sm_subscriber mqtt_subscriber;
+  sm_subscriber_init(&mqtt_subscriber, NULL, NULL, mqtt_ring, 8, SM_OVERFLOW_DROP_OLDEST);
+  sm_subscribe_by_type(&mqtt_subscriber, SENSOR_ANY_TYPE);
+  ...
+  sm_sample const * sample;
+  while (SM_OK == sm_subscriber_receive(&mqtt_subscriber, &sample)) {
+      publish(sample);
+      sm_sample_release(sample);
+  }
+*/
+#ifndef __SM_SUBSCRIBER_H
+#define __SM_SUBSCRIBER_H
+#include <stdint.h>
+#include "sm.h"
+
+// A published sample, size is sizeof(int32_t) for raw samples or sizeof(sm_aggregate) for windowed instances
+typedef struct {
+  sm_handle handle;
+  uint32_t sequence;        // per instance sample number, see sm_sequence_check
+  uint32_t timestamp;
+  uint16_t size;
+  union {
+    int32_t data;
+    sm_aggregate aggregate;
+  };
+} sm_sample;
+
+// What to do when the ring of a subscriber is full
+typedef enum {
+  SM_OVERFLOW_DROP_NEWEST,      // keep the pending samples, drop the new one
+  SM_OVERFLOW_DROP_OLDEST       // drop the oldest pending sample to make room for the new one
+} sm_overflow_policy;
+
+typedef void (* sm_sample_callback)(sm_sample const * sample, void * context);
+
+typedef struct st_sm_subscriber {
+  struct st_sm_subscriber * p_next;     // internal, list of subscribers
+  sm_handle handle;                     // internal, subscribed instance (0 if subscribed by type)
+  sm_type type;                         // internal, subscribed type
+  sm_sample_callback p_callback;
+  void * p_context;
+  sm_sample const ** pp_ring;
+  uint16_t ring_size;
+  uint16_t head;
+  uint16_t tail;
+  uint16_t count;
+  sm_overflow_policy policy;
+  uint32_t dropped;                     // number of samples dropped by the overflow policy
+} sm_subscriber;
+
+/*******************************************************************************************************************//**
+ * @brief       Initialize a subscriber
+ * @param[in]   pointer to the subscriber (must remain valid while subscribed)
+ * @param[in]   callback called with each sample from sm_run() context (NULL if not used)
+ * @param[in]   user context passed to the callback
+ * @param[in]   storage for pending samples (NULL if not used)
+ * @param[in]   number of entries in the storage
+ * @param[in]   overflow policy for the pending samples
+ * @retval      none
+ ***********************************************************************************************************************/
+void sm_subscriber_init(sm_subscriber * p_sub, sm_sample_callback callback, void * context,
+                        sm_sample const ** pp_ring, uint16_t ring_size, sm_overflow_policy policy);
+/*******************************************************************************************************************//**
+ * @brief       Subscribe to the samples of a single sensor
+ * @param[in]   pointer to an initialized subscriber
+ * @param[in]   handle of the desired sensor
+ * @retval      SM_OK or SM_ERROR if the subscriber is already subscribed
+ ***********************************************************************************************************************/
+sm_result sm_subscribe_by_handle(sm_subscriber * p_sub, sm_handle handle);
+/*******************************************************************************************************************//**
+ * @brief       Subscribe to the samples of all sensors of a type
+ * @param[in]   pointer to an initialized subscriber
+ * @param[in]   sensor type, or SENSOR_ANY_TYPE for all sensors
+ * @retval      SM_OK or SM_ERROR if the subscriber is already subscribed
+ ***********************************************************************************************************************/
+sm_result sm_subscribe_by_type(sm_subscriber * p_sub, sm_type type);
+/*******************************************************************************************************************//**
+ * @brief       Remove a subscriber, any pending samples are released
+ * @param[in]   pointer to the subscriber
+ * @retval      SM_OK or SM_ERROR if the subscriber was not found
+ ***********************************************************************************************************************/
+sm_result sm_unsubscribe(sm_subscriber * p_sub);
+/*******************************************************************************************************************//**
+ * @brief       Get the oldest pending sample of a subscriber (non-blocking). The sample must be released with
+ *              sm_sample_release() once it has been consumed
+ * @param[in]   pointer to the subscriber
+ * @param[out]  pointer to the sample
+ * @retval      SM_OK or SM_ERROR if there is no pending sample
+ ***********************************************************************************************************************/
+sm_result sm_subscriber_receive(sm_subscriber * p_sub, sm_sample const ** pp_sample);
+/*******************************************************************************************************************//**
+ * @brief       Release a sample obtained with sm_subscriber_receive()
+ * @param[in]   pointer to the sample
+ * @retval      none
+ ***********************************************************************************************************************/
+void sm_sample_release(sm_sample const * p_sample);
+/*******************************************************************************************************************//**
+ * @brief       Get the number of samples that could not be published because all records were in use
+ * @param[in]   none
+ * @retval      number of samples lost
+ ***********************************************************************************************************************/
+uint32_t sm_subscriber_get_pool_drops(void);
+
+/*******************************************************************************************************************//**
+ * @brief       Publish a sample to all matching subscribers (called by Sensor Manager only)
+ * @param[in]   type of the sensor
+ * @param[in]   handle of the sensor
+ * @param[in]   pointer to the sample data (int32_t or sm_aggregate)
+ * @param[in]   size of the sample data
+ * @param[in]   sequence number of the sample
+ * @retval      none
+ ***********************************************************************************************************************/
+void sm_subscriber_publish(sm_type type, sm_handle handle, uint8_t const * buffer, uint16_t size, uint32_t sequence);
+
+#endif
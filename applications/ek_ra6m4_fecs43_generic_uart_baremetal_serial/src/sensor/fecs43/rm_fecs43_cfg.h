@@ -1,12 +0,0 @@
-#ifndef RM_FECS43_CFG_H_
-#define RM_FECS43_CFG_H_
-#ifdef __cplusplus
-            extern "C" {
-            #endif
-
-#define RM_FECS43_CFG_PARAM_CHECKING_ENABLE   (BSP_CFG_PARAM_CHECKING_ENABLE)
-
-#ifdef __cplusplus
-            }
-            #endif
-#endif /* RM_FECS43_CFG_H_ */
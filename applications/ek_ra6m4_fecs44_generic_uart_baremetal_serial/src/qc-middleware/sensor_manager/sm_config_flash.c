@@ -0,0 +1,54 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+#include <stdint.h>
+#include "hal_data.h"
+#include "common_utils.h"
+#include "sm_config.h"
+// Uncomment the desired debug level
+#include "log_disabled.h"
+//#include "log_error.h"
+//#include "log_warning.h"
+//#include "log_info.h"
+//#include "log_debug.h"
+
+#if SM_CFG_CONFIG_ENABLE
+// Storage port on the RA data flash (g_flash0, r_flash_hp without background operation, so calls are blocking).
+// The data flash is memory mapped, records are read in place
+#define CONFIG_AREA_START   (BSP_FEATURE_FLASH_DATA_FLASH_START + SM_CFG_CONFIG_FLASH_OFFSET)
+
+sm_result sm_config_flash_open(void) {
+    fsp_err_t status = g_flash0.p_api->open(g_flash0.p_ctrl, g_flash0.p_cfg);
+    if ((FSP_SUCCESS != status) && (FSP_ERR_ALREADY_OPEN != status)) {
+        log_error("Flash open err %d", status);
+        return SM_ERROR;
+    }
+    return SM_OK;
+}
+
+uint8_t const * sm_config_flash_data(void) {
+    return (uint8_t const *)CONFIG_AREA_START;
+}
+
+sm_result sm_config_flash_erase(uint32_t offset, uint32_t size) {
+    fsp_err_t status = g_flash0.p_api->erase(g_flash0.p_ctrl, CONFIG_AREA_START + offset,
+                                             size / SM_CONFIG_FLASH_BLOCK_SIZE);
+    if (FSP_SUCCESS != status) {
+        log_error("Flash erase err %d", status);
+        return SM_ERROR;
+    }
+    return SM_OK;
+}
+
+sm_result sm_config_flash_write(uint32_t offset, uint8_t const * data, uint32_t size) {
+    fsp_err_t status = g_flash0.p_api->write(g_flash0.p_ctrl, (uint32_t)(uintptr_t)data, CONFIG_AREA_START + offset,
+                                             size);
+    if (FSP_SUCCESS != status) {
+        log_error("Flash write err %d", status);
+        return SM_ERROR;
+    }
+    return SM_OK;
+}
+#endif
@@ -10,13 +10,16 @@
 #if (BSP_CFG_RTOS) > 0
 #include "sensor_thread.h"
 #endif
-#include "fecs44/rm_fecs44_api.h"
-#include "fecs44/rm_fecs44.h"
+#include "figaro/rm_figaro_api.h"
+#include "figaro/rm_figaro.h"
 
 void fecs44_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel);
 void fecs44_sensor_close(sm_handle handle);
+sm_result fecs44_sensor_probe(uint8_t address);
 sm_sensor_status fecs44_sensor_read(sm_handle handle, int32_t * data);
 uint8_t * fecs44_sensor_get_flag(sm_handle handle);
+void fecs44_sensor_trigger(sm_handle handle);
+void fecs44_sensor_fsm(void);
 sm_result fecs44_sensor_set_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t value);
 sm_result fecs44_sensor_get_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t * value);
 
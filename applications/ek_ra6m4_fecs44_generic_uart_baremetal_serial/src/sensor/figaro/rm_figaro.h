@@ -5,24 +5,24 @@
 */
 
 /*******************************************************************************************************************//**
- * @addtogroup RM_TGS5141
+ * @addtogroup RM_FIGARO
  * @{
  **********************************************************************************************************************/
 
-#ifndef RM_TGS5141_H
-#define RM_TGS5141_H
+#ifndef RM_FIGARO_H
+#define RM_FIGARO_H
 
 /***********************************************************************************************************************
  * Includes
  **********************************************************************************************************************/
-#include "rm_tgs5141_api.h"
+#include "rm_figaro_api.h"
 
 #if defined(__CCRX__) || defined(__ICCRX__) || defined(__RX__)
- #include "r_tgs5141_rx_config.h"
+ #include "r_figaro_rx_config.h"
 #elif defined(__CCRL__) || defined(__ICCRL__) || defined(__RL78__)
- #include "r_tgs5141_rl_config.h"
+ #include "r_figaro_rl_config.h"
 #else
- #include "rm_tgs5141_cfg.h"
+ #include "rm_figaro_cfg.h"
 
 /* Common macro for FSP header files. There is also a corresponding FSP_FOOTER macro at the end of this file. */
 FSP_HEADER
@@ -36,28 +36,33 @@ FSP_HEADER
  * Typedef definitions
  **********************************************************************************************************************/
 
-/** TGS5141 programming mode process block */
-typedef struct st_rm_tgs5141_programmnig_mode_params
+/** Figaro split-phase transfer in progress */
+typedef enum e_rm_figaro_transfer
 {
-    volatile bool               enter;                  ///< Enter flag.
-    volatile bool               blocking;               ///< Blocking flag.
-    volatile bool               communication_finished; ///< Communication flag for blocking.
-    volatile rm_tgs5141_event_t event;                  ///< Callback event
-} rm_tgs5141_programmnig_mode_params_t;
-
-/** TGS5141 Control Block */
-typedef struct rm_tgs5141_instance_ctrl
+    RM_FIGARO_TRANSFER_NONE = 0,
+    RM_FIGARO_TRANSFER_REQUEST,        ///< Data request command being sent
+    RM_FIGARO_TRANSFER_READ,           ///< Data frame being read
+    RM_FIGARO_TRANSFER_READ_FIXED,     ///< Data frame being read, decoded in fixed point
+} rm_figaro_transfer_t;
+
+/** Figaro Control Block, each module on the bus has its own so transfers never share completion state */
+typedef struct rm_figaro_instance_ctrl
 {
     uint32_t                             open;                 ///< Open flag
-    rm_tgs5141_cfg_t const             * p_cfg;                ///< Pointer to TGS5141 Configuration
+    rm_figaro_cfg_t const              * p_cfg;                ///< Pointer to Figaro Configuration
+    rm_figaro_descriptor_t const       * p_descriptor;         ///< Protocol of the module
     rm_comms_instance_t const          * p_comms_i2c_instance; ///< Pointer of I2C Communications Middleware instance structure
     void const                         * p_context;            ///< Pointer to the user-provided context
-    rm_tgs5141_programmnig_mode_params_t programming_mode;     ///< Programming mode flag
-    uint8_t buf[3];                                            ///< Buffer for I2C communications
+    uint8_t buf[RM_FIGARO_MAX_RESPONSE_SIZE];                  ///< Buffer for I2C communications
+    volatile rm_figaro_transfer_t        transfer;             ///< Split-phase transfer in progress
+    volatile bool                        completed;            ///< Blocking read, the transfer is complete
+    volatile bool                        nack;                 ///< Blocking read, the transfer failed
+    rm_figaro_data_t                   * p_data;               ///< Where the frame being read is decoded
+    rm_figaro_fixed_data_t             * p_fixed_data;         ///< Where the frame being read is decoded (readFixed)
 
     /* Pointer to callback and optional working memory */
-    void (* p_callback)(rm_tgs5141_callback_args_t * p_args);
-} rm_tgs5141_instance_ctrl_t;
+    void (* p_callback)(rm_figaro_callback_args_t * p_args);
+} rm_figaro_instance_ctrl_t;
 
 /**********************************************************************************************************************
  * Exported global variables
@@ -65,16 +70,28 @@ typedef struct rm_tgs5141_instance_ctrl
 
 /** @cond INC_HEADER_DEFS_SEC */
 /** Filled in Interface API structure for this Instance. */
-extern rm_tgs5141_api_t const g_tgs5141_on_tgs5141;
+extern rm_figaro_api_t const g_figaro_on_figaro;
+
+/** Protocol descriptors of the supported modules. */
+extern rm_figaro_descriptor_t const g_figaro_tgs6810_descriptor;
+extern rm_figaro_descriptor_t const g_figaro_tgs5141_descriptor;
+extern rm_figaro_descriptor_t const g_figaro_fecs43_descriptor;
+extern rm_figaro_descriptor_t const g_figaro_fecs44_descriptor;
+extern rm_figaro_descriptor_t const g_figaro_fecs50_descriptor;
 
 /** @endcond */
 
 /**********************************************************************************************************************
  * Public Function Prototypes
  **********************************************************************************************************************/
-fsp_err_t RM_TGS5141_Open(rm_tgs5141_ctrl_t * const p_api_ctrl, rm_tgs5141_cfg_t const * const p_cfg);
-fsp_err_t RM_TGS5141_Close(rm_tgs5141_ctrl_t * const p_api_ctrl);
-fsp_err_t RM_TGS5141_Read(rm_tgs5141_ctrl_t * const p_api_ctrl, rm_tgs5141_data_t * const p_raw_data);
+fsp_err_t RM_FIGARO_Open(rm_figaro_ctrl_t * const p_api_ctrl, rm_figaro_cfg_t const * const p_cfg);
+fsp_err_t RM_FIGARO_Close(rm_figaro_ctrl_t * const p_api_ctrl);
+fsp_err_t RM_FIGARO_RequestData(rm_figaro_ctrl_t * const p_api_ctrl);
+fsp_err_t RM_FIGARO_Read(rm_figaro_ctrl_t * const p_api_ctrl, rm_figaro_data_t * const p_data);
+fsp_err_t RM_FIGARO_ReadFixed(rm_figaro_ctrl_t * const p_api_ctrl, rm_figaro_fixed_data_t * const p_data);
+
+/* I2C Communications Middleware callback, p_context of the comms device is the Figaro control block */
+void rm_figaro_comms_callback(rm_comms_callback_args_t * p_args);
 
 #if defined(__CCRX__) || defined(__ICCRX__) || defined(__RX__)
 #elif defined(__CCRL__) || defined(__ICCRL__) || defined(__RL78__)
@@ -84,8 +101,8 @@ fsp_err_t RM_TGS5141_Read(rm_tgs5141_ctrl_t * const p_api_ctrl, rm_tgs5141_data_
 FSP_FOOTER
 #endif
 
-#endif                                 /* RM_TGS5141_H_*/
+#endif                                 /* RM_FIGARO_H_*/
 
 /*******************************************************************************************************************//**
- * @} (end addtogroup RM_TGS5141)
+ * @} (end addtogroup RM_FIGARO)
  **********************************************************************************************************************/
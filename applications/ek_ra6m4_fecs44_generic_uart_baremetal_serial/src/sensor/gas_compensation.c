@@ -0,0 +1,128 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+#include <string.h>
+#include "hal_data.h"
+#include "gas_compensation.h"
+
+// Position between two nodes in Q14, so both weights of a node pair fit in 16 bits
+#define GAS_COMPENSATION_WEIGHT_BITS (14)
+// The product of the span and humidity gains is in Q26
+#define GAS_COMPENSATION_GAIN_BITS  (26)
+
+// Approximations of the typical curves of the datasheets: the gain is the reciprocal of the sensitivity relative to
+// 20 C (or 50 %RH), the offset is the reading in clean air. Replace them by the characterization of the modules used
+static int16_t const tgs5141_offset[] = { 0, 0, 0, 0, 0, 50, 150, 350 };
+static int16_t const tgs5141_span[] =
+{
+    GAS_COMPENSATION_GAIN(1 / 0.60), GAS_COMPENSATION_GAIN(1 / 0.72), GAS_COMPENSATION_GAIN(1 / 0.83),
+    GAS_COMPENSATION_GAIN(1 / 0.92), GAS_COMPENSATION_GAIN(1 / 1.00), GAS_COMPENSATION_GAIN(1 / 1.05),
+    GAS_COMPENSATION_GAIN(1 / 1.08), GAS_COMPENSATION_GAIN(1 / 1.09),
+};
+static int16_t const tgs5141_humidity[] =
+{
+    GAS_COMPENSATION_GAIN(1 / 0.97), GAS_COMPENSATION_GAIN(1 / 0.99), GAS_COMPENSATION_GAIN(1 / 1.00),
+    GAS_COMPENSATION_GAIN(1 / 1.01), GAS_COMPENSATION_GAIN(1 / 1.02),
+};
+
+static int16_t const fecs43_offset[] = { -20, -10, -5, 0, 0, 10, 30, 60 };
+static int16_t const fecs43_span[] =
+{
+    GAS_COMPENSATION_GAIN(1 / 0.55), GAS_COMPENSATION_GAIN(1 / 0.68), GAS_COMPENSATION_GAIN(1 / 0.80),
+    GAS_COMPENSATION_GAIN(1 / 0.91), GAS_COMPENSATION_GAIN(1 / 1.00), GAS_COMPENSATION_GAIN(1 / 1.06),
+    GAS_COMPENSATION_GAIN(1 / 1.10), GAS_COMPENSATION_GAIN(1 / 1.12),
+};
+static int16_t const fecs43_humidity[] =
+{
+    GAS_COMPENSATION_GAIN(1 / 0.96), GAS_COMPENSATION_GAIN(1 / 0.98), GAS_COMPENSATION_GAIN(1 / 1.00),
+    GAS_COMPENSATION_GAIN(1 / 1.02), GAS_COMPENSATION_GAIN(1 / 1.03),
+};
+
+static int16_t const fecs44_offset[] = { -100, -50, -20, 0, 0, 50, 150, 300 };
+static int16_t const fecs44_span[] =
+{
+    GAS_COMPENSATION_GAIN(1 / 0.45), GAS_COMPENSATION_GAIN(1 / 0.58), GAS_COMPENSATION_GAIN(1 / 0.72),
+    GAS_COMPENSATION_GAIN(1 / 0.87), GAS_COMPENSATION_GAIN(1 / 1.00), GAS_COMPENSATION_GAIN(1 / 1.10),
+    GAS_COMPENSATION_GAIN(1 / 1.18), GAS_COMPENSATION_GAIN(1 / 1.24),
+};
+static int16_t const fecs44_humidity[] =
+{
+    GAS_COMPENSATION_GAIN(1 / 0.91), GAS_COMPENSATION_GAIN(1 / 0.96), GAS_COMPENSATION_GAIN(1 / 1.00),
+    GAS_COMPENSATION_GAIN(1 / 1.03), GAS_COMPENSATION_GAIN(1 / 1.05),
+};
+
+static int16_t const fecs50_offset[] = { 0, 0, 0, 0, 0, 5, 15, 30 };
+static int16_t const fecs50_span[] =
+{
+    GAS_COMPENSATION_GAIN(1 / 0.70), GAS_COMPENSATION_GAIN(1 / 0.80), GAS_COMPENSATION_GAIN(1 / 0.88),
+    GAS_COMPENSATION_GAIN(1 / 0.95), GAS_COMPENSATION_GAIN(1 / 1.00), GAS_COMPENSATION_GAIN(1 / 1.03),
+    GAS_COMPENSATION_GAIN(1 / 1.05), GAS_COMPENSATION_GAIN(1 / 1.06),
+};
+static int16_t const fecs50_humidity[] =
+{
+    GAS_COMPENSATION_GAIN(1 / 0.98), GAS_COMPENSATION_GAIN(1 / 0.99), GAS_COMPENSATION_GAIN(1 / 1.00),
+    GAS_COMPENSATION_GAIN(1 / 1.01), GAS_COMPENSATION_GAIN(1 / 1.01),
+};
+
+// Temperature nodes every 10 C from -20 C to 50 C (operating range), humidity nodes every 25 %RH
+gas_compensation_table const g_gas_compensation_tgs5141 =
+{
+    .offset   = GAS_COMPENSATION_CURVE(-2000, 1000, tgs5141_offset),
+    .span     = GAS_COMPENSATION_CURVE(-2000, 1000, tgs5141_span),
+    .humidity = GAS_COMPENSATION_CURVE(0, 2500, tgs5141_humidity),
+};
+gas_compensation_table const g_gas_compensation_fecs43 =
+{
+    .offset   = GAS_COMPENSATION_CURVE(-2000, 1000, fecs43_offset),
+    .span     = GAS_COMPENSATION_CURVE(-2000, 1000, fecs43_span),
+    .humidity = GAS_COMPENSATION_CURVE(0, 2500, fecs43_humidity),
+};
+gas_compensation_table const g_gas_compensation_fecs44 =
+{
+    .offset   = GAS_COMPENSATION_CURVE(-2000, 1000, fecs44_offset),
+    .span     = GAS_COMPENSATION_CURVE(-2000, 1000, fecs44_span),
+    .humidity = GAS_COMPENSATION_CURVE(0, 2500, fecs44_humidity),
+};
+gas_compensation_table const g_gas_compensation_fecs50 =
+{
+    .offset   = GAS_COMPENSATION_CURVE(-2000, 1000, fecs50_offset),
+    .span     = GAS_COMPENSATION_CURVE(-2000, 1000, fecs50_span),
+    .humidity = GAS_COMPENSATION_CURVE(0, 2500, fecs50_humidity),
+};
+
+// Value of a curve, rounded to the unit of its nodes
+static int32_t gas_compensation_curve_value(gas_compensation_curve const * p_curve, int32_t x) {
+    uint32_t last = p_curve->nodes - 1U;
+    if (x <= p_curve->first) return p_curve->p_values[0];
+    uint32_t d = (uint32_t) (x - p_curve->first);
+    uint32_t node = d / p_curve->step;
+    if (node >= last) return p_curve->p_values[last];
+    // Weight of the next node in Q14, the remainder is below step so the product fits in 32 bits
+    uint32_t w = ((d - node * p_curve->step) * p_curve->recip) >> (24 - GAS_COMPENSATION_WEIGHT_BITS);
+    int16_t const * p_node = &p_curve->p_values[node];
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    // The node pair in one word (little endian, unaligned access allowed), both products and the rounding in one SMLAD
+    uint32_t pair;
+    memcpy(&pair, p_node, sizeof(pair));
+    int32_t sum = (int32_t) __SMLAD(pair, (w << 16) | ((1U << GAS_COMPENSATION_WEIGHT_BITS) - w),
+                                    1U << (GAS_COMPENSATION_WEIGHT_BITS - 1));
+#else
+    int32_t sum = (int32_t) p_node[0] * (int32_t) ((1U << GAS_COMPENSATION_WEIGHT_BITS) - w) +
+                  (int32_t) p_node[1] * (int32_t) w + (1 << (GAS_COMPENSATION_WEIGHT_BITS - 1));
+#endif
+    return sum >> GAS_COMPENSATION_WEIGHT_BITS;
+}
+
+int32_t gas_compensate(gas_compensation_table const * p_table, int32_t gas, int32_t temperature, int32_t humidity) {
+    int32_t offset = gas_compensation_curve_value(&p_table->offset, temperature);
+    // Both gains below 4.0 in Q13, their product below 16.0 in Q26
+    int32_t gain = gas_compensation_curve_value(&p_table->span, temperature) *
+                   gas_compensation_curve_value(&p_table->humidity, humidity);
+    int64_t value = ((int64_t) gas - offset) * gain + (1LL << (GAS_COMPENSATION_GAIN_BITS - 1));
+    value >>= GAS_COMPENSATION_GAIN_BITS;
+    if (value > INT32_MAX) return INT32_MAX;
+    if (value < INT32_MIN) return INT32_MIN;
+    return (int32_t) value;
+}
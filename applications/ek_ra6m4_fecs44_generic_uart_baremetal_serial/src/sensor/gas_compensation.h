@@ -0,0 +1,52 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+#ifndef GAS_COMPENSATION_H_
+#define GAS_COMPENSATION_H_
+#include <stdint.h>
+
+// Gains are in Q13: 8192 is 1.0, up to 3.9998
+#define GAS_COMPENSATION_GAIN_ONE   (8192)
+#define GAS_COMPENSATION_GAIN(x)    ((int16_t) ((x) * GAS_COMPENSATION_GAIN_ONE + 0.5))
+// Reciprocal of the node spacing of a curve, scaled by 2^24 (the position between two nodes is in Q14)
+#define GAS_COMPENSATION_RECIP(step) ((uint32_t) (((1UL << 24) + ((step) / 2)) / (step)))
+// Curve over the nodes of an int16_t array, first and step in hundredths (step from 1 to 5000)
+#define GAS_COMPENSATION_CURVE(first, step, values) \
+    { (first), (step), GAS_COMPENSATION_RECIP(step), (uint8_t) (sizeof(values) / sizeof((values)[0])), (values) }
+
+// Piecewise-linear curve over 2 to 255 nodes evenly spaced, flat outside the nodes
+typedef struct {
+    int32_t first;              // input of the first node, hundredths
+    uint32_t step;              // spacing of the nodes, hundredths
+    uint32_t recip;             // GAS_COMPENSATION_RECIP(step)
+    uint8_t nodes;
+    int16_t const * p_values;
+} gas_compensation_curve;
+
+// Compensation of an electrochemical gas module: gas = (reading - offset(T)) * span(T) * humidity(RH)
+typedef struct {
+    gas_compensation_curve offset;      // zero offset over temperature, hundredths of ppm
+    gas_compensation_curve span;        // gain over temperature, Q13, 1.0 at the calibration temperature
+    gas_compensation_curve humidity;    // gain over relative humidity, Q13, 1.0 at the calibration humidity
+} gas_compensation_table;
+
+// Typical curves of the modules, calibrated at 20 C and 50 %RH
+extern gas_compensation_table const g_gas_compensation_tgs5141;    // CO
+extern gas_compensation_table const g_gas_compensation_fecs43;     // SO2
+extern gas_compensation_table const g_gas_compensation_fecs44;     // NH3
+extern gas_compensation_table const g_gas_compensation_fecs50;     // H2S
+
+/*******************************************************************************************************************//**
+ * @brief       Compensate a gas reading for temperature and humidity, in fixed point only. With the DSP extension
+ *              (Cortex-M33), the two nodes of each curve are interpolated by one dual multiply-accumulate
+ * @param[in]   compensation table of the module (ie.: g_gas_compensation_fecs43)
+ * @param[in]   gas reading, hundredths of ppm
+ * @param[in]   temperature, hundredths of C
+ * @param[in]   relative humidity, hundredths of %RH
+ * @retval      compensated gas, hundredths of ppm, saturated to the int32_t range
+ ***********************************************************************************************************************/
+int32_t gas_compensate(gas_compensation_table const * p_table, int32_t gas, int32_t temperature, int32_t humidity);
+
+#endif
@@ -12,18 +12,51 @@
 
 void publish_sensor(sm_handle handle, uint8_t * buffer, uint16_t size);
 
+// Samples lost between Sensor Manager and this application show up as gaps in the sequence numbers
+static sm_sequence_tracker sequence_trackers[NUM_SENSORS];
+
+static int32_t scale_sensor_data(int32_t data, sm_scaling * scaling) {
+    data += scaling->offset;
+    return (data * scaling->multiplier * 100) / scaling->divider;
+}
+
+static void check_sequence(sm_handle handle, uint32_t sequence) {
+    int16_t index = sm_get_sensor_index(handle);
+    if (0 > index) return;
+    uint32_t missing = sm_sequence_check(&sequence_trackers[index], sequence);
+    if (0 < missing) {
+        printf("Lost %lu samples of /%s/%s, %lu since start\r\n", missing, sm_get_sensor_path_by_handle(handle),
+               sm_get_sensor_id(handle), sequence_trackers[index].lost);
+    }
+}
+
 void publish_sensor(sm_handle handle, uint8_t * buffer, uint16_t size) {
+    sm_scaling scaling = {.divider=1, .multiplier=1,.offset=0};
+    uint32_t sequence = sm_get_sample_sequence(handle);
+    sm_get_sensor_scaling(handle, &scaling);
+    check_sequence(handle, sequence);
     if (sizeof(int32_t) == size) {
-        sm_scaling scaling = {.divider=1, .multiplier=1,.offset=0};
-        sm_get_sensor_scaling(handle, &scaling);
-        int32_t data = *(int32_t *)buffer;
-        data += scaling.offset;
-        data = (data * scaling.multiplier * 100) / scaling.divider;
+        int32_t data = scale_sensor_data(*(int32_t *)buffer, &scaling);
         printf("Publishing: /%s/%s: ", sm_get_sensor_path_by_handle(handle),sm_get_sensor_id(handle));
         // First print the integer part followed by the decimal separator .
         utils_print_fractional(data, TWO_DECIMALS);
-        // print the unit
-        printf("%s\r\n",sm_get_sensor_unit_by_handle(handle));
+        // print the unit and the sample number
+        printf("%s seq %lu\r\n",sm_get_sensor_unit_by_handle(handle), sequence);
+#if SM_CFG_AGGREGATION_ENABLE
+    } else if (sizeof(sm_aggregate) == size) {
+        // Windowed sensor, print the statistics of the window
+        sm_aggregate * aggregate = (sm_aggregate *)buffer;
+        const char * unit = sm_get_sensor_unit_by_handle(handle);
+        printf("Publishing: /%s/%s: mean ", sm_get_sensor_path_by_handle(handle),sm_get_sensor_id(handle));
+        utils_print_fractional(scale_sensor_data(aggregate->mean, &scaling), TWO_DECIMALS);
+        printf("%s min ", unit);
+        utils_print_fractional(scale_sensor_data(aggregate->min, &scaling), TWO_DECIMALS);
+        printf("%s max ", unit);
+        utils_print_fractional(scale_sensor_data(aggregate->max, &scaling), TWO_DECIMALS);
+        printf("%s stddev ", unit);
+        utils_print_fractional((aggregate->stddev * scaling.multiplier * 100) / scaling.divider, TWO_DECIMALS);
+        printf("%s count %lu seq %lu\r\n", unit, aggregate->count, sequence);
+#endif
     }
 }
 
@@ -1,6 +1,18 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
 #include <stdint.h>
 #include "common_utils.h"
 #include "sm.h"
+#include "sm_subscriber.h"
+#if SM_CFG_CONFIG_ENABLE
+#include "sm_config.h"
+#endif
+#if SM_CFG_AGGREGATION_ENABLE
+#include <math.h>
+#endif
 // Uncomment the desired debug level
 #include "log_disabled.h"
 //#include "log_error.h"
@@ -8,23 +20,53 @@
 //#include "log_info.h"
 //#include "log_debug.h"
 
-
 #if (BSP_CFG_RTOS) == 1
 #include "tx_api.h"
 #define QUEUE_TYPE TX_QUEUE
+#if SM_CFG_EVENT_DRIVEN
+#define SM_EVENT_WAKE   (1UL)
+static TX_EVENT_FLAGS_GROUP sm_events;
+#endif
 #elif (BSP_CFG_RTOS) == 2
 // On FreeRTOS Sensor Manager uses a queue to pass data to the application
 #include "FreeRTOS.h"
 #include "queue.h"
+#include "task.h"
 #define QUEUE_TYPE QueueHandle_t
+#if SM_CFG_EVENT_DRIVEN
+static TaskHandle_t sm_task_handle = NULL;
+#endif
 static StaticQueue_t sensor_queue_memory;
+#if SM_CFG_AGGREGATION_ENABLE
+static StaticQueue_t sensor_aggregate_queue_memory;
+#endif
 #endif
 
 #if (BSP_CFG_RTOS) != 0
-#define SENSOR_QUEUE_LENGTH     (20U * NUM_SENSORS)
-#define SENSOR_SEND_WAIT_TIME   (10)    // Ticks
 QUEUE_TYPE g_sensor_queue;
-static uint8_t sensor_queue_storage[SENSOR_QUEUE_LENGTH * sizeof(sm_sensor_data)];
+static uint8_t sensor_queue_storage[SM_CFG_QUEUE_LENGTH * sizeof(sm_sensor_data)];
+#if SM_CFG_AGGREGATION_ENABLE
+// Windowed instances publish their statistics (sm_aggregate_data) on a separate queue
+QUEUE_TYPE g_sensor_aggregate_queue;
+static uint8_t sensor_aggregate_queue_storage[SM_CFG_AGGREGATE_QUEUE_LENGTH * sizeof(sm_aggregate_data)];
+#endif
+
+typedef union {
+    sm_sensor_data data;
+    sm_aggregate_data aggregate;
+} queue_item;
+
+static sm_queue_stats queue_stats;
+#if SM_QUEUE_COALESCE == SM_CFG_QUEUE_OVERFLOW
+// Freshest sample of each instance waiting for room in its queue
+typedef struct {
+    QUEUE_TYPE * queue;     // NULL if nothing is waiting
+    queue_item item;
+} queue_backlog;
+
+static queue_backlog backlog[NUM_SENSORS];
+static uint16_t backlog_next;       // round-robin position, the backlog is drained fairly between instances
+#endif
 #endif
 
 static uint8_t always_zero = 0;
@@ -45,6 +87,16 @@ static uint8_t always_zero = 0;
 #define DEFINE_SENSOR_DRIVER(DRIVER) uint8_t * BSP_WEAK_REFERENCE DRIVER##_get_flag(sm_handle handle)\
 	{FSP_PARAMETER_NOT_USED(handle);return &always_zero;}
 #include "sm_define_sensors.inc"
+#define DEFINE_SENSOR_DRIVER(DRIVER) sm_result BSP_WEAK_REFERENCE DRIVER##_probe(uint8_t address);
+#include "sm_define_sensors.inc"
+#define DEFINE_SENSOR_DRIVER(DRIVER) sm_result BSP_WEAK_REFERENCE DRIVER##_probe(uint8_t address)\
+	{FSP_PARAMETER_NOT_USED(address);return SM_NOT_SUPPORTED;}
+#include "sm_define_sensors.inc"
+#define DEFINE_SENSOR_DRIVER(DRIVER) void BSP_WEAK_REFERENCE DRIVER##_trigger(sm_handle handle);
+#include "sm_define_sensors.inc"
+#define DEFINE_SENSOR_DRIVER(DRIVER) void BSP_WEAK_REFERENCE DRIVER##_trigger(sm_handle handle)\
+	{FSP_PARAMETER_NOT_USED(handle);}
+#include "sm_define_sensors.inc"
 #define DEFINE_SENSOR_DRIVER(DRIVER) void BSP_WEAK_REFERENCE DRIVER##_reset(void);
 #include "sm_define_sensors.inc"
 #define DEFINE_SENSOR_DRIVER(DRIVER) void BSP_WEAK_REFERENCE DRIVER##_reset(void) {}
@@ -81,6 +133,8 @@ typedef struct {
   void (*fsm)(void);
   uint8_t *(*get_flag)(sm_handle handle);
   void (*reset)(void);
+  sm_result (*probe)(uint8_t address);
+  void (*trigger)(sm_handle handle);
   sm_result (*set_attr)(sm_handle handle, sm_sensor_attributes attr, uint32_t value);
   sm_result (*get_attr)(sm_handle handle, sm_sensor_attributes attr, uint32_t * value);
 } sm_interface;
@@ -90,6 +144,7 @@ typedef struct {
 		.open=&DRIVER##_open,.close=&DRIVER##_close,\
 		.read=&DRIVER##_read,.fsm=&DRIVER##_fsm,\
 		.get_flag=&DRIVER##_get_flag, .reset=&DRIVER##_reset,\
+		.probe=&DRIVER##_probe, .trigger=&DRIVER##_trigger,\
 		.set_attr=&DRIVER##_set_attr, .get_attr=&DRIVER##_get_attr};
 #include "sm_define_sensors.inc"
 
@@ -101,13 +156,94 @@ static const sm_interface *driver[]={
 
 #define NUM_DRIVERS (sizeof(driver)/sizeof(driver[0]))
 
+// I2C multiplexers, index 0 (SM_MUX_NONE) is not used
+#define DEFINE_SENSOR_MUX(MUX, BUS) sm_result MUX##_select(uint8_t port);
+#include "sm_define_sensors.inc"
+
+#define NUM_MUXES   (SM_MUX_LAST - 1)
+#define MUX_PORT_UNKNOWN    (0xFEU)     // after a failed selection, any port may be enabled
+
+static sm_result (* const mux_select[NUM_MUXES + 1])(uint8_t port) = {
+    NULL,
+    #define DEFINE_SENSOR_MUX(MUX, BUS) &MUX##_select,
+    #include "sm_define_sensors.inc"
+};
+
+static const uint8_t mux_bus[NUM_MUXES + 1] = {
+    0,
+    #define DEFINE_SENSOR_MUX(MUX, BUS) (BUS),
+    #include "sm_define_sensors.inc"
+};
+
+static uint8_t mux_port[NUM_MUXES + 1];     // port currently enabled on each mux
+static uint32_t mux_switches;
+
+#if SM_CFG_GROUP_ENABLE
+#define NUM_GROUPS  (SM_GROUP_LAST - 1)
+
+// Acquisition groups, index 0 (SM_GROUP_NONE) is not used
+typedef struct {
+    uint32_t interval;
+    uint32_t timeout;
+} group_const_property;
+
+static const group_const_property group_const_properties[NUM_GROUPS + 1] = {
+    {0, 0},
+    #define DEFINE_SENSOR_GROUP(GROUP, INTERVAL_MS, TIMEOUT_MS) {.interval=(INTERVAL_MS), .timeout=(TIMEOUT_MS)},
+    #include "sm_define_sensors.inc"
+};
+
+typedef struct {
+    bool acquiring;             // members triggered, the set is not released yet
+    bool started;
+    uint32_t trigger_time;
+    uint32_t trigger_cycles;
+    sm_group_callback callback;
+    uint32_t sets;
+    uint32_t timeouts;
+    uint32_t last_skew;         // in DWT cycles
+    uint32_t max_skew;
+} group_property;
+
+static group_property group_properties[NUM_GROUPS + 1];
+#endif
+
+#define SM_USE_CYCLE_COUNTER (SM_CFG_DEFERRED_DISPATCH || SM_CFG_FSM_TIMING_ENABLE || SM_CFG_GROUP_ENABLE)
+
+// sm_run() starts from a different instance and driver on each call, so no sensor is favoured by its declaration order
+static uint16_t run_start;
+// Instances sorted by mux port, the instances of a port are serviced together to limit mux switching
+static uint16_t run_order[NUM_SENSORS];
+static uint16_t fsm_start;
+#if SM_CFG_FSM_TIMING_ENABLE
+typedef struct {
+    uint32_t calls;
+    uint32_t last;          // in DWT cycles
+    uint32_t max;
+    uint64_t total;
+} driver_fsm_timing;
+
+static driver_fsm_timing fsm_timing[NUM_DRIVERS];
+#endif
+#if SM_USE_CYCLE_COUNTER
+static uint32_t cycles_per_us;
+#endif
+#if SM_CFG_EVENT_DRIVEN && ((BSP_CFG_RTOS) != 0)
+#define SM_NO_DEADLINE  UINT32_MAX
+static uint32_t next_deadline;      // milliseconds until SM needs to run again
+#endif
+
 typedef enum {
     SM_CLOSE,
+    SM_INIT,        // driver not open yet, sensors are opened by sm_run() so sm_init() does not wait for them
     SM_OPEN,
     SM_SW_TRIGGER,
     SM_TRIGGERED,
     SM_SAMPLING,
-    SM_WAITING
+    SM_WAITING,
+    SM_RECOVERING,
+    SM_GROUPED,         // group member, waiting for the group trigger
+    SM_GROUP_TRIGGERED  // group member, triggered and not read yet
 } sensor_state;
 
 typedef struct {
@@ -119,6 +255,26 @@ typedef struct {
     int32_t data;
     sm_callback callback;
     uint8_t * flag;
+    uint8_t address;    // address in use, set by discovery for SM_PROBE instances
+    bool open;
+    uint32_t sequence;      // sequence number of the last published sample, the first sample is 1
+    uint32_t dispatched;    // sequence number of the sample passed to the callbacks
+#if SM_CFG_CONFIG_ENABLE
+    uint32_t config_flags;  // SM_CONFIG_xxx, attributes set by the application
+    uint32_t sample_interval;
+#endif
+#if SM_CFG_GROUP_ENABLE
+    bool group_sampled;     // valid sample held until the group is released
+    uint32_t group_cycles;  // time of the read
+#endif
+#if SM_CFG_RECOVERY_ENABLE
+    uint16_t consecutive_errors;
+    uint32_t recovery_start;
+    uint32_t recovery_delay;
+    uint32_t backoff;
+    uint32_t errors;
+    uint32_t recoveries;
+#endif
 } instance_property;
 
 typedef struct {
@@ -129,17 +285,29 @@ typedef struct {
     int32_t multipler;
     int32_t divider;
     int32_t offset;
+#if SM_CFG_AGGREGATION_ENABLE
+    uint32_t window_ms;
+    uint32_t slide_ms;
+#endif
+#if SM_CFG_DISCOVERY_ENABLE
+    uint8_t probe_first;
+    uint8_t probe_last;     // 0 if the address is fixed
+#endif
+    uint8_t mux;            // SM_MUX_NONE if the sensor is directly on the bus
+    uint8_t port;
+    bool driver_paced;      // interval 0, read when the driver flags new data
+#if SM_CFG_GROUP_ENABLE
+    uint8_t group;          // SM_GROUP_NONE if the sensor is sampled on its own
+#endif
 } instance_const_property;
 
-static uint16_t handle_indexer;
-
 static instance_property sensor_properties[NUM_SENSORS] = {
-    #define DEFINE_SENSOR_INSTANCE(TYPE, ADDR, CHAN, DRV, MULT, DIV, OFFS, INTERVAL_MS) {.state=SM_OPEN, .interval=INTERVAL_MS, .handle.value=0, .status = SM_SENSOR_ERROR, .callback=NULL, .flag=NULL},
+    #define DEFINE_SENSOR_INSTANCE(TYPE, ADDR, CHAN, DRV, MULT, DIV, OFFS, INTERVAL_MS, ...) {.state=SM_INIT, .interval=INTERVAL_MS, .handle.value=0, .status = SM_SENSOR_ERROR, .callback=NULL, .flag=NULL},
     #include "sm_define_sensors.inc"
 };
 
 static const instance_const_property sensor_const_properties[NUM_SENSORS] = {
-    #define DEFINE_SENSOR_INSTANCE(TYPE, ADDR, CHAN, DRV, MULT, DIV, OFFS, INTERVAL_MS) {.type=TYPE, .driver=DRIVER_##DRV, .address=ADDR, .channel=CHAN, .multipler=MULT, .divider=DIV, .offset = OFFS},
+    #define DEFINE_SENSOR_INSTANCE(TYPE, ADDR, CHAN, DRV, MULT, DIV, OFFS, INTERVAL_MS, ...) {.type=TYPE, .driver=DRIVER_##DRV, .address=ADDR, .channel=CHAN, .multipler=MULT, .divider=DIV, .offset = OFFS, .driver_paced=(0 == (INTERVAL_MS)), __VA_ARGS__},
     #include "sm_define_sensors.inc"
 };
 
@@ -164,6 +332,500 @@ static const char *driver_id[] = {
     #undef TOSTR
 };
 
+#define FNV_OFFSET      (2166136261U)
+#define FNV_PRIME       (16777619U)
+
+#if SM_CFG_PATH_INDEX_ENABLE
+// Hash table from "<type path>/<driver id>" to instance, built by sm_init() (open addressing, linear probing)
+#define PATH_INDEX_SIZE (2U * NUM_SENSORS)
+static uint16_t path_index[PATH_INDEX_SIZE];    // instance number + 1, 0 if the slot is free
+static uint32_t path_hash[NUM_SENSORS];
+#endif
+
+#if SM_CFG_AGGREGATION_ENABLE
+// Running statistics of a pane, a window is made of one pane (tumbling) or several panes (sliding)
+typedef struct {
+    uint32_t count;
+    float mean;
+    float m2;       // sum of squared differences from the mean (Welford)
+    int32_t min;
+    int32_t max;
+    int32_t last;
+} window_pane;
+
+typedef struct {
+    uint32_t pane_start;    // time when the current pane started
+    uint32_t pane_length;   // pane length in milliseconds
+    uint8_t num_panes;      // number of panes in the window, 0 if the instance is not windowed
+    uint8_t current;        // pane receiving new samples
+    window_pane pane[SM_CFG_AGGREGATION_MAX_PANES];
+} instance_window;
+
+static instance_window sensor_windows[NUM_SENSORS];
+#endif
+
+#if SM_CFG_DEFERRED_DISPATCH
+// Latest sample of each instance waiting for its callbacks, a newer sample replaces a pending one
+typedef struct {
+    uint16_t size;
+    uint32_t sequence;
+    union {
+        int32_t data;
+        sm_aggregate aggregate;
+    };
+} pending_sample;
+
+static pending_sample pending_samples[NUM_SENSORS];
+static uint8_t pending[NUM_SENSORS];
+static uint16_t num_pending;
+static uint16_t dispatch_next;      // round-robin position, dispatch resumes here on the next sm_run()
+static uint32_t dispatch_drops;
+static uint32_t dispatch_budget;    // in DWT cycles
+#endif
+
+// Instance i is sampled by SM at its interval, otherwise on the flag of its driver or on a trigger
+static bool sm_is_timed(int i) {
+    return !sensor_const_properties[i].driver_paced && (0 < sensor_properties[i].interval);
+}
+
+// Route the bus to the mux port of instance i before any driver call that can use the bus
+static void sm_select_port(int i) {
+    uint8_t mux = sensor_const_properties[i].mux;
+    uint8_t port = sensor_const_properties[i].port;
+    if ((SM_MUX_NONE == mux) || (NUM_MUXES < mux) || (port == mux_port[mux])) return;
+    // Devices behind different muxes of a bus can use the same address, only one port of a bus can be enabled
+    for (uint8_t m = 1; NUM_MUXES >= m; m++) {
+        if ((m == mux) || (mux_bus[m] != mux_bus[mux]) || (SM_MUX_PORT_NONE == mux_port[m])) continue;
+        mux_port[m] = (SM_OK == mux_select[m](SM_MUX_PORT_NONE)) ? SM_MUX_PORT_NONE : MUX_PORT_UNKNOWN;
+        mux_switches++;
+    }
+    mux_port[mux] = (SM_OK == mux_select[mux](port)) ? port : MUX_PORT_UNKNOWN;
+    mux_switches++;
+}
+
+// Sort the instances by mux and port, sm_run() services them in this order
+static void sm_sort_by_port(void) {
+    for (uint16_t n = 0; NUM_SENSORS > n; n++) {
+        uint16_t i = n;
+        uint16_t key = (uint16_t)((sensor_const_properties[n].mux << 8) | sensor_const_properties[n].port);
+        // Insertion sort, it keeps the declaration order of the instances of a port
+        while (0 < i) {
+            uint16_t j = run_order[i - 1];
+            if (key >= (uint16_t)((sensor_const_properties[j].mux << 8) | sensor_const_properties[j].port)) break;
+            run_order[i] = j;
+            i--;
+        }
+        run_order[i] = n;
+    }
+}
+
+// Call the consumers of a sample (sm_callback on baremetal and subscribers)
+static void sm_dispatch(int i, uint8_t * buffer, uint16_t size, uint32_t sequence) {
+    // Callbacks get the sequence number with sm_get_sample_sequence()
+    sensor_properties[i].dispatched = sequence;
+#if (BSP_CFG_RTOS) == 0
+    // On baremetal, if we have a callback registered for this sensor, it is time to call it!
+    if (NULL != sensor_properties[i].callback) {
+        sensor_properties[i].callback(sensor_properties[i].handle, buffer, size);
+    }
+#endif
+    // Fan the sample out to all subscribers
+    sm_subscriber_publish(sensor_const_properties[i].type, sensor_properties[i].handle, buffer, size, sequence);
+}
+
+static void sm_notify(int i, uint8_t * buffer, uint16_t size) {
+#if SM_CFG_DEFERRED_DISPATCH
+    // Callbacks run at the end of sm_run(), keep the sample until then
+    if (0 != pending[i]) {
+        dispatch_drops++;
+    } else {
+        pending[i] = 1;
+        num_pending++;
+    }
+    pending_samples[i].size = size;
+    pending_samples[i].sequence = sensor_properties[i].sequence;
+    memcpy(&pending_samples[i].data, buffer, size);
+#else
+    sm_dispatch(i, buffer, size, sensor_properties[i].sequence);
+#endif
+}
+
+#if SM_CFG_DEFERRED_DISPATCH
+// Run pending callbacks, round-robin over the instances, until the time budget is used
+static void sm_dispatch_pending(void) {
+    uint32_t start = DWT->CYCCNT;
+    for (uint16_t n = 0; (n < NUM_SENSORS) && (0 < num_pending); n++) {
+        uint16_t i = dispatch_next;
+        dispatch_next = (uint16_t)((dispatch_next + 1) % NUM_SENSORS);
+        if (0 == pending[i]) continue;
+        pending[i] = 0;
+        num_pending--;
+        sm_dispatch(i, (uint8_t *)&pending_samples[i].data, pending_samples[i].size, pending_samples[i].sequence);
+        // At least one callback runs per call, so pending samples always make progress
+        if (DWT->CYCCNT - start >= dispatch_budget) break;
+    }
+}
+#endif
+
+#if SM_CFG_RECOVERY_ENABLE
+// Instances of the same driver and address share a device, they are recovered together
+static bool sm_same_device(int i, int j) {
+    return (sensor_const_properties[i].driver == sensor_const_properties[j].driver) &&
+           (sensor_properties[i].address == sensor_properties[j].address) &&
+           (sensor_const_properties[i].mux == sensor_const_properties[j].mux) &&
+           (sensor_const_properties[i].port == sensor_const_properties[j].port);
+}
+
+// Stop sampling the device of instance i and schedule its recovery, other devices keep sampling
+static void sm_schedule_recovery(int i) {
+    uint32_t delay = sensor_properties[i].backoff;
+    uint32_t next_backoff = (delay < (SM_CFG_RECOVERY_BACKOFF_MAX_MS / 2)) ? (delay * 2) : SM_CFG_RECOVERY_BACKOFF_MAX_MS;
+    log_error("Sensor index %d recovery in %d ms", i, delay);
+    for (int j = 0; NUM_SENSORS > j; j++) {
+        if (!sm_same_device(i, j)) continue;
+        sensor_properties[j].state = SM_RECOVERING;
+        sensor_properties[j].recovery_start = utils_systime_get();
+        sensor_properties[j].recovery_delay = delay;
+        sensor_properties[j].backoff = next_backoff;
+        sensor_properties[j].consecutive_errors = 0;
+    }
+}
+
+static void sm_recover(int i) {
+    sm_interface *this_driver = (sm_interface *)driver[sensor_const_properties[i].driver-1];
+    log_info("Sensor index %d recovering", i);
+    sm_select_port(i);
+    // Close all channels first, drivers only close the device when its last channel is closed
+    for (int j = 0; NUM_SENSORS > j; j++) {
+        if (!sm_same_device(i, j) || !sensor_properties[j].open) continue;
+        this_driver->close(sensor_properties[j].handle);
+        sensor_properties[j].open = false;
+    }
+    this_driver->reset();
+    // The channels are opened again by sm_run()
+    for (int j = 0; NUM_SENSORS > j; j++) {
+        if (!sm_same_device(i, j)) continue;
+        sensor_properties[j].state = SM_INIT;
+        sensor_properties[j].recoveries++;
+    }
+}
+
+static void sm_check_errors(int i) {
+    if (SM_SENSOR_DATA_VALID == sensor_properties[i].status) {
+        sensor_properties[i].consecutive_errors = 0;
+        sensor_properties[i].backoff = SM_CFG_RECOVERY_BACKOFF_MIN_MS;
+    } else if (SM_SENSOR_ERROR == sensor_properties[i].status) {
+        sensor_properties[i].errors++;
+        if (SM_CFG_RECOVERY_ERROR_THRESHOLD <= ++sensor_properties[i].consecutive_errors) {
+            sm_schedule_recovery(i);
+        }
+    }
+}
+#endif
+
+#if (BSP_CFG_RTOS) != 0
+static bool sm_queue_send(QUEUE_TYPE * queue, void * item, uint32_t wait) {
+#if (BSP_CFG_RTOS) == 1
+    return (TX_SUCCESS == tx_queue_send(queue, item, (ULONG) wait));
+#else
+    return (pdPASS == xQueueSend(*queue, item, (TickType_t) wait));
+#endif
+}
+
+#if SM_QUEUE_COALESCE == SM_CFG_QUEUE_OVERFLOW
+// Move waiting samples to their queue while there is room
+static void sm_queue_flush(void) {
+    for (uint16_t n = 0; (NUM_SENSORS > n) && (0 < queue_stats.backlog); n++) {
+        uint16_t i = backlog_next;
+        backlog_next = (uint16_t)((backlog_next + 1) % NUM_SENSORS);
+        if ((NULL == backlog[i].queue) || !sm_queue_send(backlog[i].queue, &backlog[i].item, 0)) continue;
+        backlog[i].queue = NULL;
+        queue_stats.backlog--;
+        queue_stats.sent++;
+    }
+}
+#endif
+
+// Queue a sample (sm_sensor_data or sm_aggregate_data) of instance i, a full queue is handled by SM_CFG_QUEUE_OVERFLOW
+static void sm_queue_sample(int i, QUEUE_TYPE * queue, void * item, uint16_t size) {
+#if SM_QUEUE_COALESCE == SM_CFG_QUEUE_OVERFLOW
+    sm_queue_flush();
+    // A waiting sample of the instance is older, so it must not be overtaken
+    if ((NULL == backlog[i].queue) && sm_queue_send(queue, item, 0)) {
+        queue_stats.sent++;
+        return;
+    }
+    if (NULL != backlog[i].queue) {
+        queue_stats.coalesced++;
+    } else {
+        queue_stats.backlog++;
+    }
+    backlog[i].queue = queue;
+    memcpy(&backlog[i].item, item, size);
+#elif SM_QUEUE_DROP_OLDEST == SM_CFG_QUEUE_OVERFLOW
+    FSP_PARAMETER_NOT_USED(i);
+    FSP_PARAMETER_NOT_USED(size);
+    if (!sm_queue_send(queue, item, 0)) {
+        queue_item oldest;
+        // The consumer may have made room meanwhile, then nothing is dropped
+#if (BSP_CFG_RTOS) == 1
+        if (TX_SUCCESS == tx_queue_receive(queue, &oldest, TX_NO_WAIT)) queue_stats.dropped++;
+#else
+        if (pdPASS == xQueueReceive(*queue, &oldest, 0)) queue_stats.dropped++;
+#endif
+        if (!sm_queue_send(queue, item, 0)) {
+            queue_stats.dropped++;
+            return;
+        }
+    }
+    queue_stats.sent++;
+#else
+    FSP_PARAMETER_NOT_USED(i);
+    FSP_PARAMETER_NOT_USED(size);
+    uint32_t wait = (SM_QUEUE_BLOCK == SM_CFG_QUEUE_OVERFLOW) ? SM_CFG_QUEUE_SEND_WAIT : 0;
+    if (!sm_queue_send(queue, item, wait)) {
+        // Failed to send sensor data
+        log_error("Queue send fail");
+        log_debug("Handle %d",sensor_properties[i].handle.value);
+        queue_stats.dropped++;
+        return;
+    }
+    queue_stats.sent++;
+#endif
+}
+#endif
+
+static void sm_publish(int i) {
+    sensor_properties[i].sequence++;
+#if (BSP_CFG_RTOS) != 0
+    // On RTOS we send the data to the queue
+    sm_sensor_data data;
+    data.handle = sensor_properties[i].handle;
+    data.data = sensor_properties[i].data;
+    data.sequence = sensor_properties[i].sequence;
+    sm_queue_sample(i, &g_sensor_queue, &data, sizeof(data));
+#endif
+    sm_notify(i, (uint8_t *)&sensor_properties[i].data, sizeof(sensor_properties[i].data));
+}
+
+#if SM_CFG_AGGREGATION_ENABLE
+static void sm_publish_aggregate(int i, sm_aggregate * aggregate) {
+    sensor_properties[i].sequence++;
+#if (BSP_CFG_RTOS) != 0
+    sm_aggregate_data data;
+    data.handle = sensor_properties[i].handle;
+    data.sequence = sensor_properties[i].sequence;
+    data.aggregate = *aggregate;
+    sm_queue_sample(i, &g_sensor_aggregate_queue, &data, sizeof(data));
+#endif
+    sm_notify(i, (uint8_t *)aggregate, sizeof(sm_aggregate));
+}
+
+static int32_t sm_round(float value) {
+    return (int32_t)((0 > value) ? (value - 0.5f) : (value + 0.5f));
+}
+
+static void sm_window_init(int i) {
+    instance_window * window = &sensor_windows[i];
+    uint32_t window_ms = sensor_const_properties[i].window_ms;
+    uint32_t slide_ms = sensor_const_properties[i].slide_ms;
+    uint32_t num_panes = 1;
+
+    memset(window, 0, sizeof(instance_window));
+    if (0 == window_ms) return;
+    if ((0 < slide_ms) && (slide_ms < window_ms)) {
+        num_panes = window_ms / slide_ms;
+        if (SM_CFG_AGGREGATION_MAX_PANES < num_panes) {
+            log_error("Sensor index %d window limited to %d slides", i, SM_CFG_AGGREGATION_MAX_PANES);
+            num_panes = SM_CFG_AGGREGATION_MAX_PANES;
+        }
+        window->pane_length = slide_ms;
+    } else {
+        window->pane_length = window_ms;
+    }
+    window->num_panes = (uint8_t)num_panes;
+    window->pane_start = utils_systime_get();
+}
+
+// O(1) update of the current pane with a new sample, raw samples are never stored
+static void sm_window_add(int i, int32_t data) {
+    window_pane * pane = &sensor_windows[i].pane[sensor_windows[i].current];
+    float delta;
+
+    if (0 == pane->count) {
+        pane->min = data;
+        pane->max = data;
+    } else if (data < pane->min) {
+        pane->min = data;
+    } else if (data > pane->max) {
+        pane->max = data;
+    }
+    pane->count++;
+    delta = (float)data - pane->mean;
+    pane->mean += delta / (float)pane->count;
+    pane->m2 += delta * ((float)data - pane->mean);
+    pane->last = data;
+}
+
+// Combine the statistics of two panes (parallel form of Welford's algorithm), pane must be newer than total
+static void sm_window_merge(window_pane * total, window_pane const * pane) {
+    if (0 == pane->count) return;
+    if (0 == total->count) {
+        *total = *pane;
+        return;
+    }
+    uint32_t count = total->count + pane->count;
+    float delta = pane->mean - total->mean;
+    total->mean += delta * (float)pane->count / (float)count;
+    total->m2 += pane->m2 + delta * delta * (float)total->count * (float)pane->count / (float)count;
+    if (pane->min < total->min) total->min = pane->min;
+    if (pane->max > total->max) total->max = pane->max;
+    total->last = pane->last;
+    total->count = count;
+}
+
+// Publish the window statistics once the current pane is complete
+static void sm_window_run(int i, uint32_t now) {
+    instance_window * window = &sensor_windows[i];
+    window_pane total = {0};
+
+    if (now - window->pane_start < window->pane_length) return;
+    // Merge all panes, from the oldest to the current one
+    for (uint8_t n = 1; n <= window->num_panes; n++) {
+        sm_window_merge(&total, &window->pane[(window->current + n) % window->num_panes]);
+    }
+    if (0 < total.count) {
+        sm_aggregate aggregate;
+        aggregate.min = total.min;
+        aggregate.max = total.max;
+        aggregate.mean = sm_round(total.mean);
+        aggregate.stddev = (1 < total.count) ? sm_round(sqrtf(total.m2 / (float)(total.count - 1))) : 0;
+        aggregate.last = total.last;
+        aggregate.count = total.count;
+        sm_publish_aggregate(i, &aggregate);
+    }
+    // Start a new pane, replacing the oldest one
+    window->current = (uint8_t)((window->current + 1) % window->num_panes);
+    memset(&window->pane[window->current], 0, sizeof(window_pane));
+    window->pane_start += window->pane_length;
+    if (now - window->pane_start >= window->pane_length) {
+        // SM was not called for longer than a pane, restart timing from now
+        window->pane_start = now;
+    }
+}
+#endif
+
+// Compare "<type path>/<driver id>" of instance i with a path (without the leading '/')
+static bool sm_path_match(int i, const char * path) {
+    const char * s = driver_path[sensor_const_properties[i].type];
+    while (('\0' != *s) && (*s == *path)) { s++; path++; }
+    if (('\0' != *s) || ('/' != *path++)) return false;
+    s = driver_id[sensor_const_properties[i].driver-1];
+    while (('\0' != *s) && (*s == *path)) { s++; path++; }
+    return ('\0' == *s) && ('\0' == *path);
+}
+
+#if SM_CFG_PATH_INDEX_ENABLE
+// FNV-1a, a hash can be continued with the next part of a string
+static uint32_t sm_hash_string(uint32_t hash, const char * s) {
+    while ('\0' != *s) {
+        hash = (hash ^ (uint8_t)*s++) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static void sm_build_path_index(void) {
+    memset(path_index, 0, sizeof(path_index));
+    for (uint16_t i = 0; NUM_SENSORS > i; i++) {
+        uint32_t hash = sm_hash_string(FNV_OFFSET, driver_path[sensor_const_properties[i].type]);
+        hash = sm_hash_string(hash, "/");
+        path_hash[i] = sm_hash_string(hash, driver_id[sensor_const_properties[i].driver-1]);
+        if (0 == sensor_properties[i].handle.value) continue;
+        // The table is never more than half full, so a free slot is always found
+        uint32_t slot = path_hash[i] % PATH_INDEX_SIZE;
+        while (0 != path_index[slot]) {
+            int j = path_index[slot] - 1;
+            // Only the first instance of a path can be looked up, identical sensors (ie.: behind a mux) are not indexed
+            if ((sensor_const_properties[j].type == sensor_const_properties[i].type) &&
+                (sensor_const_properties[j].driver == sensor_const_properties[i].driver)) break;
+            slot = (slot + 1) % PATH_INDEX_SIZE;
+        }
+        if (0 == path_index[slot]) path_index[slot] = (uint16_t)(i + 1);
+    }
+}
+#endif
+
+#if SM_CFG_CONFIG_ENABLE
+static sm_config_entry config_entries[NUM_SENSORS];
+
+// Identify the instance table, a saved configuration only applies to the sensor definition that wrote it
+static uint32_t sm_config_layout(void) {
+    uint32_t hash = FNV_OFFSET;
+    for (int i = 0; NUM_SENSORS > i; i++) {
+        uint8_t const fields[] = {(uint8_t)sensor_const_properties[i].type, (uint8_t)sensor_const_properties[i].driver,
+                                  sensor_const_properties[i].channel, sensor_const_properties[i].mux,
+                                  sensor_const_properties[i].port};
+        for (uint8_t n = 0; sizeof(fields) > n; n++) {
+            hash = (hash ^ fields[n]) * FNV_PRIME;
+        }
+    }
+    return hash;
+}
+
+// Restore the attributes saved by the application, drivers get theirs when they are opened
+static void sm_load_config(void) {
+    if (SM_OK != sm_config_load(config_entries, NUM_SENSORS, sm_config_layout())) return;
+    for (int i = 0; NUM_SENSORS > i; i++) {
+        sensor_properties[i].config_flags = config_entries[i].flags;
+        sensor_properties[i].sample_interval = config_entries[i].sample_interval;
+        if (0 != (config_entries[i].flags & SM_CONFIG_ACQUISITION_INTERVAL)) {
+            sensor_properties[i].interval = config_entries[i].acquisition_interval;
+        }
+    }
+}
+
+static void sm_apply_config(int i, sm_interface * this_driver) {
+    if (0 != (sensor_properties[i].config_flags & SM_CONFIG_ACQUISITION_INTERVAL)) {
+        this_driver->set_attr(sensor_properties[i].handle, SM_ACQUISITION_INTERVAL, sensor_properties[i].interval);
+    }
+    if (0 != (sensor_properties[i].config_flags & SM_CONFIG_SAMPLE_INTERVAL)) {
+        this_driver->set_attr(sensor_properties[i].handle, SM_SAMPLE_INTERVAL, sensor_properties[i].sample_interval);
+    }
+}
+#endif
+
+#if SM_CFG_DISCOVERY_ENABLE
+// Find the address of instance i, returns false if no device answered the driver probe
+static bool sm_discover(int i, uint32_t start) {
+    instance_const_property const * instance = &sensor_const_properties[i];
+    // Channels of the same sensor use the device found for the first channel
+    for (int j = 0; i > j; j++) {
+        if ((sensor_const_properties[j].driver == instance->driver) &&
+            (sensor_const_properties[j].mux == instance->mux) &&
+            (sensor_const_properties[j].port == instance->port) &&
+            (sensor_const_properties[j].probe_first == instance->probe_first) &&
+            (sensor_const_properties[j].probe_last == instance->probe_last)) {
+            sensor_properties[i].address = sensor_properties[j].address;
+            return (0 != sensor_properties[j].handle.value);
+        }
+    }
+    sm_interface *this_driver = (sm_interface *)driver[instance->driver-1];
+    sm_select_port(i);
+    for (uint16_t address = instance->probe_first; address <= instance->probe_last; address++) {
+        if (utils_systime_get() - start >= SM_CFG_DISCOVERY_TIMEOUT_MS) {
+            log_error("Sensor index %d discovery timeout", i);
+            break;
+        }
+        if (SM_OK == this_driver->probe((uint8_t)address)) {
+            log_info("Sensor index %d found at 0x%x", i, address);
+            sensor_properties[i].address = (uint8_t)address;
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
 void sm_init(void) {
     log_info("Init SM");
 #if (BSP_CFG_RTOS) == 0
@@ -179,61 +841,399 @@ void sm_init(void) {
 #elif (BSP_CFG_RTOS) == 1
     // On AzureRTOS we need to initialize the message queue
     UINT result;
-    result = tx_queue_create(&g_sensor_queue, "Sensor", sizeof(sm_sensor_data), &sensor_queue_storage[0], sizeof(sensor_queue_storage));
+    result = tx_queue_create(&g_sensor_queue, "Sensor", sizeof(sm_sensor_data) / sizeof(ULONG), &sensor_queue_storage[0], sizeof(sensor_queue_storage));
     if (TX_SUCCESS != result) {
         // Error creating the queue
         log_error("Queue creation failed");
         log_debug("Error %d", result);
         APP_TRAP();
     }    
+#if SM_CFG_EVENT_DRIVEN
+    result = tx_event_flags_create(&sm_events, "Sensor Manager");
+    if (TX_SUCCESS != result) {
+        log_error("Event flags creation failed");
+        log_debug("Error %d", result);
+        APP_TRAP();
+    }
+#endif
+#if SM_CFG_AGGREGATION_ENABLE
+    result = tx_queue_create(&g_sensor_aggregate_queue, "Sensor aggregate", sizeof(sm_aggregate_data) / sizeof(ULONG), &sensor_aggregate_queue_storage[0], sizeof(sensor_aggregate_queue_storage));
+    if (TX_SUCCESS != result) {
+        log_error("Aggregate queue creation failed");
+        log_debug("Error %d", result);
+        APP_TRAP();
+    }
+#endif
 #elif (BSP_CFG_RTOS) == 2
     // On FreeRTOS we need to initialize the message queue
-    g_sensor_queue = xQueueCreateStatic(SENSOR_QUEUE_LENGTH, sizeof(sm_sensor_data), &sensor_queue_storage[0], &sensor_queue_memory);
+    g_sensor_queue = xQueueCreateStatic(SM_CFG_QUEUE_LENGTH, sizeof(sm_sensor_data), &sensor_queue_storage[0], &sensor_queue_memory);
     if (NULL == g_sensor_queue) {
         // Error creating the queue
         log_error("Queue creation failed");
         APP_TRAP();        
     }
+#if SM_CFG_AGGREGATION_ENABLE
+    g_sensor_aggregate_queue = xQueueCreateStatic(SM_CFG_AGGREGATE_QUEUE_LENGTH, sizeof(sm_aggregate_data), &sensor_aggregate_queue_storage[0], &sensor_aggregate_queue_memory);
+    if (NULL == g_sensor_aggregate_queue) {
+        log_error("Aggregate queue creation failed");
+        APP_TRAP();
+    }
 #endif
-    // First reset all sensors
-    for (int i = 0; NUM_SENSORS > i; i++) {
-        sm_interface *this_driver = (sm_interface *)driver[sensor_const_properties[i].driver-1];
-        this_driver->reset();
+#endif
+#if SM_USE_CYCLE_COUNTER
+    // Dispatch budget, FSM timing and group skew are measured with the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    cycles_per_us = SystemCoreClock / 1000000U;
+#endif
+#if SM_CFG_FSM_TIMING_ENABLE
+    memset(fsm_timing, 0, sizeof(fsm_timing));
+#endif
+#if (BSP_CFG_RTOS) != 0
+    memset(&queue_stats, 0, sizeof(queue_stats));
+#if SM_QUEUE_COALESCE == SM_CFG_QUEUE_OVERFLOW
+    memset(backlog, 0, sizeof(backlog));
+    backlog_next = 0;
+#endif
+#endif
+#if SM_CFG_GROUP_ENABLE
+    memset(group_properties, 0, sizeof(group_properties));
+#endif
+    run_start = 0;
+    fsm_start = 0;
+    // The state of the muxes is unknown until a port is selected
+    memset(mux_port, MUX_PORT_UNKNOWN, sizeof(mux_port));
+    mux_switches = 0;
+    sm_sort_by_port();
+#if SM_CFG_DEFERRED_DISPATCH
+    dispatch_budget = cycles_per_us * SM_CFG_DISPATCH_BUDGET_US;
+    memset(pending, 0, sizeof(pending));
+    num_pending = 0;
+    dispatch_next = 0;
+#endif
+    // First reset all drivers, once for each driver
+    for (uint16_t d = 0; NUM_DRIVERS > d; d++) {
+        driver[d]->reset();
     }
-    // Now open each sensor
+#if SM_CFG_DISCOVERY_ENABLE
+    // All probes share the same time budget, so sm_init() time is bounded whatever is on the bus
+    uint32_t discovery_start = utils_systime_get();
+#endif
+    // Sensors are opened by sm_run(), handles are known now so the application can register its callbacks
     for (int i = 0; NUM_SENSORS > i; i++) {
-        sm_interface *this_driver = (sm_interface *)driver[sensor_const_properties[i].driver-1];
-        sensor_properties[i].state = SM_OPEN;
+        sensor_properties[i].state = SM_INIT;
+        sensor_properties[i].address = sensor_const_properties[i].address;
         sensor_properties[i].handle.value = 0;
-        this_driver->open(&sensor_properties[i].handle, sensor_const_properties[i].address, sensor_const_properties[i].channel);
-        sensor_properties[i].handle.internal = sensor_const_properties[i].driver;
-        // Now get the pointer to the driver's flag
-        sensor_properties[i].flag = this_driver->get_flag(sensor_properties[i].handle);
+        sensor_properties[i].handle.address = sensor_properties[i].address;
+        sensor_properties[i].handle.channel = sensor_const_properties[i].channel;
+        // The instance number makes handles unique, even for identical sensors behind different mux ports
+        sensor_properties[i].handle.internal = (uint16_t)(i + 1);
+        sensor_properties[i].callback = NULL;
+        sensor_properties[i].flag = &always_zero;
+        sensor_properties[i].open = false;
+        sensor_properties[i].sequence = 0;
+        sensor_properties[i].dispatched = 0;
+#if SM_CFG_CONFIG_ENABLE
+        sensor_properties[i].config_flags = 0;
+#endif
+#if SM_CFG_GROUP_ENABLE
+        sensor_properties[i].group_sampled = false;
+#endif
+#if SM_CFG_DISCOVERY_ENABLE
+        if (0 != sensor_const_properties[i].probe_last) {
+            if (sm_discover(i, discovery_start)) {
+                sensor_properties[i].handle.address = sensor_properties[i].address;
+            } else {
+                // No device, the instance is disabled
+                log_error("Sensor index %d not found", i);
+                sensor_properties[i].handle.value = 0;
+                sensor_properties[i].state = SM_CLOSE;
+            }
+        }
+#endif
+#if SM_CFG_AGGREGATION_ENABLE
+        sm_window_init(i);
+#endif
+#if SM_CFG_RECOVERY_ENABLE
+        sensor_properties[i].consecutive_errors = 0;
+        sensor_properties[i].backoff = SM_CFG_RECOVERY_BACKOFF_MIN_MS;
+        sensor_properties[i].errors = 0;
+        sensor_properties[i].recoveries = 0;
+#endif
     }
+#if SM_CFG_PATH_INDEX_ENABLE
+    sm_build_path_index();
+#endif
+#if SM_CFG_CONFIG_ENABLE
+    // One read of the newest record in data flash
+    sm_load_config();
+#endif
     log_info("Working with %d sensors",NUM_SENSORS);
-    handle_indexer = 0;
 }
 
-void sm_run(void) {
+#if SM_CFG_EVENT_DRIVEN && ((BSP_CFG_RTOS) != 0)
+static void sm_deadline(uint32_t delay) {
+    if (delay < next_deadline) next_deadline = delay;
+}
+
+static uint32_t sm_remaining(uint32_t start, uint32_t length, uint32_t now) {
+    uint32_t elapsed = now - start;
+    return (elapsed < length) ? (length - elapsed) : 0;
+}
+
+// Find when instance i needs to run again
+static void sm_update_deadline(int i, uint32_t now) {
+    switch (sensor_properties[i].state) {
+        case SM_CLOSE:
+        case SM_SW_TRIGGER:
+            // Waiting for the driver or the application, they call sm_wake()
+            break;
+        case SM_GROUPED:
+        case SM_GROUP_TRIGGERED:
+            // The group sets the deadline, flagged drivers call sm_wake()
+            break;
+        case SM_WAITING:
+            sm_deadline(sm_remaining(sensor_properties[i].last_sample_time, sensor_properties[i].interval + 1, now));
+            break;
+#if SM_CFG_RECOVERY_ENABLE
+        case SM_RECOVERING:
+            sm_deadline(sm_remaining(sensor_properties[i].recovery_start, sensor_properties[i].recovery_delay, now));
+            break;
+#endif
+        default:
+            sm_deadline(0);
+    }
+#if SM_CFG_AGGREGATION_ENABLE
+    if (0 < sensor_windows[i].num_panes) {
+        sm_deadline(sm_remaining(sensor_windows[i].pane_start, sensor_windows[i].pane_length, now));
+    }
+#endif
+}
+#endif
+
+void sm_wake_after(uint32_t delay) {
+#if SM_CFG_EVENT_DRIVEN && ((BSP_CFG_RTOS) != 0)
+    sm_deadline(delay);
+#else
+    FSP_PARAMETER_NOT_USED(delay);
+#endif
+}
+
+void sm_wake(void) {
+#if SM_CFG_EVENT_DRIVEN && ((BSP_CFG_RTOS) == 1)
+    tx_event_flags_set(&sm_events, SM_EVENT_WAKE, TX_OR);
+#elif SM_CFG_EVENT_DRIVEN && ((BSP_CFG_RTOS) == 2)
+    if (NULL == sm_task_handle) return;
+    if (0 != __get_IPSR()) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(sm_task_handle, &woken);
+        portYIELD_FROM_ISR(woken);
+    } else {
+        xTaskNotifyGive(sm_task_handle);
+    }
+#endif
+}
+
+#if SM_CFG_GROUP_ENABLE
+// Start the acquisition of the members of a group, drivers with a flag start a measurement now
+static void sm_group_trigger(uint8_t g, uint32_t now) {
+    group_property * group = &group_properties[g];
+    uint16_t triggered = 0;
+    group->trigger_time = now;
+    group->trigger_cycles = DWT->CYCCNT;
+    for (int i = 0; NUM_SENSORS > i; i++) {
+        // Members being opened or recovered are not waited for
+        if ((g != sensor_const_properties[i].group) || (SM_GROUPED != sensor_properties[i].state)) continue;
+        sm_interface *this_driver = (sm_interface *)driver[sensor_const_properties[i].driver-1];
+        sensor_properties[i].group_sampled = false;
+        if (0 == sensor_properties[i].handle.value) {
+            sensor_properties[i].state = SM_CLOSE;
+            continue;
+        }
+        if (&always_zero != sensor_properties[i].flag) {
+            // Drop a sample measured before the trigger, the driver flags the one started now
+            *sensor_properties[i].flag = 0;
+            sm_select_port(i);
+            this_driver->trigger(sensor_properties[i].handle);
+        }
+        sensor_properties[i].state = SM_GROUP_TRIGGERED;
+        triggered++;
+    }
+    // With no member ready (ie.: still opening) the group is triggered again in the next pass
+    group->acquiring = (0 < triggered);
+    group->started = group->started || group->acquiring;
+}
+
+// Publish the samples held by the members of a group together and record the spread of their read times
+static void sm_group_release(uint8_t g) {
+    group_property * group = &group_properties[g];
+    sm_group_set set = {.group = (sm_group)g, .timestamp = group->trigger_time, .members = 0, .complete = 0};
+    uint32_t first = 0;
+    uint32_t last = 0;
+    for (int i = 0; NUM_SENSORS > i; i++) {
+        if (g != sensor_const_properties[i].group) continue;
+        set.members++;
+        // A member that missed the timeout starts again at the next trigger, its late sample is ignored
+        if (SM_GROUP_TRIGGERED == sensor_properties[i].state) sensor_properties[i].state = SM_GROUPED;
+        if (!sensor_properties[i].group_sampled) continue;
+        sensor_properties[i].group_sampled = false;
+        // Read times relative to the trigger, the cycle counter can wrap
+        uint32_t offset = sensor_properties[i].group_cycles - group->trigger_cycles;
+        if ((0 == set.complete) || (offset < first)) first = offset;
+        if ((0 == set.complete) || (offset > last)) last = offset;
+        set.complete++;
+#if SM_CFG_AGGREGATION_ENABLE
+        if (0 < sensor_windows[i].num_panes) {
+            sm_window_add(i, sensor_properties[i].data);
+            continue;
+        }
+#endif
+        sm_publish(i);
+    }
+    group->acquiring = false;
+    group->sets++;
+    group->last_skew = last - first;
+    if (group->last_skew > group->max_skew) group->max_skew = group->last_skew;
+    set.skew_us = group->last_skew / cycles_per_us;
+    if (NULL != group->callback) group->callback(&set);
+}
+
+// Advance an acquiring group: the members with a flag are waited for first, then the polled members are all read
+// in the next pass, so every sample is aligned to the end of the slowest measurement. Then the set is released
+static void sm_group_progress(uint8_t g, uint32_t now) {
+    group_property * group = &group_properties[g];
+    uint16_t measuring = 0;
+    uint16_t polled = 0;
+    uint16_t sampling = 0;
+    for (int i = 0; NUM_SENSORS > i; i++) {
+        if (g != sensor_const_properties[i].group) continue;
+        if (SM_SAMPLING == sensor_properties[i].state) {
+            sampling++;
+        } else if (SM_GROUP_TRIGGERED == sensor_properties[i].state) {
+            if (&always_zero == sensor_properties[i].flag) polled++; else measuring++;
+        }
+    }
+    if ((0 < measuring) && (now - group->trigger_time < group_const_properties[g].timeout)) return;
+    if (0 < polled) {
+        for (int i = 0; NUM_SENSORS > i; i++) {
+            if ((g == sensor_const_properties[i].group) && (SM_GROUP_TRIGGERED == sensor_properties[i].state) &&
+                (&always_zero == sensor_properties[i].flag)) {
+                sensor_properties[i].state = SM_SAMPLING;
+            }
+        }
+#if SM_CFG_EVENT_DRIVEN && ((BSP_CFG_RTOS) != 0)
+        sm_deadline(0);
+#endif
+        return;
+    }
+    if (0 < sampling) return;
+    if (0 < measuring) {
+        log_error("Group %d timeout", g);
+        group->timeouts++;
+    }
+    sm_group_release(g);
+}
+
+// Release the groups whose members were all read (or timed out) and trigger the groups that are due
+static void sm_run_groups(uint32_t now) {
+    for (uint8_t g = 1; NUM_GROUPS >= g; g++) {
+        group_property * group = &group_properties[g];
+        group_const_property const * config = &group_const_properties[g];
+        if (group->acquiring) sm_group_progress(g, now);
+        if (!group->acquiring && (!group->started || (now - group->trigger_time >= config->interval))) {
+            sm_group_trigger(g, now);
+            if (group->acquiring) sm_group_progress(g, now);
+        }
+#if SM_CFG_EVENT_DRIVEN && ((BSP_CFG_RTOS) != 0)
+        sm_deadline(sm_remaining(group->trigger_time, group->acquiring ? config->timeout : config->interval, now));
+#endif
+    }
+}
+#endif
+
+// Run the FSM of each driver once, a driver shared by several instances is not serviced more than once per pass
+static void sm_run_drivers(void) {
+    for (uint16_t n = 0; NUM_DRIVERS > n; n++) {
+        uint16_t d = (uint16_t)((fsm_start + n) % NUM_DRIVERS);
+#if SM_CFG_FSM_TIMING_ENABLE
+        uint32_t start = DWT->CYCCNT;
+        driver[d]->fsm();
+        uint32_t elapsed = DWT->CYCCNT - start;
+        fsm_timing[d].calls++;
+        fsm_timing[d].last = elapsed;
+        fsm_timing[d].total += elapsed;
+        if (elapsed > fsm_timing[d].max) fsm_timing[d].max = elapsed;
+#else
+        driver[d]->fsm();
+#endif
+    }
+    fsm_start = (uint16_t)((fsm_start + 1) % NUM_DRIVERS);
+}
+
+// Service all sensors once, returns true if all of them are waiting
+static bool sm_run_pass(void) {
     uint32_t minimum_interval = UINT32_MAX;
     uint32_t num_waiting = 0;
     uint32_t num_wait_trigger = 0;
-    for (int i = 0; NUM_SENSORS > i; i++) {
+#if SM_CFG_EVENT_DRIVEN && ((BSP_CFG_RTOS) != 0)
+    next_deadline = SM_NO_DEADLINE;
+#endif
+    for (int n = 0; NUM_SENSORS > n; n++) {
+        int i = run_order[(run_start + n) % NUM_SENSORS];
         // Get the driver for this sensor
         sm_interface *this_driver = (sm_interface *)driver[sensor_const_properties[i].driver-1];
-        if (0 != *sensor_properties[i].flag) {
+        if ((0 != *sensor_properties[i].flag) && (SM_RECOVERING != sensor_properties[i].state) &&
+            (SM_INIT != sensor_properties[i].state) && (SM_GROUPED != sensor_properties[i].state)) {
             // Sensor is flagged, that means there is data to read
             sensor_properties[i].state = SM_SAMPLING;
         }
         switch (sensor_properties[i].state) {
             case SM_CLOSE:
-                if (0 != sensor_properties[i].handle.value) {
+                if (sensor_properties[i].open) {
+                    sm_select_port(i);
                     this_driver->close(sensor_properties[i].handle);
                     sensor_properties[i].handle.value = 0;
+                    sensor_properties[i].open = false;
                 }
+                num_waiting++;
+                break;
+            case SM_INIT:
+                sensor_properties[i].handle.value = 0;
+                sm_select_port(i);
+                this_driver->open(&sensor_properties[i].handle, sensor_properties[i].address, sensor_const_properties[i].channel);
+                sensor_properties[i].handle.internal = (uint16_t)(i + 1);
+                // Now get the pointer to the driver's flag
+                sensor_properties[i].flag = this_driver->get_flag(sensor_properties[i].handle);
+                sensor_properties[i].open = true;
+                if (NULL == sensor_properties[i].flag) {
+                    // A sensor that failed to open has no flag yet, a polled one gets read errors until it is
+                    // recovered but a driver paced one would wait for its flag forever
+                    sensor_properties[i].flag = &always_zero;
+                    if (sensor_const_properties[i].driver_paced) {
+                        log_error("Sensor index %d open failed", i);
+                        sensor_properties[i].status = SM_SENSOR_ERROR;
+#if SM_CFG_RECOVERY_ENABLE
+                        sensor_properties[i].errors++;
+                        sm_schedule_recovery(i);
+#else
+                        sensor_properties[i].state = SM_CLOSE;
+#endif
+                        break;
+                    }
+                }
+#if SM_CFG_CONFIG_ENABLE
+                sm_apply_config(i, this_driver);
+#endif
+                sensor_properties[i].state = SM_OPEN;
                 break;
             case SM_OPEN:
-                if (0 < sensor_properties[i].interval) {
+#if SM_CFG_GROUP_ENABLE
+                if (SM_GROUP_NONE != sensor_const_properties[i].group) {
+                    // Members are sampled when their group is triggered
+                    sensor_properties[i].state = SM_GROUPED;
+                } else
+#endif
+                if (sm_is_timed(i)) {
                     sensor_properties[i].state = SM_TRIGGERED;
                 } else sensor_properties[i].state = SM_SW_TRIGGER;
                 break;
@@ -250,6 +1250,7 @@ void sm_run(void) {
                 break;
           case SM_SAMPLING:
                 *sensor_properties[i].flag = 0;
+                sm_select_port(i);
                 sensor_properties[i].status = this_driver->read(sensor_properties[i].handle, &sensor_properties[i].data);
                 if (SM_SENSOR_DATA_VALID == sensor_properties[i].status) {
                     log_debug("Sensor index %d received %d",i,sensor_properties[i].data);
@@ -261,55 +1262,96 @@ void sm_run(void) {
                     log_error("Sensor index %d error",i);
                 }
                 if (SM_SENSOR_DATA_VALID == sensor_properties[i].status) {
-#if (BSP_CFG_RTOS) == 0                
-                    // On baremetal, if we have a callback registered for this sensor, it is time to call it!
-                    if (NULL != sensor_properties[i].callback) {
-                        sensor_properties[i].callback(sensor_properties[i].handle, (uint8_t *)&sensor_properties[i].data, sizeof(sensor_properties[i].data));
-                    }
-#elif (BSP_CFG_RTOS) == 1
-                    // On AzureRTOS we send the data to the queue
-                    sm_sensor_data data;
-                    data.handle = sensor_properties[i].handle;
-                    data.data = sensor_properties[i].data;
-                    UINT result = tx_queue_send(&g_sensor_queue, (void *)&data, (ULONG) SENSOR_SEND_WAIT_TIME);
-                    if(TX_SUCCESS != result) {
-                        // Failed to send sensor data
-                        log_error("Queue send fail");
-                        log_debug("Error %d",result);
-                        log_debug("Handle %d",data.handle.value);
-                    }
-#elif (BSP_CFG_RTOS) == 2
-                    // On FreeRTOS we send the data to the queue
-                    sm_sensor_data data;
-                    data.handle = sensor_properties[i].handle;
-                    data.data = sensor_properties[i].data;
-                    BaseType_t result = xQueueSend(g_sensor_queue, (void *)&data, ( TickType_t ) SENSOR_SEND_WAIT_TIME);
-                    if(pdPASS != result) {
-                        // Failed to send sensor data
-                        log_error("Queue send fail");
-                        log_debug("Error %d",result);
-                        log_debug("Handle %d",data.handle.value);                    
+#if SM_CFG_GROUP_ENABLE
+                    if (SM_GROUP_NONE != sensor_const_properties[i].group) {
+                        // The sample is held until the whole group is released
+                        sensor_properties[i].group_sampled = true;
+                        sensor_properties[i].group_cycles = DWT->CYCCNT;
+                    } else
+#endif
+#if SM_CFG_AGGREGATION_ENABLE
+                    if (0 < sensor_windows[i].num_panes) {
+                        // Windowed instance, statistics are published at the end of each window
+                        sm_window_add(i, sensor_properties[i].data);
+                    } else {
+                        sm_publish(i);
                     }
+#else
+                    sm_publish(i);
 #endif
                 }
                 sensor_properties[i].last_sample_time = utils_systime_get();
-                if (0 < sensor_properties[i].interval) {
+#if SM_CFG_GROUP_ENABLE
+                if (SM_GROUP_NONE != sensor_const_properties[i].group) {
+                    sensor_properties[i].state = SM_GROUPED;
+                } else
+#endif
+                if (sm_is_timed(i)) {
                     sensor_properties[i].state = SM_WAITING;
                 } else {
                     sensor_properties[i].state = SM_SW_TRIGGER;
                 }
+#if SM_CFG_RECOVERY_ENABLE
+                sm_check_errors(i);
+#endif
+                break;
+#if SM_CFG_GROUP_ENABLE
+          case SM_GROUPED:
+          case SM_GROUP_TRIGGERED:
+                // Sampled by sm_run_groups()
+                num_waiting++;
                 break;
+#endif
           case SM_WAITING:
                 if (sensor_properties[i].interval < minimum_interval) minimum_interval = sensor_properties[i].interval;
                 if (utils_systime_get() - sensor_properties[i].last_sample_time > sensor_properties[i].interval) {
                     sensor_properties[i].state = SM_SAMPLING;
                 } else num_waiting++;
                 break;
+#if SM_CFG_RECOVERY_ENABLE
+          case SM_RECOVERING:
+                if (utils_systime_get() - sensor_properties[i].recovery_start >= sensor_properties[i].recovery_delay) {
+                    sm_recover(i);
+                } else num_waiting++;
+                break;
+#endif
+          default:
+                sensor_properties[i].state = SM_OPEN;
         }
-        this_driver->fsm();
+#if SM_CFG_AGGREGATION_ENABLE
+        if (0 < sensor_windows[i].num_panes) sm_window_run(i, utils_systime_get());
+#endif
+#if SM_CFG_EVENT_DRIVEN && ((BSP_CFG_RTOS) != 0)
+        sm_update_deadline(i, utils_systime_get());
+#endif
     }
+    run_start = (uint16_t)((run_start + 1) % NUM_SENSORS);
+#if SM_CFG_GROUP_ENABLE
+    // Triggered FSM drivers start their measurement right away, in sm_run_drivers()
+    sm_run_groups(utils_systime_get());
+#endif
+    sm_run_drivers();
+#if ((BSP_CFG_RTOS) != 0) && (SM_QUEUE_COALESCE == SM_CFG_QUEUE_OVERFLOW)
+    // Waiting samples go out as soon as the consumer makes room, even if no new sample is published
+    sm_queue_flush();
+#if SM_CFG_EVENT_DRIVEN
+    // There is no event when the consumer makes room, retry on the next tick
+    if (0 < queue_stats.backlog) sm_deadline(1);
+#endif
+#endif
+#if SM_CFG_DEFERRED_DISPATCH
+    // Acquisition is done for all sensors, now run the callbacks
+    sm_dispatch_pending();
+#if SM_CFG_EVENT_DRIVEN && ((BSP_CFG_RTOS) != 0)
+    if (0 < num_pending) sm_deadline(0);
+#endif
+#endif
+    return (NUM_SENSORS == (num_waiting + num_wait_trigger));
+}
+
+void sm_run(void) {
     // We went through all sensors, now set sleep time to the minimum interval
-    if (NUM_SENSORS == (num_waiting + num_wait_trigger)) {
+    if (sm_run_pass()) {
 #if (BSP_CFG_RTOS) == 0
     // Do nothing in baremetal
 #elif (BSP_CFG_RTOS) == 1
@@ -320,10 +1362,39 @@ void sm_run(void) {
     }
 }
 
-static int16_t sm_get_sensor_index(sm_handle handle) {
-    for (int16_t i = 0; i < NUM_SENSORS; i++) {
-        if (handle.value == sensor_properties[i].handle.value) return i;
+void sm_task(void) {
+#if SM_CFG_EVENT_DRIVEN && ((BSP_CFG_RTOS) != 0)
+#if (BSP_CFG_RTOS) == 2
+    sm_task_handle = xTaskGetCurrentTaskHandle();
+#endif
+    while (1) {
+        sm_run_pass();
+        // Sleep until the next deadline, an earlier sm_wake() ends the wait
+#if (BSP_CFG_RTOS) == 1
+        ULONG events;
+        ULONG wait = (SM_NO_DEADLINE == next_deadline) ? TX_WAIT_FOREVER :
+                     (ULONG)(((uint64_t)next_deadline * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U);
+        if (0 < wait) tx_event_flags_get(&sm_events, SM_EVENT_WAKE, TX_OR_CLEAR, &events, wait);
+#elif (BSP_CFG_RTOS) == 2
+        // Rounded up, a deadline shorter than a tick would not block at all (pdMS_TO_TICKS rounds down)
+        TickType_t wait = (SM_NO_DEADLINE == next_deadline) ? portMAX_DELAY :
+                          (TickType_t)(((uint64_t)next_deadline * configTICK_RATE_HZ + 999U) / 1000U);
+        if (0 < wait) ulTaskNotifyTake(pdTRUE, wait);
+#endif
+    }
+#else
+    // Without an event driven RTOS build SM is polled
+    while (1) {
+        sm_run();
     }
+#endif
+}
+
+int16_t sm_get_sensor_index(sm_handle handle) {
+    if (!IS_HANDLE_VALID(handle)) return -1;
+    // The internal field holds the instance number
+    uint16_t i = (uint16_t)(handle.internal - 1U);
+    if ((NUM_SENSORS > i) && (handle.value == sensor_properties[i].handle.value)) return (int16_t)i;
     log_debug("Handle not found");
     return -1;
 }
@@ -334,7 +1405,7 @@ sm_sensor_status sm_read_sensor(sm_handle handle, int32_t * data) {
     if (0 <= sensor_index) {
         *data = sensor_properties[sensor_index].data;
         result =  sensor_properties[sensor_index].status;
-        // if we read the sensor again before it is updated, we will sill state status
+        // if we read the sensor again before it is updated, we will stale status
         sensor_properties[sensor_index].status = SM_SENSOR_STALE_DATA;
     }
     return result;
@@ -344,14 +1415,15 @@ uint16_t sm_get_total_sensor_count(void) {
     return NUM_SENSORS;
 }
 
-int32_t sm_get_sensor_handle(sm_type type, sm_handle * handle) {
-    while (handle_indexer < NUM_SENSORS) {
-        if (SENSOR_ANY_TYPE == type  || sensor_const_properties[handle_indexer].type == type) {
-            handle->value = sensor_properties[handle_indexer++].handle.value;
+int32_t sm_get_sensor_handle(sm_type type, sm_handle * handle, uint16_t * idx) {
+    while (*idx < NUM_SENSORS) {
+        if ((0 != sensor_properties[*idx].handle.value) &&
+            (SENSOR_ANY_TYPE == type  || sensor_const_properties[*idx].type == type)) {
+            handle->value = sensor_properties[(*idx)++].handle.value;
             return 0;
-        } else handle_indexer++;
+        } else (*idx)++;
     }
-    handle_indexer = 0;  // We have gone through all sensors, reset the indexer
+    *idx = 0;  // We have gone through all sensors, reset the indexer
     handle->value = 0;
     return -1;
 }
@@ -395,8 +1467,9 @@ void sm_register_callback_by_handle(sm_handle handle, sm_callback callback) {
 uint16_t sm_register_callback_by_type(sm_type type, sm_callback callback) {
     sm_handle handle;
     uint16_t num_registrations = 0;
+    uint16_t index = 0;
     while (1) {
-        if (0 != sm_get_sensor_handle(type, &handle)) break;
+        if (0 != sm_get_sensor_handle(type, &handle, &index)) break;
         sm_register_callback_by_handle(handle, callback);
         num_registrations++;
     }
@@ -406,8 +1479,9 @@ uint16_t sm_register_callback_by_type(sm_type type, sm_callback callback) {
 uint16_t sm_register_callback_any_type(sm_callback callback) {
     sm_handle handle;
     uint16_t num_registrations = 0;
+    uint16_t index = 0;
     while (1) {
-        if (0 != sm_get_sensor_handle(SENSOR_ANY_TYPE, &handle)) break;
+        if (0 != sm_get_sensor_handle(SENSOR_ANY_TYPE, &handle, &index)) break;
         sm_register_callback_by_handle(handle, callback);
         num_registrations++;
     }
@@ -440,6 +1514,31 @@ const char * sm_get_sensor_path_by_handle(sm_handle handle) {
     } else return NULL;
 }
 
+sm_handle sm_get_sensor_handle_by_path(const char * path) {
+    sm_handle handle = INVALID_HANDLE_INIT;
+    if (NULL == path) return handle;
+    if ('/' == *path) path++;
+#if SM_CFG_PATH_INDEX_ENABLE
+    uint32_t hash = sm_hash_string(FNV_OFFSET, path);
+    // Instances sharing a path are found in declaration order, the first one is returned
+    for (uint32_t slot = hash % PATH_INDEX_SIZE; 0 != path_index[slot]; slot = (slot + 1) % PATH_INDEX_SIZE) {
+        int i = path_index[slot] - 1;
+        if ((hash == path_hash[i]) && sm_path_match(i, path)) {
+            handle.value = sensor_properties[i].handle.value;
+            break;
+        }
+    }
+#else
+    for (int i = 0; NUM_SENSORS > i; i++) {
+        if ((0 != sensor_properties[i].handle.value) && sm_path_match(i, path)) {
+            handle.value = sensor_properties[i].handle.value;
+            break;
+        }
+    }
+#endif
+    return handle;
+}
+
 sm_result sm_set_sensor_attribute(sm_handle handle, sm_sensor_attributes attr, uint32_t value) {
     int16_t sensor_index = sm_get_sensor_index(handle);
     sm_result result = SM_ERROR;
@@ -447,10 +1546,27 @@ sm_result sm_set_sensor_attribute(sm_handle handle, sm_sensor_attributes attr, u
         sm_interface *this_driver = (sm_interface *)driver[sensor_const_properties[sensor_index].driver-1];
         result = this_driver->set_attr(handle, attr, value);
     	if (SM_ACQUISITION_INTERVAL == attr) {
-            // Update sensor manager publishing interval
-            sensor_properties[sensor_index].interval = value;
-            result = SM_OK;
-        }        
+            // Update sensor manager publishing interval, the interval of a driver paced instance is the driver's
+            // (SM keeps it for sm_save_config())
+            if (!sensor_const_properties[sensor_index].driver_paced) result = SM_OK;
+            if (SM_OK == result) sensor_properties[sensor_index].interval = value;
+        }
+#if SM_CFG_CONFIG_ENABLE
+        if (SM_OK == result) {
+            // The attribute is restored after a reset
+            if (SM_ACQUISITION_INTERVAL == attr) {
+                sensor_properties[sensor_index].config_flags |= SM_CONFIG_ACQUISITION_INTERVAL;
+            } else if (SM_SAMPLE_INTERVAL == attr) {
+                sensor_properties[sensor_index].config_flags |= SM_CONFIG_SAMPLE_INTERVAL;
+                sensor_properties[sensor_index].sample_interval = value;
+            }
+#if SM_CFG_CONFIG_AUTOSAVE
+            if (SM_OK != sm_save_config()) {
+                log_error("Config save failed");
+            }
+#endif
+        }
+#endif
     }
     return result;
 }
@@ -461,11 +1577,139 @@ sm_result sm_get_sensor_attribute(sm_handle handle, sm_sensor_attributes attr, u
     if (0 <= sensor_index) {
         sm_interface *this_driver = (sm_interface *)driver[sensor_const_properties[sensor_index].driver-1];
         result = this_driver->get_attr(handle, attr, value);
-    	if (SM_ACQUISITION_INTERVAL == attr) {
-            // Update sensor manager publishing interval
+    	if ((SM_ACQUISITION_INTERVAL == attr) && !sensor_const_properties[sensor_index].driver_paced) {
+            // return sensor manager publishing interval
             *value = sensor_properties[sensor_index].interval;
             result = SM_OK;
-        }        
+        }
     }
     return result;
 }
+
+sm_result sm_get_queue_stats(sm_queue_stats * stats) {
+#if (BSP_CFG_RTOS) != 0
+    *stats = queue_stats;
+    return SM_OK;
+#else
+    FSP_PARAMETER_NOT_USED(stats);
+    return SM_NOT_SUPPORTED;
+#endif
+}
+
+uint32_t sm_get_dispatch_drops(void) {
+#if SM_CFG_DEFERRED_DISPATCH
+    return dispatch_drops;
+#else
+    return 0;
+#endif
+}
+
+sm_result sm_get_driver_fsm_stats(sm_driver drv, sm_driver_stats * stats) {
+#if SM_CFG_FSM_TIMING_ENABLE
+    if ((SM_DRIVER_FIRST == drv) || (SM_DRIVER_LAST <= drv)) return SM_ERROR;
+    driver_fsm_timing const * timing = &fsm_timing[drv - 1];
+    stats->calls = timing->calls;
+    stats->last_us = timing->last / cycles_per_us;
+    stats->max_us = timing->max / cycles_per_us;
+    stats->total_us = timing->total / cycles_per_us;
+    return SM_OK;
+#else
+    FSP_PARAMETER_NOT_USED(drv);
+    FSP_PARAMETER_NOT_USED(stats);
+    return SM_NOT_SUPPORTED;
+#endif
+}
+
+sm_result sm_get_sensor_recovery_stats(sm_handle handle, sm_recovery_stats * stats) {
+#if SM_CFG_RECOVERY_ENABLE
+    int16_t sensor_index = sm_get_sensor_index(handle);
+    if (0 > sensor_index) return SM_ERROR;
+    stats->errors = sensor_properties[sensor_index].errors;
+    stats->recoveries = sensor_properties[sensor_index].recoveries;
+    stats->backoff_ms = sensor_properties[sensor_index].backoff;
+    return SM_OK;
+#else
+    FSP_PARAMETER_NOT_USED(handle);
+    FSP_PARAMETER_NOT_USED(stats);
+    return SM_NOT_SUPPORTED;
+#endif
+}
+
+uint32_t sm_get_mux_switches(void) {
+    return mux_switches;
+}
+
+sm_result sm_register_group_callback(sm_group group, sm_group_callback callback) {
+#if SM_CFG_GROUP_ENABLE
+    if ((SM_GROUP_NONE == group) || (SM_GROUP_LAST <= group)) return SM_ERROR;
+    group_properties[group].callback = callback;
+    return SM_OK;
+#else
+    FSP_PARAMETER_NOT_USED(group);
+    FSP_PARAMETER_NOT_USED(callback);
+    return SM_NOT_SUPPORTED;
+#endif
+}
+
+sm_result sm_get_group_stats(sm_group group, sm_group_stats * stats) {
+#if SM_CFG_GROUP_ENABLE
+    if ((SM_GROUP_NONE == group) || (SM_GROUP_LAST <= group)) return SM_ERROR;
+    stats->sets = group_properties[group].sets;
+    stats->timeouts = group_properties[group].timeouts;
+    stats->last_skew_us = group_properties[group].last_skew / cycles_per_us;
+    stats->max_skew_us = group_properties[group].max_skew / cycles_per_us;
+    return SM_OK;
+#else
+    FSP_PARAMETER_NOT_USED(group);
+    FSP_PARAMETER_NOT_USED(stats);
+    return SM_NOT_SUPPORTED;
+#endif
+}
+
+sm_result sm_save_config(void) {
+#if SM_CFG_CONFIG_ENABLE
+    for (int i = 0; NUM_SENSORS > i; i++) {
+        config_entries[i].flags = sensor_properties[i].config_flags;
+        config_entries[i].acquisition_interval = sensor_properties[i].interval;
+        config_entries[i].sample_interval = sensor_properties[i].sample_interval;
+    }
+    return sm_config_store(config_entries, NUM_SENSORS, sm_config_layout());
+#else
+    return SM_NOT_SUPPORTED;
+#endif
+}
+
+sm_result sm_clear_config(void) {
+#if SM_CFG_CONFIG_ENABLE
+    return sm_config_clear();
+#else
+    return SM_NOT_SUPPORTED;
+#endif
+}
+
+uint32_t sm_get_sample_sequence(sm_handle handle) {
+    int16_t sensor_index = sm_get_sensor_index(handle);
+    if (0 > sensor_index) return 0;
+    return sensor_properties[sensor_index].dispatched;
+}
+
+uint32_t sm_sequence_check(sm_sequence_tracker * tracker, uint32_t sequence) {
+    uint32_t missing = 0;
+    // Sequence numbers start at 1, nothing can be missing before the first sample received
+    if (0 != tracker->next) {
+        int32_t delta = (int32_t)(sequence - tracker->next);
+        if (0 < delta) {
+            missing = (uint32_t)delta;
+            tracker->gaps++;
+            tracker->lost += missing;
+        } else if (0 > delta) {
+            // Older or repeated sample
+            tracker->reordered++;
+        }
+    }
+    if ((0 == tracker->next) || (0 <= (int32_t)(sequence - tracker->next))) {
+        tracker->next = sequence + 1;
+    }
+    tracker->received++;
+    return missing;
+}
@@ -1,10 +1,52 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
 #ifndef __SM_H
 #define __SM_H
 #include <sm_handle.h>
 #include <stdint.h>
+#include "sm_cfg.h"
 
 #define IS_HANDLE_VALID(X) (X.value != 0)
 
+/*
+  Optional instance options, appended after the interval field of DEFINE_SENSOR_INSTANCE
+  SM_WINDOW(window, slide) - publish statistics (sm_aggregate) over a window of "window" milliseconds instead of
+                             raw samples. Use slide = 0 for a tumbling window, otherwise a sliding window is published
+                             every "slide" milliseconds (window must be a multiple of slide)
+  SM_PROBE(first, last)    - the address field is ignored, sm_init() calls the driver probe function (<driver>_probe)
+                             for each address from "first" to "last" and the sensor uses the first address found.
+                             The instance is disabled (no handle) if no device is found. Instances of the same driver
+                             with the same range share the device found (ie.: channels of the same sensor)
+  SM_MUX(mux, port)        - the sensor is behind port "port" of an I2C multiplexer declared with DEFINE_SENSOR_MUX,
+                             SM selects the port before calling the driver. Identical sensors can share an address
+                             on different ports, instances of the same port are serviced together to limit switching
+  SM_GROUP(group)          - the sensor is a member of an acquisition group declared with DEFINE_SENSOR_GROUP. All the
+                             members are triggered in the same sm_run() pass at the group interval (the instance
+                             interval is not used). Drivers with a flag start a measurement (<driver>_trigger), once
+                             they all flagged their data the polled members are read in the next pass, then the
+                             samples are published together. A set is released incomplete when the group timeout
+                             expires. See sm_get_group_stats for the skew between the reads of a set
+*/
+#if SM_CFG_AGGREGATION_ENABLE
+#define SM_WINDOW(WINDOW_MS, SLIDE_MS) .window_ms=(WINDOW_MS), .slide_ms=(SLIDE_MS)
+#else
+#define SM_WINDOW(WINDOW_MS, SLIDE_MS)
+#endif
+#define SM_MUX(MUX, PORT) .mux=MUX_##MUX, .port=(PORT)
+#if SM_CFG_GROUP_ENABLE
+#define SM_GROUP(GROUP) .group=GROUP_##GROUP
+#else
+#define SM_GROUP(GROUP)
+#endif
+#if SM_CFG_DISCOVERY_ENABLE
+#define SM_PROBE(FIRST_ADDR, LAST_ADDR) .probe_first=(FIRST_ADDR), .probe_last=(LAST_ADDR)
+#else
+#define SM_PROBE(FIRST_ADDR, LAST_ADDR)
+#endif
+
 typedef enum {
     #define DEFINE_SENSOR_TYPE(TYPE, UNIT, PATH) TYPE,
     #include "sm_define_sensors.inc"
@@ -19,11 +61,29 @@ typedef enum {
     SM_DRIVER_LAST
 } sm_driver;
 
+typedef enum {
+    SM_MUX_NONE,
+    #define DEFINE_SENSOR_MUX(NAME, BUS) MUX_##NAME,
+    #include "sm_define_sensors.inc"
+    SM_MUX_LAST
+} sm_mux;
+
+typedef enum {
+    SM_GROUP_NONE,
+    #define DEFINE_SENSOR_GROUP(NAME, INTERVAL_MS, TIMEOUT_MS) GROUP_##NAME,
+    #include "sm_define_sensors.inc"
+    SM_GROUP_LAST
+} sm_group;
+
+// Port value passed to <mux>_select() to disable all the ports of a mux
+#define SM_MUX_PORT_NONE    (0xFFU)
+
 // The following anonymous enum is a simple way to get the total number of sensors (NUM_SENSORS) in the system!
+// Each instance adds one, so identical instances (ie.: same sensor behind different mux ports) are counted too
 enum {
-  #define DEFINE_SENSOR_INSTANCE(type, address, channel, driver, multiplier, divider, offset, interval_ms) ______x##type##address##channel##driver,
+  NUM_SENSORS = 0
+  #define DEFINE_SENSOR_INSTANCE(type, address, channel, driver, multiplier, divider, offset, interval_ms, ...) + 1
   #include "sm_define_sensors.inc"
-  NUM_SENSORS
 };
 
 typedef struct {
@@ -37,8 +97,78 @@ typedef void (* sm_callback)(sm_handle,  uint8_t * , uint16_t);
 typedef struct {
   sm_handle handle;
   int32_t data;
+  uint32_t sequence;        // per instance sample number, see sm_sequence_check
 } sm_sensor_data;
 
+// Statistics of one aggregation window, all values use the same unit as the raw sensor data
+typedef struct {
+  int32_t min;
+  int32_t max;
+  int32_t mean;
+  int32_t stddev;
+  int32_t last;
+  uint32_t count;
+} sm_aggregate;
+
+typedef struct {
+  sm_handle handle;
+  uint32_t sequence;
+  sm_aggregate aggregate;
+} sm_aggregate_data;
+
+// Counters of the RTOS sample queues, see SM_CFG_QUEUE_OVERFLOW
+typedef struct {
+  uint32_t sent;            // samples and window statistics queued
+  uint32_t dropped;         // lost because a queue was full (the new or the oldest sample, depending on the policy)
+  uint32_t coalesced;       // waiting samples replaced by a newer sample of the same instance (SM_QUEUE_COALESCE)
+  uint16_t backlog;         // instances with a sample waiting for room (SM_QUEUE_COALESCE)
+} sm_queue_stats;
+
+// Time spent in a driver FSM, the FSM of each driver runs once per sm_run() call
+typedef struct {
+  uint32_t calls;
+  uint32_t last_us;
+  uint32_t max_us;
+  uint64_t total_us;
+} sm_driver_stats;
+
+// Error and recovery counters of a sensor instance
+typedef struct {
+  uint32_t errors;          // read errors
+  uint32_t recoveries;      // number of times the sensor was reset, closed and opened again
+  uint32_t backoff_ms;      // delay before the next recovery
+} sm_recovery_stats;
+
+// A released set of group samples, the member samples were published just before
+typedef struct {
+  sm_group group;
+  uint32_t timestamp;       // time of the group trigger (milliseconds)
+  uint16_t members;         // instances in the group
+  uint16_t complete;        // members that returned valid data, the others are missing from the set
+  uint32_t skew_us;         // time between the first and the last read of the set
+} sm_group_set;
+
+typedef void (* sm_group_callback)(sm_group_set const * set);
+
+// Acquisition statistics of a group
+typedef struct {
+  uint32_t sets;            // sets released
+  uint32_t timeouts;        // sets released by the timeout with members still missing
+  uint32_t last_skew_us;
+  uint32_t max_skew_us;
+} sm_group_stats;
+
+// Consumer side loss detection for the samples of one sensor instance. Each instance numbers its published samples
+// 1, 2, 3... so a jump in the sequence means samples were lost between SM and the consumer (queue full, sample
+// replaced before its callback ran, transport loss...). Must be zero initialized
+typedef struct {
+  uint32_t next;            // next expected sequence number, 0 before the first sample
+  uint32_t received;        // samples received
+  uint32_t gaps;            // number of jumps in the sequence
+  uint32_t lost;            // total number of samples missing
+  uint32_t reordered;       // samples received after a newer one
+} sm_sequence_tracker;
+
 /************************************************************************
   Sensor Manager - Application interface
 ************************************************************************/
@@ -62,16 +192,17 @@ void sm_run(void);
  ***********************************************************************************************************************/
 uint16_t sm_get_total_sensor_count(void);
 /*******************************************************************************************************************//**
- * @brief       Get a handle for a sensor of a specific type. This function makes use of an internal variable
- *              to keep track of the sensor indexing. Each call returns the next handle for that sensor type
- *              until no more handles are found and an INVALID_HANDLE is returned.
+ * @brief       Get a handle for a sensor of a specific type. Each call returns the next handle for that sensor type
+ *              until no more handles are found and an INVALID_HANDLE is returned. Sensors disabled by discovery
+ *              (SM_PROBE) are skipped.
  *              A call to this function with a different type is only allowed following a sm_init call or once an
  *              INVALID_HANDLE is returned.
  * @param[in]   sensor type
  * @param[out]  pointer to a handle
+ * @param[in]   pointer to an auxiliary variable for storing internal search index
  * @retval      0 if a valid handle is returned, -1 otherwise
  ***********************************************************************************************************************/
-int32_t sm_get_sensor_handle(sm_type type, sm_handle * handle);
+int32_t sm_get_sensor_handle(sm_type type, sm_handle * handle, uint16_t * index);
 /*******************************************************************************************************************//**
  * @brief       Get the sensor driver id
  * @param[in]   handle of the desired sensor
@@ -99,7 +230,8 @@ void sm_get_sensor_scaling(sm_handle handle, sm_scaling *scaling);
  ***********************************************************************************************************************/
 sm_type sm_get_sensor_type_by_handle(sm_handle handle);
 /*******************************************************************************************************************//**
- * @brief       Register a callback to be used by the sensor specified by the handle
+ * @brief       Register a callback to be used by the sensor specified by the handle. The callback receives an int32_t
+ *              sample, or an sm_aggregate record (size = sizeof(sm_aggregate)) if the instance uses SM_WINDOW
  * @param[in]   handle of the desired sensor
  * @param[in]   function pointer to the desired callback (using sm_callback type)
  * @retval      none
@@ -143,7 +275,17 @@ const char * sm_get_sensor_path_by_type(sm_type type);
  ***********************************************************************************************************************/
 const char * sm_get_sensor_path_by_handle(sm_handle handle);
 /*******************************************************************************************************************//**
- * @brief       Set a sensor attribute
+ * @brief       Get the handle of a sensor from its full path, as published: "/<type path>/<driver id>"
+ *              (ie.: "/methane-gas/tgs6810_sensor"). The leading '/' is optional. If several instances share the
+ *              path, the first declared one is returned. Constant time with SM_CFG_PATH_INDEX_ENABLE
+ * @param[in]   null terminated path
+ * @retval      handle of the sensor, invalid handle (value 0) if the path is unknown
+ ***********************************************************************************************************************/
+sm_handle sm_get_sensor_handle_by_path(const char * path);
+/*******************************************************************************************************************//**
+ * @brief       Set a sensor attribute. SM_ACQUISITION_INTERVAL is the SM sampling interval of the instance, for an
+ *              instance defined with interval 0 (read when its driver flags new data) it is the interval of the
+ *              driver, the result is the driver's (SM_NOT_SUPPORTED if the driver has no interval)
  * @param[in]   handle of the desired sensor
  * @param[in]   attribute that will be set
  * @param[in]   value to be assigned to the attribute
@@ -151,12 +293,118 @@ const char * sm_get_sensor_path_by_handle(sm_handle handle);
  ***********************************************************************************************************************/
 sm_result sm_set_sensor_attribute(sm_handle handle, sm_sensor_attributes attr, uint32_t value);
 /*******************************************************************************************************************//**
- * @brief       Get a sensor attribute
+ * @brief       Get a sensor attribute, SM_ACQUISITION_INTERVAL of an instance defined with interval 0 is read from
+ *              its driver
  * @param[in]   handle of the desired sensor
  * @param[in]   attribute that will be set
  * @param[in]   pointer to uint32_t that will store the value of the attribute
  * @retval      one of sm_result
  ***********************************************************************************************************************/
 sm_result sm_get_sensor_attribute(sm_handle handle, sm_sensor_attributes attr, uint32_t * value);
+/*******************************************************************************************************************//**
+ * @brief       Get the number of samples replaced by a newer sample before their callbacks were run
+ *              (SM_CFG_DEFERRED_DISPATCH only)
+ * @param[in]   none
+ * @retval      number of samples not delivered to the callbacks
+ ***********************************************************************************************************************/
+uint32_t sm_get_dispatch_drops(void);
+/*******************************************************************************************************************//**
+ * @brief       Get the counters of the sample queues (RTOS only)
+ * @param[out]  pointer to a variable to store the counters
+ * @retval      one of sm_result
+ ***********************************************************************************************************************/
+sm_result sm_get_queue_stats(sm_queue_stats * stats);
+/*******************************************************************************************************************//**
+ * @brief       Get the FSM timing of a driver (SM_CFG_FSM_TIMING_ENABLE only)
+ * @param[in]   driver (DRIVER_<name> as declared in sm_define_sensors.inc)
+ * @param[out]  pointer to a variable to store the statistics
+ * @retval      one of sm_result
+ ***********************************************************************************************************************/
+sm_result sm_get_driver_fsm_stats(sm_driver driver, sm_driver_stats * stats);
+/*******************************************************************************************************************//**
+ * @brief       Get the error and recovery counters of a sensor (SM_CFG_RECOVERY_ENABLE only)
+ * @param[in]   handle of the desired sensor
+ * @param[out]  pointer to a variable to store the counters
+ * @retval      one of sm_result
+ ***********************************************************************************************************************/
+sm_result sm_get_sensor_recovery_stats(sm_handle handle, sm_recovery_stats * stats);
+/*******************************************************************************************************************//**
+ * @brief       Get the index of a sensor, for applications keeping data per sensor
+ * @param[in]   handle of the desired sensor
+ * @retval      index from 0 to NUM_SENSORS-1, -1 if the handle is invalid
+ ***********************************************************************************************************************/
+int16_t sm_get_sensor_index(sm_handle handle);
+/*******************************************************************************************************************//**
+ * @brief       Get the sequence number of the sample passed to a callback, to be called from the callback.
+ *              Queue consumers (RTOS) and subscribers get it in sm_sensor_data / sm_sample
+ * @param[in]   handle of the sensor
+ * @retval      sequence number (first sample is 1), 0 if no sample was dispatched yet
+ ***********************************************************************************************************************/
+uint32_t sm_get_sample_sequence(sm_handle handle);
+/*******************************************************************************************************************//**
+ * @brief       Check the sequence number of a received sample and update the loss counters of the tracker
+ * @param[in]   pointer to the tracker of the sensor instance
+ * @param[in]   sequence number of the received sample
+ * @retval      number of samples missing just before this one
+ ***********************************************************************************************************************/
+uint32_t sm_sequence_check(sm_sequence_tracker * tracker, uint32_t sequence);
+/*******************************************************************************************************************//**
+ * @brief       Get the number of I2C mux port selections done by SM
+ * @param[in]   none
+ * @retval      number of calls to the <mux>_select() functions
+ ***********************************************************************************************************************/
+uint32_t sm_get_mux_switches(void);
+/*******************************************************************************************************************//**
+ * @brief       Register a function called from sm_run() context each time a set of group samples is released
+ *              (SM_CFG_GROUP_ENABLE only). With SM_CFG_DEFERRED_DISPATCH the sample callbacks of the members can
+ *              run after it, later in the same sm_run() call
+ * @param[in]   group (GROUP_<name> as declared in sm_define_sensors.inc)
+ * @param[in]   callback function, NULL to unregister
+ * @retval      one of sm_result
+ ***********************************************************************************************************************/
+sm_result sm_register_group_callback(sm_group group, sm_group_callback callback);
+/*******************************************************************************************************************//**
+ * @brief       Get the acquisition statistics of a group (SM_CFG_GROUP_ENABLE only)
+ * @param[in]   group (GROUP_<name> as declared in sm_define_sensors.inc)
+ * @param[out]  pointer to a variable to store the statistics
+ * @retval      one of sm_result
+ ***********************************************************************************************************************/
+sm_result sm_get_group_stats(sm_group group, sm_group_stats * stats);
+/*******************************************************************************************************************//**
+ * @brief       Save the attributes set with sm_set_sensor_attribute() in data flash (SM_CFG_CONFIG_ENABLE only).
+ *              Call it once after a set of changes (or each change is saved with SM_CFG_CONFIG_AUTOSAVE). The call
+ *              blocks while the flash is erased and written
+ * @param[in]   none
+ * @retval      one of sm_result
+ ***********************************************************************************************************************/
+sm_result sm_save_config(void);
+/*******************************************************************************************************************//**
+ * @brief       Erase the saved configuration, the default attributes are used after the next reset
+ *              (SM_CFG_CONFIG_ENABLE only)
+ * @param[in]   none
+ * @retval      one of sm_result
+ ***********************************************************************************************************************/
+sm_result sm_clear_config(void);
+/*******************************************************************************************************************//**
+ * @brief       Run SM in the calling RTOS thread, sm_init must be called first (SM_CFG_EVENT_DRIVEN only).
+ *              The thread only wakes up on sampling deadlines or when sm_wake is called. This function never returns
+ * @param[in]   none
+ * @retval      none
+ ***********************************************************************************************************************/
+void sm_task(void);
+/*******************************************************************************************************************//**
+ * @brief       Wake up the SM thread, drivers call it when data is ready or an I2C transfer completes.
+ *              It can be called from interrupt context. It does nothing unless SM_CFG_EVENT_DRIVEN is set
+ * @param[in]   none
+ * @retval      none
+ ***********************************************************************************************************************/
+void sm_wake(void);
+/*******************************************************************************************************************//**
+ * @brief       Called by a driver FSM that waits for some time, the FSM will run again after the delay.
+ *              The request is only valid for the current FSM call. It does nothing unless SM_CFG_EVENT_DRIVEN is set
+ * @param[in]   delay in milliseconds
+ * @retval      none
+ ***********************************************************************************************************************/
+void sm_wake_after(uint32_t delay);
 
 #endif
@@ -1,3 +1,8 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
 #ifndef __PUBLIC_HANDLE_H
 #define __PUBLIC_HANDLE_H
 
@@ -21,6 +26,7 @@ enum {
   SM_CH12, SM_CH13, SM_CH14, SM_CH15,
 };
 
+// The values are part of the interface of this application, SM_SENSOR_DATA_VALID stays 0
 typedef enum {
   SM_SENSOR_DATA_VALID,
   SM_SENSOR_STALE_DATA,
@@ -6,9 +6,9 @@
 * This file demonstrates a sensor implementation over I2C, it performs a direct read and the sensor
 * is expected to reply with data without the need of additional transactions (standard I2C transaction).
 * There are two channels: temperature (channel 0) and humidity (channel 1).
-* If a sensor needs multiple transactions to perform a read (ie.: one transaction to start the read and another
-* for retrieving data) then we recommend using a state machine to handle it. For details please refer t
-* hs3001_sensor_fsm() in hs3001_sensor.c.
+* Transfers are split-phase: the _start functions and dummy_read/dummy_write start a transfer and return,
+* dummy_transfer_status() tells its completion without waiting (see dummy_sensor_fsm() in dummy_sensor.c). The blocking
+* functions wait for it, they are only used out of the sampling.
 */
 /***********************************************************************************************************************
  * Includes
@@ -18,6 +18,8 @@
 #include "hal_data.h"
 #include "common_utils.h"
 #include "sm_handle.h"
+#include "sm.h"
+#include "i2c.h"
 #include "dummy_driver.h"
 #if BSP_CFG_RTOS
 #include <sensor_thread.h>
@@ -39,106 +41,310 @@
 #define NUM_CHANNELS            (2)
 // Sensor communication timeout
 #define SENSOR_DUMMY_TIMEOUT_MS (100)
+#if I2C_CFG_SCHEDULE_ENABLE
+// Priority of the sensor transactions in the queue of the I2C bus, 0 is the highest
+#define SENSOR_DUMMY_PRIORITY   (1)
+#endif
 
 /***********************************************************************************************************************
  * Private global variables
  **********************************************************************************************************************/
-#if (BSP_CFG_RTOS == 0)
-static bool g_comm_i2c_flag = false;
-static rm_comms_event_t g_comm_i2c_event;
+#if I2C_CFG_SCHEDULE_ENABLE
+static i2c_transaction g_dummy_transaction;
+#elif (BSP_CFG_RTOS == 0)
+static volatile bool g_comm_i2c_flag = false;
+static volatile rm_comms_event_t g_comm_i2c_event;
 #endif
+// Transfer started last, checked by dummy_transfer_status
+static bool g_dummy_pending = false;
+static uint32_t g_dummy_start;
+static fsp_err_t g_dummy_result = FSP_SUCCESS;
 
-fsp_err_t dummy_readReg(uint8_t reg, uint8_t *p_data) {
+// The pretend registers, remove them for a real sensor!
+static const uint8_t g_fake_registers[] = {
+    [DUMMY_TEMP_LO] = 0xC4, [DUMMY_TEMP_HI] = 0x09,     // 0x09C4 -> 2500 -> 25.00 degrees Celsius
+    [DUMMY_HUMI_LO] = 0x70, [DUMMY_HUMI_HI] = 0x17,     // 0x1770 -> 6000 -> 60.00% relative humidity
+};
+
+/*******************************************************************************************************************//**
+* @brief Start reading consecutive registers in one transaction: the start register is written, then all bytes are
+*        read (the sensor increments the register address after each byte). The call does not wait,
+*        dummy_transfer_status() tells when p_data is filled. p_data must stay valid until then.
+*
+* @retval FSP_SUCCESS              Successfully started.
+* @retval FSP_ERR_IN_USE           The bus is busy with another transfer, retry later.
+* @retval FSP_ERR_ABORTED          communication is aborted.
+**********************************************************************************************************************/
+fsp_err_t dummy_readRegs_start(uint8_t reg, uint8_t *p_data, uint8_t bytes) {
 	/******************** Example on how to read data from i2c *******************************************************************************/
+	static uint8_t start_reg;  // static, the transfer writes it after the return
 	rm_comms_write_read_params_t write_read_params;
-	write_read_params.p_src      = &reg;
+	start_reg = reg;
+	write_read_params.p_src      = &start_reg;
 	write_read_params.src_bytes  = 1;
 	write_read_params.p_dest     = p_data;
-	write_read_params.dest_bytes = 1;
+	write_read_params.dest_bytes = bytes;
 	//return dummy_read(write_read_params);  // Since there is no sensor, let's not try to read anything!
     // The following block is just for faking some registers readings, remove it for a real sensor!
     {
-        switch (reg) {
-            case DUMMY_TEMP_LO: *p_data = 0xC4; break;  // 0x09C4 -> 2500 -> 25.00 degrees Celsius
-            case DUMMY_TEMP_HI: *p_data = 0x09; break;
-            case DUMMY_HUMI_LO: *p_data = 0x70; break;  // 0x1770 -> 6000 -> 60.00% relative humidity
-            case DUMMY_HUMI_HI: *p_data = 0x17; break;
+        for (uint8_t i = 0; i < bytes; i++, reg++) {
+            p_data[i] = (reg < sizeof(g_fake_registers)) ? g_fake_registers[reg] : 0;
         }
         return FSP_SUCCESS;
     }
 }
 
-fsp_err_t dummy_writeReg(uint8_t reg, uint8_t data) {
+/*******************************************************************************************************************//**
+* @brief Start writing a register, dummy_transfer_status() tells when it completed.
+*
+* @retval FSP_SUCCESS              Successfully started.
+* @retval FSP_ERR_IN_USE           The bus is busy with another transfer, retry later.
+* @retval FSP_ERR_ABORTED          communication is aborted.
+**********************************************************************************************************************/
+fsp_err_t dummy_writeReg_start(uint8_t reg, uint8_t data) {
 	/******************** Example on how to write data to a specific register *******************************************************************************/
-	uint8_t write_data[2];
+	static uint8_t write_data[2];  // static, the transfer writes it after the return
 	write_data[0] = reg;
 	write_data[1] =  data;
 	//return dummy_write(write_data, sizeof(write_data));   // Since there is no sensor, let's not try to write anything!
+    FSP_PARAMETER_NOT_USED(write_data);
     return FSP_SUCCESS;
 }
 
+// Wait for the transfer started last. Only for the calls that may block (open, close and probe), the sampling is done
+// by dummy_sensor_fsm
+static fsp_err_t dummy_wait(fsp_err_t err) {
+    FSP_ERROR_RETURN(FSP_ERR_IN_USE != err, FSP_ERR_TIMEOUT);
+    FSP_ERROR_RETURN(FSP_SUCCESS == err, err);
+    while (FSP_ERR_IN_USE == (err = dummy_transfer_status())) {
+        utils_delay_us(100);
+    }
+    return err;
+}
+
+fsp_err_t dummy_readReg(uint8_t reg, uint8_t *p_data) {
+    return dummy_readRegs(reg, p_data, 1);
+}
+
+/*******************************************************************************************************************//**
+* @brief Read consecutive registers in one transaction and wait for it (see dummy_readRegs_start). Prefer it to one
+*        dummy_readReg per register, each of them is a full write-then-read transaction.
+*
+* @retval FSP_SUCCESS              Successfully read.
+* @retval FSP_ERR_TIMEOUT          communication is timeout.
+* @retval FSP_ERR_ABORTED          communication is aborted.
+**********************************************************************************************************************/
+fsp_err_t dummy_readRegs(uint8_t reg, uint8_t *p_data, uint8_t bytes) {
+    fsp_err_t err;
+    uint32_t since = utils_systime_get();
+    /* The bus may be busy with a transfer of another sensor (ie.: hs3001_sensor_fsm) */
+    while ((FSP_ERR_IN_USE == (err = dummy_readRegs_start(reg, p_data, bytes))) &&
+           (utils_systime_get() - since < SENSOR_DUMMY_TIMEOUT_MS)) {
+        utils_delay_us(100);
+    }
+    return dummy_wait(err);
+}
+
+fsp_err_t dummy_writeReg(uint8_t reg, uint8_t data) {
+    fsp_err_t err;
+    uint32_t since = utils_systime_get();
+    /* The bus may be busy with a transfer of another sensor (ie.: hs3001_sensor_fsm) */
+    while ((FSP_ERR_IN_USE == (err = dummy_writeReg_start(reg, data))) &&
+           (utils_systime_get() - since < SENSOR_DUMMY_TIMEOUT_MS)) {
+        utils_delay_us(100);
+    }
+    return dummy_wait(err);
+}
+
+/*******************************************************************************************************************//**
+* @brief Open the comms device of Sensor Dummy, the I2C bus must be initialized (see i2c_initialize).
+*
+* @retval FSP_SUCCESS              Successfully opened (or already open).
+* @retval Any Other Error code apart from FSP_SUCCESS  Unsuccessful open
+**********************************************************************************************************************/
+fsp_err_t dummy_open(void) {
+   fsp_err_t err = g_comms_i2c_dummy_sensor.p_api->open(g_comms_i2c_dummy_sensor.p_ctrl, g_comms_i2c_dummy_sensor.p_cfg);
+   return (FSP_ERR_ALREADY_OPEN == err) ? FSP_SUCCESS : err;
+}
+
+/*******************************************************************************************************************//**
+* @brief Close the comms device of Sensor Dummy.
+**********************************************************************************************************************/
+void dummy_close(void) {
+   g_comms_i2c_dummy_sensor.p_api->close(g_comms_i2c_dummy_sensor.p_ctrl);
+}
+
+// A transfer was started, its completion is checked by dummy_transfer_status
+static fsp_err_t dummy_started(fsp_err_t err) {
+   if (FSP_SUCCESS == err) {
+       g_dummy_start = utils_systime_get();
+       g_dummy_pending = true;
+   }
+   return err;
+}
+
+// A transfer is still in progress, the next one is refused as on a busy bus
+#define DUMMY_CHECK_IDLE()  FSP_ERROR_RETURN(!g_dummy_pending || (FSP_ERR_IN_USE != dummy_transfer_status()), FSP_ERR_IN_USE)
+
+#if I2C_CFG_SCHEDULE_ENABLE
+// Completion interrupt of the transactions of Sensor Dummy, the result is read by dummy_transfer_status
+static void dummy_transaction_callback(i2c_transaction * p_transaction) {
+   FSP_PARAMETER_NOT_USED(p_transaction);
+   // Let Sensor Manager run the FSM again
+   sm_wake();
+}
+
+/*******************************************************************************************************************//**
+* @brief Queue a transaction on the I2C bus, the transactions of other sensors with a higher priority go first.
+*
+* @retval FSP_SUCCESS              Successfully queued.
+* @retval FSP_ERR_IN_USE           The previous transaction is still in progress.
+**********************************************************************************************************************/
+static fsp_err_t dummy_transfer(i2c_transaction * p_transaction) {
+   DUMMY_CHECK_IDLE();
+   p_transaction->p_comms = &g_comms_i2c_dummy_sensor;
+   p_transaction->priority = SENSOR_DUMMY_PRIORITY;
+   p_transaction->p_callback = dummy_transaction_callback;
+   return dummy_started(i2c_submit(p_transaction));
+}
+
 /*******************************************************************************************************************//**
-* @brief Read data from Sensor Dummy device.
+* @brief Start reading data from Sensor Dummy device, see dummy_transfer_status.
 *
 * @retval FSP_SUCCESS              Successfully started.
+* @retval FSP_ERR_IN_USE           The previous transaction is still in progress.
+**********************************************************************************************************************/
+fsp_err_t dummy_read(rm_comms_write_read_params_t write_read_params) {
+   DUMMY_CHECK_IDLE();
+   g_dummy_transaction.type = I2C_TRANSACTION_WRITE_READ;
+   g_dummy_transaction.p_src = write_read_params.p_src;
+   g_dummy_transaction.src_bytes = write_read_params.src_bytes;
+   g_dummy_transaction.p_dest = write_read_params.p_dest;
+   g_dummy_transaction.dest_bytes = write_read_params.dest_bytes;
+   return dummy_transfer(&g_dummy_transaction);
+}
+
+/*******************************************************************************************************************//**
+* @brief Start writing data to Sensor Dummy device, see dummy_transfer_status.
+*
+* @retval FSP_SUCCESS              Successfully started.
+* @retval FSP_ERR_IN_USE           The previous transaction is still in progress.
+**********************************************************************************************************************/
+fsp_err_t dummy_write(uint8_t * const p_src, uint8_t const bytes) {
+   DUMMY_CHECK_IDLE();
+   g_dummy_transaction.type = I2C_TRANSACTION_WRITE;
+   g_dummy_transaction.p_src = p_src;
+   g_dummy_transaction.src_bytes = bytes;
+   return dummy_transfer(&g_dummy_transaction);
+}
+
+/*******************************************************************************************************************//**
+* @brief Check the transfer started last, it is aborted once SENSOR_DUMMY_TIMEOUT_MS elapsed. Never waits.
+*
+* @retval FSP_SUCCESS              Successfully completed (or no transfer started).
+* @retval FSP_ERR_IN_USE           In progress, check again later.
 * @retval FSP_ERR_TIMEOUT          communication is timeout.
 * @retval FSP_ERR_ABORTED          communication is aborted.
 **********************************************************************************************************************/
+fsp_err_t dummy_transfer_status(void) {
+   if (!g_dummy_pending) return g_dummy_result;
+   g_dummy_result = g_dummy_transaction.result;
+   if (FSP_ERR_IN_USE == g_dummy_result) {
+       if (utils_systime_get() - g_dummy_start < SENSOR_DUMMY_TIMEOUT_MS) return FSP_ERR_IN_USE;
+       fsp_err_t err = i2c_cancel(&g_dummy_transaction);
+       if (FSP_ERR_NOT_FOUND == err) {
+           // Completed meanwhile
+           g_dummy_result = g_dummy_transaction.result;
+       } else {
+           // Lost callback or bus held low, abort the transaction and free the bus
+           if (FSP_ERR_IN_USE == err) i2c_recover(&g_comms_i2c_dummy_sensor);
+           g_dummy_result = FSP_ERR_TIMEOUT;
+       }
+   }
+   g_dummy_pending = false;
+   return g_dummy_result;
+}
+
+#else
+/*******************************************************************************************************************//**
+* @brief Start reading data from Sensor Dummy device, see dummy_transfer_status.
+*
+* @retval FSP_SUCCESS              Successfully started.
+* @retval FSP_ERR_IN_USE           The bus is busy with a transfer of another sensor (ie.: hs3001_sensor_fsm).
+* @retval FSP_ERR_ABORTED          communication is aborted.
+**********************************************************************************************************************/
 fsp_err_t dummy_read(rm_comms_write_read_params_t write_read_params) {
-   fsp_err_t err = FSP_SUCCESS;
+   DUMMY_CHECK_IDLE();
+#if (BSP_CFG_RTOS == 0)
     g_comm_i2c_flag = false;
-   /* WriteRead data */
-   err = g_comms_i2c_dummy_sensor.p_api->writeRead(g_comms_i2c_dummy_sensor.p_ctrl, write_read_params);
-   FSP_ERROR_RETURN(FSP_SUCCESS == err, err);
-
+#endif
+   fsp_err_t err = g_comms_i2c_dummy_sensor.p_api->writeRead(g_comms_i2c_dummy_sensor.p_ctrl, write_read_params);
 #if (BSP_CFG_RTOS == 0)
-   uint32_t counter = 0;
-   /* Wait callback */
-   while (false == g_comm_i2c_flag) {
-       utils_delay_us(100);
-       counter++;
-       FSP_ERROR_RETURN((SENSOR_DUMMY_TIMEOUT_MS*10) < counter, FSP_ERR_TIMEOUT);
-   }
-   /* Check callback event */
-   FSP_ERROR_RETURN(RM_COMMS_EVENT_OPERATION_COMPLETE == g_comm_i2c_event, FSP_ERR_ABORTED);
+   return dummy_started(err);
+#else
+   // rm_comms returns once the transfer completed
+   g_dummy_result = err;
+   return err;
 #endif
-
-   return FSP_SUCCESS;
 }
 
 /*******************************************************************************************************************//**
-* @brief Write data to Sensor Dummy device.
+* @brief Start writing data to Sensor Dummy device, see dummy_transfer_status.
 *
 * @retval FSP_SUCCESS              Successfully started.
-* @retval FSP_ERR_TIMEOUT          communication is timeout.
+* @retval FSP_ERR_IN_USE           The bus is busy with a transfer of another sensor (ie.: hs3001_sensor_fsm).
 * @retval FSP_ERR_ABORTED          communication is aborted.
 **********************************************************************************************************************/
 fsp_err_t dummy_write(uint8_t * const p_src, uint8_t const bytes) {
-   fsp_err_t err = FSP_SUCCESS;
+   DUMMY_CHECK_IDLE();
+#if (BSP_CFG_RTOS == 0)
     g_comm_i2c_flag = false;
-   /* Write data */
-   err = g_comms_i2c_dummy_sensor.p_api->write(g_comms_i2c_dummy_sensor.p_ctrl, p_src, (uint32_t) bytes);
-   FSP_ERROR_RETURN(FSP_SUCCESS == err, err);
+#endif
+   fsp_err_t err = g_comms_i2c_dummy_sensor.p_api->write(g_comms_i2c_dummy_sensor.p_ctrl, p_src, (uint32_t) bytes);
 #if (BSP_CFG_RTOS == 0)
-   uint16_t counter = 0;
-   /* Wait callback */
-   while (false == g_comm_i2c_flag) {
-       utils_delay_us(100);
-       counter++;
-       FSP_ERROR_RETURN((SENSOR_DUMMY_TIMEOUT_MS*10) < counter, FSP_ERR_TIMEOUT);
-   }
-   /* Check callback event */
-   FSP_ERROR_RETURN(RM_COMMS_EVENT_OPERATION_COMPLETE == g_comm_i2c_event, FSP_ERR_ABORTED);
+   return dummy_started(err);
+#else
+   // rm_comms returns once the transfer completed
+   g_dummy_result = err;
+   return err;
 #endif
+}
 
-   return FSP_SUCCESS;
+/*******************************************************************************************************************//**
+* @brief Check the transfer started last, the bus is recovered once SENSOR_DUMMY_TIMEOUT_MS elapsed. Never waits.
+*
+* @retval FSP_SUCCESS              Successfully completed (or no transfer started).
+* @retval FSP_ERR_IN_USE           In progress, check again later.
+* @retval FSP_ERR_TIMEOUT          communication is timeout.
+* @retval FSP_ERR_ABORTED          communication is aborted.
+**********************************************************************************************************************/
+fsp_err_t dummy_transfer_status(void) {
+   if (!g_dummy_pending) return g_dummy_result;
+#if (BSP_CFG_RTOS == 0)
+   if (g_comm_i2c_flag) {
+       /* Check callback event */
+       g_dummy_result = (RM_COMMS_EVENT_OPERATION_COMPLETE == g_comm_i2c_event) ? FSP_SUCCESS : FSP_ERR_ABORTED;
+   } else if (utils_systime_get() - g_dummy_start < SENSOR_DUMMY_TIMEOUT_MS) {
+       return FSP_ERR_IN_USE;
+   } else {
+       // Lost callback or bus held low, abort the transfer and free the bus
+       i2c_recover(&g_comms_i2c_dummy_sensor);
+       g_dummy_result = FSP_ERR_TIMEOUT;
+   }
+#endif
+   g_dummy_pending = false;
+   return g_dummy_result;
 }
 
+#endif
+
 /*******************************************************************************************************************//**
  * @brief callback function called in the I2C Communications Middleware callback function.
+ * With I2C_CFG_SCHEDULE_ENABLE, the transfers of Sensor Dummy go through the queue of the I2C bus (see dummy_transfer),
+ * not its comms device.
  **********************************************************************************************************************/
 void dummy_sensor_callback(rm_comms_callback_args_t *p_args) {
-#if (BSP_CFG_RTOS > 0)
+#if I2C_CFG_SCHEDULE_ENABLE || (BSP_CFG_RTOS > 0)
     FSP_PARAMETER_NOT_USED(p_args);
 #else
 	/* Set event */
@@ -149,9 +355,12 @@ void dummy_sensor_callback(rm_comms_callback_args_t *p_args) {
             break;
         case RM_COMMS_EVENT_ERROR:
             g_comm_i2c_event = RM_COMMS_EVENT_ERROR;
+            g_comm_i2c_flag = true;
             break;
         default: 
             break;
 	}
+    // Let Sensor Manager run the FSM again
+    sm_wake();
 #endif
 }
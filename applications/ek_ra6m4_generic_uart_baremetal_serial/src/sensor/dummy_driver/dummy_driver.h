@@ -11,8 +11,16 @@
 #define DUMMY_HUMI_HI           (0x05)
 #define DUMMY_POWER_ON          (0x02)
 
+fsp_err_t dummy_open(void);
+void dummy_close(void);
+// Blocking, for open, close and probe
 fsp_err_t dummy_readReg(uint8_t reg, uint8_t *p_data);
+fsp_err_t dummy_readRegs(uint8_t reg, uint8_t *p_data, uint8_t bytes);
 fsp_err_t dummy_writeReg(uint8_t reg, uint8_t data);
+// Split-phase, the transfer is started and dummy_transfer_status() tells its completion
+fsp_err_t dummy_readRegs_start(uint8_t reg, uint8_t *p_data, uint8_t bytes);
+fsp_err_t dummy_writeReg_start(uint8_t reg, uint8_t data);
+fsp_err_t dummy_transfer_status(void);
 fsp_err_t dummy_read(rm_comms_write_read_params_t write_read_params);
 fsp_err_t dummy_write(uint8_t * const p_src, uint8_t const bytes);
 
@@ -5,10 +5,10 @@
 *
 * This file demonstrates a sensor implementation over I2C, it performs a direct read and the sensor
 * is expected to reply with data without the need of additional transactions (standard I2C transaction).
-* There are two channels: temperature (channel 0) and humidity (channel 1).
-* If a sensor needs multiple transactions to perform a read (ie.: one transaction to start the read and another
-* for retrieving data) then we recommend using a state machine to handle it. For details please refer to
-* hs3001_sensor_fsm() in hs3001_sensor.c.
+* There are two channels: temperature (channel 0) and humidity (channel 1), read together in one transaction.
+* The read is split-phase: dummy_sensor_fsm() starts the transfer and returns, the next passes of Sensor Manager
+* check its completion, so no call of Sensor Manager waits for the bus. Sensors that need more transactions per read
+* add states to the FSM, for details please refer to hs3001_sensor_fsm() in hs3001_sensor.c.
 */
 /***********************************************************************************************************************
  * Includes
@@ -18,6 +18,7 @@
 #include "hal_data.h"
 #include "common_utils.h"
 #include "sm_handle.h"
+#include "sm.h"
 #include "i2c.h"
 #include "dummy_driver.h"
 #include "dummy_sensor.h"
@@ -36,11 +37,36 @@
  **********************************************************************************************************************/
 // Number of sensor channels
 #define NUM_CHANNELS            (2)
+// Interval between each sample
+#define WAITING_INTERVAL_MS     (500)
+// Longest wait for the bus, each other sensor holds it for one transfer at most
+#define BUS_BUSY_TIMEOUT_MS     (40)
+// Period of the timeout checks while waiting for a transfer
+#define TRANSFER_CHECK_MS       (10)
+
+typedef enum {
+    SENSOR_POWER_ON,
+    SENSOR_POWER_ON_WAIT,
+    SENSOR_NEXT_SAMPLE,
+    SENSOR_WAIT_SAMPLE,
+    SENSOR_READ,
+    SENSOR_READ_WAIT
+} sstate;
 
 /***********************************************************************************************************************
  * Private global variables
  **********************************************************************************************************************/
 static uint8_t channels_open = 0;
+static bool powered = false;
+static sstate state;
+static uint32_t timer;
+static uint32_t acq_interval = WAITING_INTERVAL_MS;
+static bool bus_busy;
+static uint32_t bus_busy_since;             // first attempt on a bus used by another sensor
+static uint8_t regs[4];                     // DUMMY_TEMP_LO to DUMMY_HUMI_HI, filled by the burst read
+static int32_t values[NUM_CHANNELS];
+static sm_sensor_status status[NUM_CHANNELS];
+static uint8_t data_ready[NUM_CHANNELS];
 
 /***********************************************************************************************************************
  * Public Functions - these are called by Sensor Manager
@@ -51,49 +77,32 @@ static uint8_t channels_open = 0;
  * Note that this function is called by Sensor Manager, once for each channel
  **********************************************************************************************************************/
 void dummy_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
-    fsp_err_t status = FSP_SUCCESS;
-#if BSP_CFG_RTOS
-    /* Create a semaphore for blocking if a semaphore is not NULL */
-    if (NULL != g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore)
-    {
-#if BSP_CFG_RTOS == 1 // AzureOS
-        tx_semaphore_create(g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_handle,
-                            g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_name,
-                            (ULONG)0);
-#elif BSP_CFG_RTOS == 2 // FreeRTOS
-        *(g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_handle) = xSemaphoreCreateCountingStatic((UBaseType_t)1, (UBaseType_t)0, g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_memory);
-#endif
-    }
-
-    /* Create a recursive mutex for bus lock if a recursive mutex is not NULL */
-    if (NULL != g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex)
-    {
-#if BSP_CFG_RTOS == 1 // AzureOS
-        tx_mutex_create(g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_handle,
-                        g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_name,
-                        TX_INHERIT);
-#elif BSP_CFG_RTOS == 2 // FreeRTOS
-        *(g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_handle) = xSemaphoreCreateRecursiveMutexStatic(g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_memory);
-#endif
-    }
-#endif
+    fsp_err_t result = FSP_SUCCESS;
+    handle->address = address;
+    handle->channel = channel;
     if (0 == channels_open) {
-        status = i2c_initialize();
-        if (FSP_SUCCESS != status && FSP_ERR_ALREADY_OPEN != status) {
+        result = i2c_initialize();
+        if (FSP_SUCCESS != result && FSP_ERR_ALREADY_OPEN != result) {
+            // Sensor Manager recovers the channel, it has no flag
             log_error("I2C init failed");
-            APP_TRAP();
+            return;
         }
-        // Perform any one-time open operations required by the sensor driver here
-        status = dummy_writeReg(DUMMY_PWR_CTRL, DUMMY_POWER_ON);  // Turn on sensor
-        if (FSP_SUCCESS != status) {
-            log_error("Sensor init failed");
-            APP_TRAP();
+        result = dummy_open();
+        if (FSP_SUCCESS != result) {
+            log_error("Sensor comms open failed");
+            return;
+        }
+        // The one-time open operations required by the sensor are done by the FSM, the first sample follows them
+        powered = false;
+        bus_busy = false;
+        state = SENSOR_POWER_ON;
+        for (int ch = 0; ch < NUM_CHANNELS; ch++) {
+            status[ch] = SM_SENSOR_ERROR;
+            data_ready[ch] = 0;
         }
     }
     channels_open++;
     log_info("Sensor channel %d open success",channel);
-    handle->address = address;
-    handle->channel = channel;
 }
 
 /***********************************************************************************************************************
@@ -103,48 +112,188 @@ void dummy_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
 void dummy_sensor_close(sm_handle handle) {
     // Handle not used here
     FSP_PARAMETER_NOT_USED(handle);
-    fsp_err_t status = FSP_SUCCESS;
+    fsp_err_t result = FSP_SUCCESS;
     if (0 == channels_open) {
         log_error("Sensor not open");
     } else {
         channels_open--;
         if (0 == channels_open) {
-            // Perform any one-time close operations required by the sensor driver here
-            status = dummy_writeReg(DUMMY_PWR_CTRL, 0);  // Turn off sensor
-            if (FSP_SUCCESS != status) {
-                log_error("Sensor init failed");
-                APP_TRAP();
+            // Perform any one-time close operations required by the sensor driver here, after the transfer of the FSM
+            result = dummy_writeReg(DUMMY_PWR_CTRL, 0);  // Turn off sensor
+            if (FSP_SUCCESS != result) {
+                log_error("Sensor close failed");
             }
+            dummy_close();
         }
     }
 }
 
+/***********************************************************************************************************************
+ * @brief check if the sensor answers at an address
+ * Note that this function is called by Sensor Manager at init, for instances using the SM_PROBE option
+ **********************************************************************************************************************/
+sm_result dummy_sensor_probe(uint8_t address) {
+    uint8_t value;
+    // The comms device is bound to its configured address, the sensor can't answer at any other address
+    if (!i2c_is_device_address(&g_comms_i2c_dummy_sensor, address)) return SM_ERROR;
+    fsp_err_t result = i2c_initialize();
+    if (FSP_SUCCESS != result && FSP_ERR_ALREADY_OPEN != result) return SM_ERROR;
+    if (FSP_SUCCESS != dummy_open()) return SM_ERROR;
+    // Any register read acknowledged by the device will do
+    result = dummy_readReg(DUMMY_PWR_CTRL, &value);
+    if (0 == channels_open) dummy_close();
+    return (FSP_SUCCESS == result) ? SM_OK : SM_ERROR;
+}
+
 /***********************************************************************************************************************
  * @brief read a sensor channel
- * Note that this function is called by Sensor Manager, once for each channel.
+ * Note that this function is called by Sensor Manager, once for each channel, when the FSM flagged it.
  * It is expected that this function does not block nor it adds long delays!
  **********************************************************************************************************************/
 sm_sensor_status dummy_sensor_read(sm_handle handle, int32_t * data) {
     log_debug("Sensor read channel %d", handle.channel);
-    sm_sensor_status status = SM_SENSOR_ERROR;
-    fsp_err_t result = FSP_SUCCESS;
+    sm_sensor_status result = SM_SENSOR_ERROR;
     *data = 0;
-    if (handle.channel == 0) {
-        uint8_t low, hi;
-        result = dummy_readReg(DUMMY_TEMP_LO, &low);
-        if (FSP_SUCCESS != result) return status;
-        result = dummy_readReg(DUMMY_TEMP_HI, &hi);
-        if (FSP_SUCCESS != result) return status;
-        *data =  (int32_t)(((uint32_t)hi) << 8 | (uint32_t)(low));
-        status = SM_SENSOR_DATA_VALID;
-    } else if (handle.channel == 1) {
-        uint8_t low, hi;
-        result = dummy_readReg(DUMMY_HUMI_LO, &low);
-        if (FSP_SUCCESS != result) return status;
-        result = dummy_readReg(DUMMY_HUMI_HI, &hi);
-        if (FSP_SUCCESS != result) return status;
-        *data =  (int32_t)(((uint32_t)hi) << 8 | (uint32_t)(low));
-        status = SM_SENSOR_DATA_VALID;
+    if (handle.channel < NUM_CHANNELS) {
+        *data = values[handle.channel];
+        result = status[handle.channel];
+        status[handle.channel] = SM_SENSOR_STALE_DATA;
+    }
+    return result;
+}
+
+void dummy_sensor_trigger(sm_handle handle) {
+    // Both channels share the read, a second trigger while reading is ignored
+    FSP_PARAMETER_NOT_USED(handle);
+    if ((0 < channels_open) && ((SENSOR_NEXT_SAMPLE == state) || (SENSOR_WAIT_SAMPLE == state))) {
+        state = powered ? SENSOR_READ : SENSOR_POWER_ON;
+    }
+}
+
+uint8_t * dummy_sensor_get_flag(sm_handle handle) {
+    if ((0 < channels_open) && (handle.channel < NUM_CHANNELS)) return &data_ready[handle.channel]; else return NULL;
+}
+
+sm_result dummy_sensor_set_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t value) {
+    // The channels share the acquisition interval
+    sm_result result = SM_ERROR;
+    if (handle.channel < NUM_CHANNELS) {
+        switch (attr) {
+            case SM_ACQUISITION_INTERVAL:
+                acq_interval = value;
+                result = SM_OK;
+                break;
+            default:
+                result = SM_NOT_SUPPORTED;
+        }
     }
-    return status;
-}
\ No newline at end of file
+    return result;
+}
+
+sm_result dummy_sensor_get_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t * value) {
+    // The channels share the acquisition interval
+    sm_result result = SM_ERROR;
+    if (handle.channel < NUM_CHANNELS) {
+        switch (attr) {
+            case SM_ACQUISITION_INTERVAL:
+                *value = acq_interval;
+                result = SM_OK;
+                break;
+            default:
+                result = SM_NOT_SUPPORTED;
+        }
+    }
+    return result;
+}
+
+// Flag both channels with a status, so Sensor Manager reads it (and recovers the sensor on errors)
+static void dummy_report(sm_sensor_status new_status) {
+    for (int ch = 0; ch < NUM_CHANNELS; ch++) {
+        status[ch] = new_status;
+        data_ready[ch] = 1;
+    }
+}
+
+// Start a transfer, a bus busy with another sensor is retried on the next run (its completion wakes SM up)
+static void dummy_start(fsp_err_t result, sstate next) {
+    if (FSP_ERR_IN_USE == result) {
+        if (!bus_busy) {
+            bus_busy = true;
+            bus_busy_since = utils_systime_get();
+            return;
+        }
+        if (utils_systime_get() - bus_busy_since < BUS_BUSY_TIMEOUT_MS) return;
+    }
+    bus_busy = false;
+    if (FSP_SUCCESS != result) {
+        log_error("Sensor transfer err %d", result);
+        dummy_report(SM_SENSOR_ERROR);
+        state = SENSOR_NEXT_SAMPLE;
+    } else {
+        state = next;
+    }
+}
+
+// Check the transfer started by dummy_start, the driver aborts it on timeout
+static bool dummy_transfer_done(void) {
+    fsp_err_t result = dummy_transfer_status();
+    if (FSP_ERR_IN_USE == result) return false;
+    if (FSP_SUCCESS == result) return true;
+    log_error("Sensor transfer err %d", result);
+    dummy_report(SM_SENSOR_ERROR);
+    state = SENSOR_NEXT_SAMPLE;
+    return false;
+}
+
+/***********************************************************************************************************************
+ * @brief run the FSM of the sensor
+ * Note that this function is called by Sensor Manager on each pass. Each call does one step and never waits
+ **********************************************************************************************************************/
+void dummy_sensor_fsm(void) {
+    if (0 == channels_open) return;
+    switch (state) {
+        case SENSOR_POWER_ON:
+            // Perform any one-time open operations required by the sensor driver here
+            dummy_start(dummy_writeReg_start(DUMMY_PWR_CTRL, DUMMY_POWER_ON), SENSOR_POWER_ON_WAIT);  // Turn on sensor
+            break;
+        case SENSOR_POWER_ON_WAIT:
+            if (dummy_transfer_done()) {
+                powered = true;
+                state = SENSOR_READ;
+            }
+            break;
+        case SENSOR_NEXT_SAMPLE:
+            timer = utils_systime_get();
+            state = SENSOR_WAIT_SAMPLE;
+            break;
+        case SENSOR_WAIT_SAMPLE:
+            // A sensor that failed to turn on tries again at each sample
+            if (utils_systime_get() - timer >= acq_interval) state = powered ? SENSOR_READ : SENSOR_POWER_ON;
+            break;
+        case SENSOR_READ:
+            // Each channel is its low and high registers, both channels are one burst
+            dummy_start(dummy_readRegs_start(DUMMY_TEMP_LO, regs, sizeof(regs)), SENSOR_READ_WAIT);
+            break;
+        case SENSOR_READ_WAIT:
+            if (dummy_transfer_done()) {
+                values[0] = (int32_t)(((uint32_t)regs[1]) << 8 | (uint32_t)(regs[0]));
+                values[1] = (int32_t)(((uint32_t)regs[3]) << 8 | (uint32_t)(regs[2]));
+                dummy_report(SM_SENSOR_DATA_VALID);
+                state = SENSOR_NEXT_SAMPLE;
+            }
+            break;
+        default:
+            state = SENSOR_NEXT_SAMPLE;
+            break;
+    }
+    // Tell Sensor Manager when the FSM needs to run again, completions call sm_wake()
+    uint32_t now = utils_systime_get();
+    if (SENSOR_WAIT_SAMPLE == state) {
+        sm_wake_after((now - timer < acq_interval) ? (acq_interval - (now - timer)) : 0);
+    } else if (bus_busy || (SENSOR_POWER_ON_WAIT == state) || (SENSOR_READ_WAIT == state)) {
+        // Completions wake SM up, the bus and transfer timeouts are checked otherwise
+        sm_wake_after(TRANSFER_CHECK_MS);
+    } else {
+        sm_wake_after(0);
+    }
+}
@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include "common_utils.h"
 #include "sm_handle.h"
+#include "sm.h"
 #include "i2c.h"
 #include "hs3001_sensor.h"
 #if BSP_CFG_RTOS
@@ -14,7 +15,6 @@
 //#include "log_info.h"
 //#include "log_debug.h"
 
-volatile bool hs300x_completed = false;
 #define G_SENSOR_TIMEOUT 10uL
 // Interval between each sample
 #define WAITING_INTERVAL_MS  1000
@@ -22,135 +22,242 @@ volatile bool hs300x_completed = false;
 #define MEASUREMENT_TIME_MS 35
 // Number of sensor channels
 #define NUM_CHANNELS 2
+// Maximum number of HS3001 sensors on the bus, one per distinct instance address (set in programming mode)
+#ifndef HS3001_MAX_DEVICES
+#define HS3001_MAX_DEVICES 4
+#endif
 
 typedef enum {
     SENSOR_NEXT_SAMPLE,
     SENSOR_WAIT_SAMPLE,
     SENSOR_MEASUREMENT_START,
+    SENSOR_MEASUREMENT_START_WAIT,
     SENSOR_MEASUREMENT_WAIT,
     SENSOR_READ,
+    SENSOR_READ_WAIT,
     SENSOR_CALCULATE
 } sstate;
 
-static uint8_t data_ready[2] = { 0 };
-static int32_t temperature = 0;
-static int32_t humidity = 0;
-static uint8_t channels_open = 0;
-static sm_sensor_status sensor_status[2] = {SM_SENSOR_ERROR};
-static uint32_t acq_interval = WAITING_INTERVAL_MS;
+// A sensor at one address, the one at the configured address uses g_hs300x_sensor0, others get their own copy
+typedef struct {
+    bool used;
+    uint8_t address;                        // 7-bit address, instances with address 0 use the configured one
+    uint8_t channels_open;
+    bool open;                              // the HS300X driver is open, its transfers are not started otherwise
+    sstate state;
+    uint32_t timer;
+    uint32_t acq_interval;
+    bool bus_busy;
+    uint32_t bus_busy_since;                // first attempt on a bus used by another device
+    volatile bool completed;
+    volatile rm_hs300x_event_t event;
+    int32_t temperature;
+    int32_t humidity;
+    rm_hs300x_raw_data_t raw_data;
+    sm_sensor_status status[NUM_CHANNELS];
+    uint8_t data_ready[NUM_CHANNELS];
+    rm_hs300x_instance_t instance;
+    rm_hs300x_instance_ctrl_t ctrl;
+    rm_hs300x_cfg_t cfg;
+    i2c_device comms;
+} hs3001_device;
+
+static hs3001_device devices[HS3001_MAX_DEVICES];
+
+static uint8_t hs3001_device_address(uint8_t address) {
+    return (0 == address) ? i2c_get_device_address(g_hs300x_sensor0.p_cfg->p_instance) : address;
+}
+
+static hs3001_device * hs3001_find_device(uint8_t address) {
+    address = hs3001_device_address(address);
+    for (int i = 0; i < HS3001_MAX_DEVICES; i++) {
+        if (devices[i].used && (address == devices[i].address)) return &devices[i];
+    }
+    return NULL;
+}
+
+static hs3001_device * hs3001_add_device(uint8_t address) {
+    for (int i = 0; i < HS3001_MAX_DEVICES; i++) {
+        hs3001_device * dev = &devices[i];
+        if (dev->used) continue;
+        memset(dev, 0, sizeof(hs3001_device));
+        dev->used = true;
+        dev->address = hs3001_device_address(address);
+        // The first measurement starts right away, following ones wait for the acquisition interval
+        dev->state = SENSOR_MEASUREMENT_START;
+        dev->acq_interval = WAITING_INTERVAL_MS;
+        for (int ch = 0; ch < NUM_CHANNELS; ch++) dev->status[ch] = SM_SENSOR_ERROR;
+        if (i2c_is_device_address(g_hs300x_sensor0.p_cfg->p_instance, dev->address)) {
+            dev->instance = g_hs300x_sensor0;
+        } else {
+            dev->cfg = *g_hs300x_sensor0.p_cfg;
+            dev->cfg.p_context = dev;
+            dev->cfg.p_instance = i2c_device_create(&dev->comms, g_hs300x_sensor0.p_cfg->p_instance, dev->address,
+                                                    rm_hs300x_callback, &dev->ctrl);
+            dev->instance.p_ctrl = &dev->ctrl;
+            dev->instance.p_cfg = &dev->cfg;
+            dev->instance.p_api = g_hs300x_sensor0.p_api;
+        }
+        return dev;
+    }
+    log_error("Too many hs3001 devices");
+    return NULL;
+}
+
+// A transfer timed out (lost callback or bus held low): the driver forgets it and the bus is recovered
+static void hs3001_recover(hs3001_device * dev) {
+    fsp_err_t status;
+    if (dev->open) dev->instance.p_api->close(dev->instance.p_ctrl);
+    status = i2c_recover(dev->instance.p_cfg->p_instance);
+    if (FSP_SUCCESS != status) {
+        log_error("hs3001 0x%x bus recovery err %d", dev->address, status);
+    }
+    status = dev->instance.p_api->open(dev->instance.p_ctrl, dev->instance.p_cfg);
+    dev->open = (FSP_SUCCESS == status);
+    if (FSP_SUCCESS != status) {
+        log_error("hs3001 0x%x reopen err %d", dev->address, status);
+    }
+}
 
-static fsp_err_t i2c_waiting(void) {
+// Wait for the end of a transfer, only used by the probe (sm_init)
+static fsp_err_t i2c_waiting(hs3001_device * dev) {
     fsp_err_t err = FSP_SUCCESS;
-    static uint32_t sample_time;
+    uint32_t sample_time;
 
     sample_time = utils_systime_get();
-    while (!hs300x_completed && (utils_systime_get() - sample_time < G_SENSOR_TIMEOUT)) {}
-    if (utils_systime_get() - sample_time>= G_SENSOR_TIMEOUT) {
+    while (!dev->completed && (utils_systime_get() - sample_time < G_SENSOR_TIMEOUT)) {}
+    if (!dev->completed) {
         err = FSP_ERR_TIMEOUT;
+        hs3001_recover(dev);
+    } else if (RM_HS300X_EVENT_SUCCESS != dev->event) {
+        err = FSP_ERR_INVALID_HW_CONDITION;
     }
-    hs300x_completed = false;
+    dev->completed = false;
     return err;
 }
 
 void hs300x_callback(rm_hs300x_callback_args_t * p_args) {
-    if (RM_HS300X_EVENT_SUCCESS == p_args->event) {
-        hs300x_completed = true;
+    // g_hs300x_sensor0 has no context (see configuration.xml), the other devices have their own
+    hs3001_device * dev = (hs3001_device *) p_args->p_context;
+    if (NULL == dev) {
+        for (int i = 0; i < HS3001_MAX_DEVICES; i++) {
+            if (devices[i].used && (g_hs300x_sensor0.p_ctrl == devices[i].instance.p_ctrl)) dev = &devices[i];
+        }
     }
+    if (NULL != dev) {
+        dev->event = p_args->event;
+        dev->completed = true;
+    }
+    // Let Sensor Manager run the FSM again
+    sm_wake();
+}
+
+static fsp_err_t hs3001_device_open(hs3001_device * dev) {
+    fsp_err_t status = i2c_initialize();
+    if (FSP_SUCCESS != status && FSP_ERR_ALREADY_OPEN != status) return status;
+    // Open HS300X sensor instance, this must be done before calling any HS300X API
+    status = dev->instance.p_api->open(dev->instance.p_ctrl, dev->instance.p_cfg);
+    return (FSP_ERR_ALREADY_OPEN == status) ? FSP_SUCCESS : status;
 }
 
 void hs3001_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
     fsp_err_t status = FSP_SUCCESS;
-#if BSP_CFG_RTOS
-    /* Create a semaphore for blocking if a semaphore is not NULL */
-    if (NULL != g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore)
-    {
-#if BSP_CFG_RTOS == 1 // AzureOS
-        tx_semaphore_create(g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_handle,
-                            g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_name,
-                            (ULONG)0);
-#elif BSP_CFG_RTOS == 2 // FreeRTOS
-        *(g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_handle) = xSemaphoreCreateCountingStatic((UBaseType_t)1, (UBaseType_t)0, g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_memory);
-#endif
-    }
-
-    /* Create a recursive mutex for bus lock if a recursive mutex is not NULL */
-    if (NULL != g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex)
-    {
-#if BSP_CFG_RTOS == 1 // AzureOS
-        tx_mutex_create(g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_handle,
-                        g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_name,
-                        TX_INHERIT);
-#elif BSP_CFG_RTOS == 2 // FreeRTOS
-        *(g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_handle) = xSemaphoreCreateRecursiveMutexStatic(g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_memory);
-#endif
-    }
-#endif
-    if (0 == channels_open) {
-        status = i2c_initialize();
-        if (FSP_SUCCESS != status && FSP_ERR_ALREADY_OPEN != status) {
-            log_error("I2C init failed");
-            APP_TRAP();
-        }
-        // Open HS300X sensor instance, this must be done before calling any HS300X API
-        status = g_hs300x_sensor0.p_api->open(g_hs300x_sensor0.p_ctrl, g_hs300x_sensor0.p_cfg);
-        if(FSP_SUCCESS != status && FSP_ERR_ALREADY_OPEN != status) {
-            // Do something in case of error
+    hs3001_device * dev;
+    handle->address = address;
+    handle->channel = channel;
+    dev = hs3001_find_device(address);
+    if (NULL == dev) dev = hs3001_add_device(address);
+    if (NULL == dev) return;
+    if (0 == dev->channels_open) {
+        status = hs3001_device_open(dev);
+        dev->open = (FSP_SUCCESS == status);
+        if (FSP_SUCCESS != status) {
+            // The device keeps its channels, its FSM reports the error on each of them until Sensor Manager
+            // recovers them
             log_error("Sensor open err %d", status);
-            APP_TRAP();
         }
     }
-    channels_open++;
-    log_info("Sensor channel %d open success",channel);
-    handle->address = address;
-    handle->channel = channel;
+    dev->channels_open++;
+    if (dev->open) {
+        log_info("Sensor 0x%x channel %d open success", dev->address, channel);
+    }
 }
 
 void hs3001_sensor_close(sm_handle handle) {
-    // Handle not used here
-    FSP_PARAMETER_NOT_USED(handle);
     fsp_err_t status = FSP_SUCCESS;
-    if (0 == channels_open) {
+    hs3001_device * dev = hs3001_find_device(handle.address);
+    if ((NULL == dev) || (0 == dev->channels_open)) {
         log_error("Sensor not open");
     } else {
-        channels_open--;
-        if (0 == channels_open) {
-            status = g_hs300x_sensor0.p_api->close(g_hs300x_sensor0.p_ctrl);
+        dev->channels_open--;
+        if (0 == dev->channels_open) {
+            if (dev->open) status = dev->instance.p_api->close(dev->instance.p_ctrl);
             if(FSP_SUCCESS != status) {
-                // Do something in case of error
                 log_error("Sensor close err %d", status);
-                APP_TRAP();
             }
+            dev->used = false;
         }
     }
 }
 
+sm_result hs3001_sensor_probe(uint8_t address) {
+    fsp_err_t status = FSP_SUCCESS;
+    sm_result result = SM_ERROR;
+    hs3001_device * dev = hs3001_find_device(address);
+    // An address already in use answered before
+    if (NULL != dev) return SM_OK;
+    dev = hs3001_add_device(address);
+    if (NULL == dev) return SM_ERROR;
+    if (FSP_SUCCESS == hs3001_device_open(dev)) {
+        // The sensor is present if it acknowledges a measurement request
+        dev->completed = false;
+        status = dev->instance.p_api->measurementStart(dev->instance.p_ctrl);
+        if ((FSP_SUCCESS == status) && (FSP_SUCCESS == i2c_waiting(dev))) result = SM_OK;
+        dev->instance.p_api->close(dev->instance.p_ctrl);
+    }
+    dev->used = false;
+    return result;
+}
+
 sm_sensor_status hs3001_sensor_read(sm_handle handle, int32_t * data) {
     log_debug("Sensor read channel %d", handle.channel);
     sm_sensor_status status = SM_SENSOR_ERROR;
+    hs3001_device * dev = hs3001_find_device(handle.address);
+    if (NULL == dev) return status;
     if (handle.channel == 0) {
-        status = sensor_status[0];
-        *data =  (int32_t)temperature;
-        sensor_status[0] = SM_SENSOR_STALE_DATA;
+        status = dev->status[0];
+        *data =  dev->temperature;
+        dev->status[0] = SM_SENSOR_STALE_DATA;
     } else if (handle.channel == 1) {
-        status = sensor_status[1];
-        *data =  (int32_t)humidity;
-        sensor_status[1] = SM_SENSOR_STALE_DATA;
+        status = dev->status[1];
+        *data =  dev->humidity;
+        dev->status[1] = SM_SENSOR_STALE_DATA;
     }
     return status;
 }
 
+void hs3001_sensor_trigger(sm_handle handle) {
+    // Both channels share the measurement, a second trigger while measuring is ignored
+    hs3001_device * dev = hs3001_find_device(handle.address);
+    if ((NULL != dev) && ((SENSOR_NEXT_SAMPLE == dev->state) || (SENSOR_WAIT_SAMPLE == dev->state))) {
+        dev->state = SENSOR_MEASUREMENT_START;
+    }
+}
+
 uint8_t * hs3001_sensor_get_flag(sm_handle handle) {
-    if (handle.channel < NUM_CHANNELS) return &data_ready[handle.channel]; else return NULL;
+    hs3001_device * dev = hs3001_find_device(handle.address);
+    if ((NULL != dev) && (handle.channel < NUM_CHANNELS)) return &dev->data_ready[handle.channel]; else return NULL;
 }
 
 sm_result hs3001_sensor_set_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t value) {
-	FSP_PARAMETER_NOT_USED(handle);	// HS3001 can't set attributes per channel
+    // HS3001 can't set attributes per channel
     sm_result result = SM_ERROR;
-    if (handle.channel < NUM_CHANNELS) {
+    hs3001_device * dev = hs3001_find_device(handle.address);
+    if ((NULL != dev) && (handle.channel < NUM_CHANNELS)) {
     	switch (attr) {
 			case SM_ACQUISITION_INTERVAL:
 				if (value >= MEASUREMENT_TIME_MS) {
-					acq_interval = value;
+					dev->acq_interval = value;
 					result = SM_OK;
 				}
 				break;
@@ -162,12 +269,13 @@ sm_result hs3001_sensor_set_attr(sm_handle handle, sm_sensor_attributes attr, ui
 }
 
 sm_result hs3001_sensor_get_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t * value) {
-	FSP_PARAMETER_NOT_USED(handle);	// HS3001 can't get attributes per channel
+    // HS3001 can't get attributes per channel
     sm_result result = SM_ERROR;
-    if (handle.channel < NUM_CHANNELS) {
+    hs3001_device * dev = hs3001_find_device(handle.address);
+    if ((NULL != dev) && (handle.channel < NUM_CHANNELS)) {
     	switch (attr) {
 			case SM_ACQUISITION_INTERVAL:
-				*value = acq_interval;
+				*value = dev->acq_interval;
 				result = SM_OK;
 				break;
 			default:
@@ -177,79 +285,143 @@ sm_result hs3001_sensor_get_attr(sm_handle handle, sm_sensor_attributes attr, ui
     return result;
 }
 
-void hs3001_sensor_fsm(void) {
-    static uint32_t timer;
-    static sstate sensor_state;
-    static rm_hs300x_raw_data_t hs300x_raw_data;
-    static rm_hs300x_data_t data;
+// Flag both channels with an error, so Sensor Manager can recover the sensor
+static void hs3001_report_error(hs3001_device * dev) {
+    dev->status[0] = SM_SENSOR_ERROR;
+    dev->status[1] = SM_SENSOR_ERROR;
+    dev->data_ready[0] = 1;
+    dev->data_ready[1] = 1;
+}
+
+// Start a transfer, a bus busy with another device is retried on the next run (its completion wakes SM up)
+static void hs3001_start(hs3001_device * dev, fsp_err_t status, sstate next) {
+    if (FSP_ERR_IN_USE == status) {
+        if (!dev->bus_busy) {
+            dev->bus_busy = true;
+            dev->bus_busy_since = utils_systime_get();
+            return;
+        }
+        // Each other device holds the bus for one transfer at most, longer means a transfer is stuck
+        if (utils_systime_get() - dev->bus_busy_since < (G_SENSOR_TIMEOUT * HS3001_MAX_DEVICES)) return;
+        hs3001_recover(dev);
+    }
+    dev->bus_busy = false;
+    if (FSP_SUCCESS != status) {
+        log_error("hs3001 0x%x transfer err %d", dev->address, status);
+        hs3001_report_error(dev);
+        dev->state = SENSOR_NEXT_SAMPLE;
+    } else {
+        dev->timer = utils_systime_get();
+        dev->state = next;
+    }
+}
+
+// Wait for the end of a transfer started by hs3001_start, set by hs300x_callback
+static bool hs3001_transfer_done(hs3001_device * dev) {
+    if (dev->completed) {
+        dev->completed = false;
+        if (RM_HS300X_EVENT_SUCCESS == dev->event) return true;
+        log_error("hs3001 0x%x nack", dev->address);
+    } else if (utils_systime_get() - dev->timer >= G_SENSOR_TIMEOUT) {
+        log_error("hs3001 0x%x timeout", dev->address);
+        hs3001_recover(dev);
+    } else {
+        return false;
+    }
+    hs3001_report_error(dev);
+    dev->state = SENSOR_NEXT_SAMPLE;
+    return false;
+}
+
+// Run the FSM of a device, returns the time until it needs to run again. Each call does one step and never waits
+static uint32_t hs3001_device_fsm(hs3001_device * dev) {
+    rm_hs300x_data_t data;
     fsp_err_t status = FSP_SUCCESS;
-    switch (sensor_state) {
+    switch (dev->state) {
         case SENSOR_NEXT_SAMPLE:
-            timer = utils_systime_get();
-            sensor_state = SENSOR_WAIT_SAMPLE;
+            dev->timer = utils_systime_get();
+            dev->state = SENSOR_WAIT_SAMPLE;
             break;
         case SENSOR_WAIT_SAMPLE:
-            if (utils_systime_get() >= (timer + acq_interval)) sensor_state = SENSOR_MEASUREMENT_START;
+            if (utils_systime_get() >= (dev->timer + dev->acq_interval)) dev->state = SENSOR_MEASUREMENT_START;
             break;
         case SENSOR_MEASUREMENT_START:
             /* Start the measurement */
-            status = g_hs300x_sensor0.p_api->measurementStart(g_hs300x_sensor0.p_ctrl);
-            if(FSP_SUCCESS != status) {
-                log_error("Measurement start err %d", status);
-            }
-            status = i2c_waiting();
-            if(FSP_SUCCESS != status) {
-            	log_error("i2c waiting err %d", status);
-            } else {
-                sensor_state = SENSOR_MEASUREMENT_WAIT;
-                timer = utils_systime_get();
+            dev->completed = false;
+            // A device that failed to open reports the error at each measurement, until it is recovered
+            status = dev->open ? dev->instance.p_api->measurementStart(dev->instance.p_ctrl) : FSP_ERR_NOT_OPEN;
+            hs3001_start(dev, status, SENSOR_MEASUREMENT_START_WAIT);
+            break;
+        case SENSOR_MEASUREMENT_START_WAIT:
+            if (hs3001_transfer_done(dev)) {
+                dev->state = SENSOR_MEASUREMENT_WAIT;
+                dev->timer = utils_systime_get();
             }
             break;
         case SENSOR_MEASUREMENT_WAIT:
-            /* Wait for the sensor to complete the measurement */
-            if (utils_systime_get() >= (timer + MEASUREMENT_TIME_MS)) sensor_state = SENSOR_READ;
+            /* Wait for the sensor to complete the measurement, the other devices use the bus meanwhile.
+               The tick may come right after the start, one more tick guarantees the wait (no stale read) */
+            if (utils_systime_get() > (dev->timer + MEASUREMENT_TIME_MS)) dev->state = SENSOR_READ;
             break;
         case SENSOR_READ:
             /* Read ADC data from HS300X sensor */
-            status = g_hs300x_sensor0.p_api->read(g_hs300x_sensor0.p_ctrl, &hs300x_raw_data);
-            if(FSP_SUCCESS != status) {
-                log_error("Read err %d", status);
-            }
-            status = i2c_waiting();
-            if(FSP_SUCCESS != status) {
-            	log_error("i2c waiting err %d", status);
-                sensor_state = SENSOR_MEASUREMENT_START;
-            } else {
-                sensor_state = SENSOR_CALCULATE;
-            }
+            dev->completed = false;
+            hs3001_start(dev, dev->instance.p_api->read(dev->instance.p_ctrl, &dev->raw_data), SENSOR_READ_WAIT);
+            break;
+        case SENSOR_READ_WAIT:
+            if (hs3001_transfer_done(dev)) dev->state = SENSOR_CALCULATE;
             break;
         case SENSOR_CALCULATE:
             /* Calculate humidity and temperature values from ADC data */
-            status = g_hs300x_sensor0.p_api->dataCalculate(g_hs300x_sensor0.p_ctrl, &hs300x_raw_data, &data);
+            status = dev->instance.p_api->dataCalculate(dev->instance.p_ctrl, &dev->raw_data, &data);
             if (FSP_SUCCESS == status) {
-                data_ready[0] = 1;
-                data_ready[1] = 1;
-                temperature = data.temperature.integer_part*100 + data.temperature.decimal_part;
-                humidity = data.humidity.integer_part*100 + data.humidity.decimal_part;
-                sensor_status[0] = SM_SENSOR_DATA_VALID;
-                sensor_status[1] = SM_SENSOR_DATA_VALID;
-                sensor_state = SENSOR_NEXT_SAMPLE;
+                dev->data_ready[0] = 1;
+                dev->data_ready[1] = 1;
+                dev->temperature = data.temperature.integer_part*100 + data.temperature.decimal_part;
+                dev->humidity = data.humidity.integer_part*100 + data.humidity.decimal_part;
+                dev->status[0] = SM_SENSOR_DATA_VALID;
+                dev->status[1] = SM_SENSOR_DATA_VALID;
+                dev->state = SENSOR_NEXT_SAMPLE;
             }
             else if (FSP_ERR_SENSOR_INVALID_DATA == status) {
                 log_error("Invalid data");
-                sensor_status[0] = SM_SENSOR_INVALID_DATA;
-                sensor_status[1] = SM_SENSOR_INVALID_DATA;
-                sensor_state = SENSOR_READ;
+                dev->status[0] = SM_SENSOR_INVALID_DATA;
+                dev->status[1] = SM_SENSOR_INVALID_DATA;
+                dev->state = SENSOR_READ;
             } else {
                 log_error("DataCalculate err %d", status);
-                sensor_status[0] = SM_SENSOR_ERROR;
-                sensor_status[1] = SM_SENSOR_ERROR;
-                sensor_state = SENSOR_NEXT_SAMPLE;
+                dev->status[0] = SM_SENSOR_ERROR;
+                dev->status[1] = SM_SENSOR_ERROR;
+                dev->state = SENSOR_NEXT_SAMPLE;
             }
             break;
         default:
-            sensor_state = SENSOR_NEXT_SAMPLE;
+            dev->state = SENSOR_NEXT_SAMPLE;
             break;
     }
+    uint32_t now = utils_systime_get();
+    if (SENSOR_WAIT_SAMPLE == dev->state) {
+        return (now < dev->timer + dev->acq_interval) ? (dev->timer + dev->acq_interval - now) : 0;
+    } else if (SENSOR_MEASUREMENT_WAIT == dev->state) {
+        return (now <= dev->timer + MEASUREMENT_TIME_MS) ? (dev->timer + MEASUREMENT_TIME_MS + 1 - now) : 0;
+    } else if ((SENSOR_MEASUREMENT_START_WAIT == dev->state) || (SENSOR_READ_WAIT == dev->state)) {
+        // The completion wakes SM up, the timeout is checked otherwise
+        return (now - dev->timer < G_SENSOR_TIMEOUT) ? (G_SENSOR_TIMEOUT - (now - dev->timer)) : 0;
+    } else if (dev->bus_busy) {
+        // Waiting for the bus, the transfer of the other device wakes SM up
+        return G_SENSOR_TIMEOUT;
+    }
+    return 0;
 }
 
+void hs3001_sensor_fsm(void) {
+    // A device starts its measurement while another one converts, so the 35 ms conversions overlap
+    uint32_t next = UINT32_MAX;
+    for (int i = 0; i < HS3001_MAX_DEVICES; i++) {
+        if (!devices[i].used || (0 == devices[i].channels_open)) continue;
+        uint32_t wait = hs3001_device_fsm(&devices[i]);
+        if (wait < next) next = wait;
+    }
+    // Tell Sensor Manager when the FSM needs to run again, completions call sm_wake()
+    if (UINT32_MAX != next) sm_wake_after(next);
+}
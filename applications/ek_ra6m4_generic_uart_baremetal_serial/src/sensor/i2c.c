@@ -7,6 +7,9 @@
 #include <stdio.h>
 #include "common_utils.h"
 #include "i2c.h"
+#if BSP_CFG_RTOS
+#include <sensor_thread.h>
+#endif
 // Uncomment the desired debug level
 #include "log_disabled.h"
 //#include "log_error.h"
@@ -14,16 +17,713 @@
 //#include "log_info.h"
 //#include "log_debug.h"
 
-static bool init_done = false;
+// Half period of the clock pulses of a bus recovery (100 kHz)
+#define I2C_RECOVERY_HALF_PERIOD_US 5
+// A slave holding SDA low releases it within 9 clock pulses (8 data bits and the acknowledge)
+#define I2C_RECOVERY_CLOCKS         9
 
-fsp_err_t i2c_initialize(void) {
+#if I2C_CFG_TRACE_ENABLE
+#if (I2C_CFG_TRACE_DEPTH & (I2C_CFG_TRACE_DEPTH - 1)) != 0
+#error "I2C_CFG_TRACE_DEPTH must be a power of 2"
+#endif
+// The sequence numbers index the buffer of records with a mask
+#define I2C_TRACE_MASK              (I2C_CFG_TRACE_DEPTH - 1)
+// Devices of a bus in the exported statistics
+#define I2C_TRACE_MAX_DEVICES       (8)
+// Longest window of the statistics in DWT cycles, the age of a record is computed modulo 2^32
+#define I2C_TRACE_MAX_WINDOW        (0x80000000u)
+// Longest latency in the statistics (us), the latencies are sorted with the address in the top byte
+#define I2C_TRACE_MAX_LATENCY       (0x00FFFFFFu)
+// Longest exported line
+#define I2C_TRACE_LINE_SIZE         (96)
+
+// Tracer of a bus: rm_comms calls the driver through the instance of the tracer (i2c_trace_api), the completions
+// of the driver go through i2c_trace_callback before reaching the callback set by rm_comms
+typedef struct {
+    i2c_master_instance_t instance;
+    i2c_master_instance_t const * p_driver;
+    void (* p_callback)(i2c_master_callback_args_t * p_args);
+    void const * p_context;
+    // Transfer in progress
+    uint32_t start;
+    uint16_t bytes;
+    uint8_t address;
+    uint8_t flags;
+    volatile bool busy;
+} i2c_trace_bus;
+#endif
+
+#if I2C_CFG_SCHEDULE_ENABLE
+// User of a bus
+typedef enum {
+    I2C_OWNER_NONE,
+    I2C_OWNER_QUEUE,            // transaction of the queue (see i2c_submit)
+    I2C_OWNER_COMMS,            // transfer of an rm_comms device
+} i2c_owner;
+
+// Scheduler of a bus: rm_comms calls the driver through the instance of the scheduler (i2c_schedule_api), which
+// keeps the bus for the queue while transactions are waiting. The slave address and callback set by rm_comms (before
+// each transfer of another device, even when the bus is busy) are bound to a transfer of rm_comms when it starts
+typedef struct {
+    i2c_master_instance_t instance;
+    i2c_master_instance_t const * p_driver;     // driver or tracer of the bus
+    void (* p_comms_callback)(i2c_master_callback_args_t * p_args);
+    void const * p_comms_context;
+    void (* p_callback)(i2c_master_callback_args_t * p_args);   // of the transfer of rm_comms in progress
+    void const * p_context;
+    uint32_t comms_address;
+    i2c_master_addr_mode_t comms_addr_mode;
+    uint32_t address;                           // slave address of the driver
+    i2c_transaction * p_queue;                  // by priority, then submission
+    i2c_transaction * p_active;
+    volatile i2c_owner owner;
+    bool restart;                               // the transfer in progress ends with a repeated START
+    bool in_callback;                           // rm_comms may read after the repeated START of its writeRead
+    bool open;
+} i2c_schedule_bus;
+#endif
+
+// Registry of I2C buses, each bus is initialized once whatever the number of sensors (and channels) using it.
+// The SCL and SDA pins are used by the bus recovery (see configuration.xml, IIC1 on P512/P511)
+typedef struct {
+    rm_comms_i2c_bus_extended_cfg_t * p_bus;
+    bsp_io_port_pin_t scl;
+    bsp_io_port_pin_t sda;
+    bool init_done;
+#if I2C_CFG_SCHEDULE_ENABLE
+    i2c_schedule_bus sched;
+#endif
+#if I2C_CFG_TRACE_ENABLE
+    i2c_trace_bus trace;
+#endif
+} i2c_bus_entry;
+
+static i2c_bus_entry i2c_buses[] = {
+    {.p_bus = &g_comms_i2c_bus0_extended_cfg, .scl = BSP_IO_PORT_05_PIN_12, .sda = BSP_IO_PORT_05_PIN_11, .init_done = false},
+};
+
+#define I2C_NUM_BUSES (sizeof(i2c_buses)/sizeof(i2c_buses[0]))
+
+static i2c_bus_entry * i2c_find_bus(rm_comms_i2c_bus_extended_cfg_t const * p_bus) {
+    for (uint32_t i = 0; i < I2C_NUM_BUSES; i++) {
+        if (p_bus == i2c_buses[i].p_bus) return &i2c_buses[i];
+    }
+    return NULL;
+}
+
+#if I2C_CFG_TRACE_ENABLE
+// Ring buffer of the records, written without lock by the completions (interrupts) and the aborts (thread).
+// A writer reserves the next sequence number with an atomic increment, fills the slot and publishes it by writing
+// the slot sequence (sequence number + 1, 0 while being written) last. A reader keeps the copy of a slot only if the
+// slot sequence is the expected one before and after the copy
+static i2c_trace_record i2c_trace_records[I2C_CFG_TRACE_DEPTH];
+static uint32_t i2c_trace_head;     // next sequence number
+
+static i2c_bus_entry * i2c_trace_find(i2c_master_ctrl_t const * p_ctrl) {
+    for (uint32_t i = 0; i < I2C_NUM_BUSES; i++) {
+        if (p_ctrl == i2c_buses[i].trace.instance.p_ctrl) return &i2c_buses[i];
+    }
+    return NULL;
+}
+
+// Record the end of the transfer in progress, event 0 if it was aborted
+static void i2c_trace_push(i2c_bus_entry * p_entry, uint8_t event) {
+    i2c_trace_bus * p_trace = &p_entry->trace;
+    uint32_t end = DWT->CYCCNT;
+    uint32_t sequence = __atomic_fetch_add(&i2c_trace_head, 1, __ATOMIC_RELAXED);
+    i2c_trace_record * p_record = &i2c_trace_records[sequence & I2C_TRACE_MASK];
+    *(volatile uint32_t *) &p_record->sequence = 0;
+    __DMB();
+    p_record->start = p_trace->start;
+    p_record->duration = end - p_trace->start;
+    p_record->bytes = p_trace->bytes;
+    p_record->bus = (uint8_t) (p_entry - i2c_buses);
+    p_record->address = p_trace->address;
+    p_record->flags = p_trace->flags;
+    p_record->event = event;
+    __DMB();
+    *(volatile uint32_t *) &p_record->sequence = sequence + 1;
+    p_trace->busy = false;
+}
+
+// Copy the record of a sequence number, false if it is not published yet or overwritten
+static bool i2c_trace_copy(uint32_t sequence, i2c_trace_record * p_record) {
+    i2c_trace_record * p_slot = &i2c_trace_records[sequence & I2C_TRACE_MASK];
+    volatile uint32_t * p_published = &p_slot->sequence;
+    if ((sequence + 1) != *p_published) return false;
+    __DMB();
+    *p_record = *p_slot;
+    __DMB();
+    if ((sequence + 1) != *p_published) return false;
+    p_record->sequence = sequence;
+    return true;
+}
+
+static void i2c_trace_callback(i2c_master_callback_args_t * p_args) {
+    i2c_bus_entry * p_entry = (i2c_bus_entry *) p_args->p_context;
+    // Recorded before the callback of rm_comms, which can start the next transfer (ie.: the read of a writeRead)
+    if (p_entry->trace.busy) i2c_trace_push(p_entry, (uint8_t) p_args->event);
+    if (NULL != p_entry->trace.p_callback) {
+        i2c_master_callback_args_t args = *p_args;
+        args.p_context = p_entry->trace.p_context;
+        p_entry->trace.p_callback(&args);
+    }
+}
+
+static fsp_err_t i2c_trace_transfer(i2c_master_ctrl_t * const p_ctrl, uint8_t * const p_buffer, uint32_t const bytes,
+                                    bool const restart, uint8_t flags) {
+    fsp_err_t status;
+    i2c_trace_bus * p_trace = &i2c_trace_find(p_ctrl)->trace;
+    i2c_master_api_t const * p_api = p_trace->p_driver->p_api;
+    // Another transfer in progress is left to the driver (it refuses it), only the first one is traced
+    bool traced = !p_trace->busy;
+    if (traced) {
+        p_trace->flags = (uint8_t) (flags | (restart ? I2C_TRACE_FLAG_RESTART : 0));
+        p_trace->bytes = (uint16_t) bytes;
+        p_trace->busy = true;
+        p_trace->start = DWT->CYCCNT;
+    }
+    if (flags & I2C_TRACE_FLAG_READ) {
+        status = p_api->read(p_ctrl, p_buffer, bytes, restart);
+    } else {
+        status = p_api->write(p_ctrl, p_buffer, bytes, restart);
+    }
+    if (traced && (FSP_SUCCESS != status)) p_trace->busy = false;
+    return status;
+}
+
+static fsp_err_t i2c_trace_drv_open(i2c_master_ctrl_t * const p_ctrl, i2c_master_cfg_t const * const p_cfg) {
+    i2c_bus_entry * p_entry = i2c_trace_find(p_ctrl);
+    i2c_master_api_t const * p_api = p_entry->trace.p_driver->p_api;
+    fsp_err_t status = p_api->open(p_ctrl, p_cfg);
+    if (FSP_SUCCESS != status) return status;
+    p_entry->trace.busy = false;
+    p_entry->trace.address = (uint8_t) p_cfg->slave;
+    p_entry->trace.p_callback = p_cfg->p_callback;
+    p_entry->trace.p_context = p_cfg->p_context;
+    return p_api->callbackSet(p_ctrl, i2c_trace_callback, p_entry, NULL);
+}
+
+static fsp_err_t i2c_trace_drv_read(i2c_master_ctrl_t * const p_ctrl, uint8_t * const p_dest, uint32_t const bytes,
+                                    bool const restart) {
+    return i2c_trace_transfer(p_ctrl, p_dest, bytes, restart, I2C_TRACE_FLAG_READ);
+}
+
+static fsp_err_t i2c_trace_drv_write(i2c_master_ctrl_t * const p_ctrl, uint8_t * const p_src, uint32_t const bytes,
+                                     bool const restart) {
+    return i2c_trace_transfer(p_ctrl, p_src, bytes, restart, 0);
+}
+
+static fsp_err_t i2c_trace_drv_abort(i2c_master_ctrl_t * const p_ctrl) {
+    i2c_bus_entry * p_entry = i2c_trace_find(p_ctrl);
+    fsp_err_t status = p_entry->trace.p_driver->p_api->abort(p_ctrl);
+    // The callback of an aborted transfer is not called
+    if (p_entry->trace.busy) i2c_trace_push(p_entry, 0);
+    return status;
+}
+
+static fsp_err_t i2c_trace_drv_slave_address_set(i2c_master_ctrl_t * const p_ctrl, uint32_t const slave,
+                                                 i2c_master_addr_mode_t const addr_mode) {
+    i2c_bus_entry * p_entry = i2c_trace_find(p_ctrl);
+    p_entry->trace.address = (uint8_t) slave;
+    return p_entry->trace.p_driver->p_api->slaveAddressSet(p_ctrl, slave, addr_mode);
+}
+
+static fsp_err_t i2c_trace_drv_callback_set(i2c_master_ctrl_t * const p_ctrl,
+                                            void (* p_callback)(i2c_master_callback_args_t *),
+                                            void const * const p_context,
+                                            i2c_master_callback_args_t * const p_callback_memory) {
+    i2c_bus_entry * p_entry = i2c_trace_find(p_ctrl);
+    p_entry->trace.p_callback = p_callback;
+    p_entry->trace.p_context = p_context;
+    return p_entry->trace.p_driver->p_api->callbackSet(p_ctrl, i2c_trace_callback, p_entry, p_callback_memory);
+}
+
+static fsp_err_t i2c_trace_drv_status_get(i2c_master_ctrl_t * const p_ctrl, i2c_master_status_t * p_status) {
+    return i2c_trace_find(p_ctrl)->trace.p_driver->p_api->statusGet(p_ctrl, p_status);
+}
+
+static fsp_err_t i2c_trace_drv_close(i2c_master_ctrl_t * const p_ctrl) {
+    i2c_bus_entry * p_entry = i2c_trace_find(p_ctrl);
+    fsp_err_t status = p_entry->trace.p_driver->p_api->close(p_ctrl);
+    if (p_entry->trace.busy) i2c_trace_push(p_entry, 0);
+    return status;
+}
+
+static i2c_master_api_t const i2c_trace_api = {
+    .open = i2c_trace_drv_open,
+    .read = i2c_trace_drv_read,
+    .write = i2c_trace_drv_write,
+    .abort = i2c_trace_drv_abort,
+    .slaveAddressSet = i2c_trace_drv_slave_address_set,
+    .callbackSet = i2c_trace_drv_callback_set,
+    .statusGet = i2c_trace_drv_status_get,
+    .close = i2c_trace_drv_close,
+};
+
+// Route the driver calls of a bus through the tracer, the bus recovery and the rm_comms devices follow
+static void i2c_trace_install(i2c_bus_entry * p_entry) {
+    i2c_trace_bus * p_trace = &p_entry->trace;
+    if (NULL != p_trace->p_driver) return;
+    p_trace->p_driver = (i2c_master_instance_t const *) p_entry->p_bus->p_driver_instance;
+    p_trace->instance.p_ctrl = p_trace->p_driver->p_ctrl;
+    p_trace->instance.p_cfg = p_trace->p_driver->p_cfg;
+    p_trace->instance.p_api = &i2c_trace_api;
+    p_entry->p_bus->p_driver_instance = &p_trace->instance;
+    // Timestamps in DWT cycles
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t i2c_trace_read(uint32_t * p_sequence, i2c_trace_record * p_records, uint32_t max) {
+    uint32_t next = *p_sequence;
+    uint32_t count = 0;
+    while (count < max) {
+        uint32_t head = *(volatile uint32_t *) &i2c_trace_head;
+        // Skip the records overwritten since the previous read
+        if ((head - next) > I2C_CFG_TRACE_DEPTH) {
+            next = (head > I2C_CFG_TRACE_DEPTH) ? (head - I2C_CFG_TRACE_DEPTH) : 0;
+        }
+        if (next == head) break;
+        if (i2c_trace_copy(next, &p_records[count])) {
+            count++;
+            next++;
+        } else if ((*(volatile uint32_t *) &i2c_trace_head - next) <= I2C_CFG_TRACE_DEPTH) {
+            // Reserved by a writer that did not publish it yet, read it next time
+            break;
+        }
+    }
+    *p_sequence = next;
+    return count;
+}
+
+uint32_t i2c_trace_stats(rm_comms_i2c_bus_extended_cfg_t const * p_bus, uint32_t window_ms,
+                         i2c_trace_bus_stats * p_stats, i2c_trace_device_stats * p_devices, uint32_t max_devices) {
+    // Latency (us) of each transfer of the bus in the window, with the address in the top byte
+    uint32_t keys[I2C_CFG_TRACE_DEPTH];
+    uint32_t count = 0;
+    uint32_t devices = 0;
+    uint64_t busy = 0;
+    i2c_trace_record record;
+    memset(p_stats, 0, sizeof(*p_stats));
+    i2c_bus_entry * p_entry = i2c_find_bus(p_bus);
+    if (NULL == p_entry) return 0;
+    uint8_t bus = (uint8_t) (p_entry - i2c_buses);
+    uint32_t cycles_per_us = SystemCoreClock / 1000000;
+    uint64_t window_cycles = (uint64_t) window_ms * 1000 * cycles_per_us;
+    uint32_t window = (window_cycles > I2C_TRACE_MAX_WINDOW) ? I2C_TRACE_MAX_WINDOW : (uint32_t) window_cycles;
+    uint32_t head = *(volatile uint32_t *) &i2c_trace_head;
+    uint32_t oldest = (head > I2C_CFG_TRACE_DEPTH) ? (head - I2C_CFG_TRACE_DEPTH) : 0;
+    uint32_t now = DWT->CYCCNT;
+    bool first = true;
+    for (uint32_t sequence = oldest; sequence != head; sequence++) {
+        if (!i2c_trace_copy(sequence, &record)) continue;
+        // The bus activity before the oldest record is unknown once the buffer wrapped, the window starts there
+        if (first && (0 != oldest) && ((now - record.start) < window)) window = now - record.start;
+        first = false;
+        uint32_t end = record.start + record.duration;
+        if (((now - end) >= window) || (bus != record.bus)) continue;
+        // Only the part of the transfer inside the window
+        uint32_t from = now - window;
+        busy += ((record.start - from) <= (end - from)) ? record.duration : (end - from);
+        p_stats->transfers++;
+        if ((I2C_MASTER_EVENT_RX_COMPLETE != record.event) && (I2C_MASTER_EVENT_TX_COMPLETE != record.event)) {
+            p_stats->errors++;
+        }
+        uint32_t latency = record.duration / cycles_per_us;
+        if (latency > I2C_TRACE_MAX_LATENCY) latency = I2C_TRACE_MAX_LATENCY;
+        keys[count++] = ((uint32_t) record.address << 24) | latency;
+    }
+    p_stats->window_us = window / cycles_per_us;
+    p_stats->busy_us = (uint32_t) (busy / cycles_per_us);
+    p_stats->utilization = (0 == window) ? 0 : (uint16_t) ((busy * 1000) / window);
+    // Sorted by address then latency
+    for (uint32_t i = 1; i < count; i++) {
+        uint32_t key = keys[i];
+        uint32_t j = i;
+        for (; (j > 0) && (keys[j - 1] > key); j--) keys[j] = keys[j - 1];
+        keys[j] = key;
+    }
+    for (uint32_t i = 0; i < count; devices++) {
+        uint32_t n = 1;
+        while (((i + n) < count) && ((keys[i + n] >> 24) == (keys[i] >> 24))) n++;
+        if ((NULL != p_devices) && (devices < max_devices)) {
+            // Nearest rank percentiles
+            i2c_trace_device_stats * p_device = &p_devices[devices];
+            p_device->address = (uint8_t) (keys[i] >> 24);
+            p_device->transfers = (uint16_t) n;
+            p_device->p50_us = keys[i + (50 * n + 99) / 100 - 1] & I2C_TRACE_MAX_LATENCY;
+            p_device->p90_us = keys[i + (90 * n + 99) / 100 - 1] & I2C_TRACE_MAX_LATENCY;
+            p_device->p99_us = keys[i + (99 * n + 99) / 100 - 1] & I2C_TRACE_MAX_LATENCY;
+            p_device->max_us = keys[i + n - 1] & I2C_TRACE_MAX_LATENCY;
+        }
+        i += n;
+    }
+    return devices;
+}
+
+uint32_t i2c_trace_export(uint32_t * p_sequence, i2c_trace_write p_write) {
+    char line[I2C_TRACE_LINE_SIZE];
+    i2c_trace_record record;
+    uint32_t count = 0;
+    // Gaps in the sequence numbers are records lost
+    int length = snprintf(line, sizeof(line), "I2CCLK,%lu\r\n", SystemCoreClock);
+    p_write(line, (uint32_t) length);
+    while (1 == i2c_trace_read(p_sequence, &record, 1)) {
+        length = snprintf(line, sizeof(line), "I2C,%lu,%lu,%lu,%u,0x%02x,%c,%u,%u,%u\r\n", record.sequence,
+                          record.start, record.duration, record.bus, record.address,
+                          (record.flags & I2C_TRACE_FLAG_READ) ? 'R' : 'W',
+                          (record.flags & I2C_TRACE_FLAG_RESTART) ? 1 : 0, record.bytes, record.event);
+        p_write(line, (uint32_t) length);
+        count++;
+    }
+    return count;
+}
+
+void i2c_trace_export_stats(rm_comms_i2c_bus_extended_cfg_t const * p_bus, uint32_t window_ms,
+                            i2c_trace_write p_write) {
+    char line[I2C_TRACE_LINE_SIZE];
+    i2c_trace_bus_stats stats;
+    i2c_trace_device_stats devices[I2C_TRACE_MAX_DEVICES];
+    i2c_bus_entry * p_entry = i2c_find_bus(p_bus);
+    if (NULL == p_entry) return;
+    uint8_t bus = (uint8_t) (p_entry - i2c_buses);
+    uint32_t count = i2c_trace_stats(p_bus, window_ms, &stats, devices, I2C_TRACE_MAX_DEVICES);
+    if (count > I2C_TRACE_MAX_DEVICES) count = I2C_TRACE_MAX_DEVICES;
+    int length = snprintf(line, sizeof(line), "I2CBUS,%u,%lu,%lu,%lu,%lu,%u\r\n", bus, stats.window_us,
+                          stats.transfers, stats.errors, stats.busy_us, stats.utilization);
+    p_write(line, (uint32_t) length);
+    for (uint32_t i = 0; i < count; i++) {
+        length = snprintf(line, sizeof(line), "I2CDEV,%u,0x%02x,%u,%lu,%lu,%lu,%lu\r\n", bus, devices[i].address,
+                          devices[i].transfers, devices[i].p50_us, devices[i].p90_us, devices[i].p99_us,
+                          devices[i].max_us);
+        p_write(line, (uint32_t) length);
+    }
+}
+#endif
+
+#if I2C_CFG_SCHEDULE_ENABLE
+static i2c_bus_entry * i2c_schedule_find(i2c_master_ctrl_t const * p_ctrl) {
+    for (uint32_t i = 0; i < I2C_NUM_BUSES; i++) {
+        if (p_ctrl == i2c_buses[i].sched.instance.p_ctrl) return &i2c_buses[i];
+    }
+    return NULL;
+}
+
+static fsp_err_t i2c_schedule_address(i2c_schedule_bus * p_sched, uint32_t address,
+                                      i2c_master_addr_mode_t addr_mode) {
+    if (address == p_sched->address) return FSP_SUCCESS;
+    fsp_err_t status = p_sched->p_driver->p_api->slaveAddressSet(p_sched->instance.p_ctrl, address, addr_mode);
+    if (FSP_SUCCESS == status) p_sched->address = address;
+    return status;
+}
+
+static void i2c_schedule_complete(i2c_transaction * p_transaction, fsp_err_t result) {
+    p_transaction->result = result;
+    if (NULL != p_transaction->p_callback) p_transaction->p_callback(p_transaction);
+}
+
+static fsp_err_t i2c_schedule_start(i2c_schedule_bus * p_sched, i2c_transaction * p_transaction) {
+    i2c_master_cfg_t const * p_cfg = (i2c_master_cfg_t const *) p_transaction->p_comms->p_cfg->p_lower_level_cfg;
+    i2c_master_api_t const * p_api = p_sched->p_driver->p_api;
+    fsp_err_t status = i2c_schedule_address(p_sched, p_cfg->slave, p_cfg->addr_mode);
+    if (FSP_SUCCESS != status) return status;
+    p_sched->restart = (I2C_TRANSACTION_WRITE_READ == p_transaction->type);
+    if (I2C_TRANSACTION_READ == p_transaction->type) {
+        return p_api->read(p_sched->instance.p_ctrl, p_transaction->p_dest, p_transaction->dest_bytes, false);
+    }
+    return p_api->write(p_sched->instance.p_ctrl, p_transaction->p_src, p_transaction->src_bytes, p_sched->restart);
+}
+
+// Start the first transaction of the queue if the bus is free, from the completion interrupt or with the interrupts
+// disabled. A transaction refused by the driver gets its result at once, the ones with a callback are returned (linked
+// by p_next) for i2c_schedule_notify, called once the interrupts are enabled again
+static i2c_transaction * i2c_schedule_next(i2c_bus_entry * p_entry) {
+    i2c_schedule_bus * p_sched = &p_entry->sched;
+    i2c_transaction * p_refused = NULL;
+    i2c_transaction ** pp_refused = &p_refused;
+    while (p_sched->open && (I2C_OWNER_NONE == p_sched->owner) && (NULL != p_sched->p_queue)) {
+        i2c_transaction * p_transaction = p_sched->p_queue;
+        p_sched->p_queue = p_transaction->p_next;
+        p_sched->p_active = p_transaction;
+        p_sched->owner = I2C_OWNER_QUEUE;
+        fsp_err_t status = i2c_schedule_start(p_sched, p_transaction);
+        if (FSP_SUCCESS != status) {
+            p_sched->p_active = NULL;
+            p_sched->owner = I2C_OWNER_NONE;
+            p_sched->restart = false;
+            // FSP_ERR_IN_USE means in progress to the requester
+            p_transaction->result = (FSP_ERR_IN_USE == status) ? FSP_ERR_ABORTED : status;
+            if (NULL != p_transaction->p_callback) {
+                p_transaction->p_next = NULL;
+                *pp_refused = p_transaction;
+                pp_refused = &p_transaction->p_next;
+            }
+        }
+    }
+    return p_refused;
+}
+
+// Call the callbacks of the transactions refused by i2c_schedule_next, a callback may submit its transaction again
+static void i2c_schedule_notify(i2c_transaction * p_refused) {
+    while (NULL != p_refused) {
+        i2c_transaction * p_next = p_refused->p_next;
+        p_refused->p_callback(p_refused);
+        p_refused = p_next;
+    }
+}
+
+// Release the bus after an abort or a close, the transaction in progress completes as aborted
+static void i2c_schedule_release(i2c_schedule_bus * p_sched) {
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    i2c_transaction * p_transaction = p_sched->p_active;
+    p_sched->p_active = NULL;
+    p_sched->owner = I2C_OWNER_NONE;
+    p_sched->restart = false;
+    FSP_CRITICAL_SECTION_EXIT;
+    if (NULL != p_transaction) i2c_schedule_complete(p_transaction, FSP_ERR_ABORTED);
+}
+
+// Abort the transactions of the queue when the bus is closed for good
+static void i2c_schedule_flush(i2c_schedule_bus * p_sched) {
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    i2c_transaction * p_transaction = p_sched->p_queue;
+    p_sched->p_queue = NULL;
+    FSP_CRITICAL_SECTION_EXIT;
+    while (NULL != p_transaction) {
+        i2c_transaction * p_next = p_transaction->p_next;
+        i2c_schedule_complete(p_transaction, FSP_ERR_ABORTED);
+        p_transaction = p_next;
+    }
+}
+
+static void i2c_schedule_callback(i2c_master_callback_args_t * p_args) {
+    i2c_bus_entry * p_entry = (i2c_bus_entry *) p_args->p_context;
+    i2c_schedule_bus * p_sched = &p_entry->sched;
+    if (I2C_OWNER_COMMS == p_sched->owner) {
+        // The bus stays with rm_comms only for the read of its writeRead, started by its callback
+        bool hold = p_sched->restart && (I2C_MASTER_EVENT_TX_COMPLETE == p_args->event);
+        if (!hold) {
+            p_sched->owner = I2C_OWNER_NONE;
+            p_sched->restart = false;
+            i2c_schedule_notify(i2c_schedule_next(p_entry));
+        }
+        p_sched->in_callback = hold;
+        if (NULL != p_sched->p_callback) {
+            i2c_master_callback_args_t args = *p_args;
+            args.p_context = p_sched->p_context;
+            p_sched->p_callback(&args);
+        }
+        if (p_sched->in_callback) {
+            // No read followed
+            p_sched->in_callback = false;
+            p_sched->owner = I2C_OWNER_NONE;
+            p_sched->restart = false;
+            i2c_schedule_notify(i2c_schedule_next(p_entry));
+        }
+        return;
+    }
+    i2c_transaction * p_transaction = p_sched->p_active;
+    if ((I2C_OWNER_QUEUE != p_sched->owner) || (NULL == p_transaction)) return;
+    fsp_err_t result = (I2C_MASTER_EVENT_ABORTED == p_args->event) ? FSP_ERR_ABORTED : FSP_SUCCESS;
+    if (p_sched->restart && (FSP_SUCCESS == result)) {
+        p_sched->restart = false;
+        result = p_sched->p_driver->p_api->read(p_sched->instance.p_ctrl, p_transaction->p_dest,
+                                                p_transaction->dest_bytes, false);
+        if (FSP_SUCCESS == result) return;
+    }
+    p_sched->p_active = NULL;
+    p_sched->owner = I2C_OWNER_NONE;
+    p_sched->restart = false;
+    // The next transaction starts before the callback of this one
+    i2c_transaction * p_refused = i2c_schedule_next(p_entry);
+    i2c_schedule_complete(p_transaction, result);
+    i2c_schedule_notify(p_refused);
+}
+
+static fsp_err_t i2c_schedule_transfer(i2c_master_ctrl_t * const p_ctrl, uint8_t * const p_buffer,
+                                       uint32_t const bytes, bool const restart, bool read) {
+    i2c_schedule_bus * p_sched = &i2c_schedule_find(p_ctrl)->sched;
+    i2c_master_api_t const * p_api = p_sched->p_driver->p_api;
+    fsp_err_t status = FSP_ERR_IN_USE;
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    // A free bus, or the read of a writeRead from the callback of its write (same device and callback)
+    bool continuation = (I2C_OWNER_COMMS == p_sched->owner) && p_sched->in_callback;
+    if ((I2C_OWNER_NONE == p_sched->owner) || continuation) {
+        p_sched->in_callback = false;
+        status = continuation ? FSP_SUCCESS :
+                 i2c_schedule_address(p_sched, p_sched->comms_address, p_sched->comms_addr_mode);
+        if (FSP_SUCCESS == status) {
+            if (!continuation) {
+                p_sched->p_callback = p_sched->p_comms_callback;
+                p_sched->p_context = p_sched->p_comms_context;
+            }
+            p_sched->owner = I2C_OWNER_COMMS;
+            p_sched->restart = restart;
+            if (read) {
+                status = p_api->read(p_ctrl, p_buffer, bytes, restart);
+            } else {
+                status = p_api->write(p_ctrl, p_buffer, bytes, restart);
+            }
+        }
+        if (FSP_SUCCESS != status) {
+            p_sched->owner = I2C_OWNER_NONE;
+            p_sched->restart = false;
+        }
+    }
+    FSP_CRITICAL_SECTION_EXIT;
+    return status;
+}
+
+static fsp_err_t i2c_schedule_drv_open(i2c_master_ctrl_t * const p_ctrl, i2c_master_cfg_t const * const p_cfg) {
+    i2c_bus_entry * p_entry = i2c_schedule_find(p_ctrl);
+    i2c_schedule_bus * p_sched = &p_entry->sched;
+    i2c_master_api_t const * p_api = p_sched->p_driver->p_api;
+    fsp_err_t status = p_api->open(p_ctrl, p_cfg);
+    if (FSP_SUCCESS != status) return status;
+    p_sched->p_comms_callback = p_cfg->p_callback;
+    p_sched->p_comms_context = p_cfg->p_context;
+    p_sched->comms_address = p_cfg->slave;
+    p_sched->comms_addr_mode = p_cfg->addr_mode;
+    p_sched->address = p_cfg->slave;
+    p_sched->owner = I2C_OWNER_NONE;
+    p_sched->restart = false;
+    status = p_api->callbackSet(p_ctrl, i2c_schedule_callback, p_entry, NULL);
+    if (FSP_SUCCESS != status) return status;
+    // Transactions queued before a bus recovery
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    p_sched->open = true;
+    i2c_transaction * p_refused = i2c_schedule_next(p_entry);
+    FSP_CRITICAL_SECTION_EXIT;
+    i2c_schedule_notify(p_refused);
+    return FSP_SUCCESS;
+}
+
+static fsp_err_t i2c_schedule_drv_read(i2c_master_ctrl_t * const p_ctrl, uint8_t * const p_dest,
+                                       uint32_t const bytes, bool const restart) {
+    return i2c_schedule_transfer(p_ctrl, p_dest, bytes, restart, true);
+}
+
+static fsp_err_t i2c_schedule_drv_write(i2c_master_ctrl_t * const p_ctrl, uint8_t * const p_src,
+                                        uint32_t const bytes, bool const restart) {
+    return i2c_schedule_transfer(p_ctrl, p_src, bytes, restart, false);
+}
+
+static fsp_err_t i2c_schedule_drv_abort(i2c_master_ctrl_t * const p_ctrl) {
+    i2c_schedule_bus * p_sched = &i2c_schedule_find(p_ctrl)->sched;
+    fsp_err_t status = p_sched->p_driver->p_api->abort(p_ctrl);
+    i2c_schedule_release(p_sched);
+    return status;
+}
+
+static fsp_err_t i2c_schedule_drv_slave_address_set(i2c_master_ctrl_t * const p_ctrl, uint32_t const slave,
+                                                    i2c_master_addr_mode_t const addr_mode) {
+    i2c_schedule_bus * p_sched = &i2c_schedule_find(p_ctrl)->sched;
+    p_sched->comms_address = slave;
+    p_sched->comms_addr_mode = addr_mode;
+    return FSP_SUCCESS;
+}
+
+static fsp_err_t i2c_schedule_drv_callback_set(i2c_master_ctrl_t * const p_ctrl,
+                                               void (* p_callback)(i2c_master_callback_args_t *),
+                                               void const * const p_context,
+                                               i2c_master_callback_args_t * const p_callback_memory) {
+    FSP_PARAMETER_NOT_USED(p_callback_memory);
+    i2c_schedule_bus * p_sched = &i2c_schedule_find(p_ctrl)->sched;
+    p_sched->p_comms_callback = p_callback;
+    p_sched->p_comms_context = p_context;
+    return FSP_SUCCESS;
+}
+
+static fsp_err_t i2c_schedule_drv_status_get(i2c_master_ctrl_t * const p_ctrl, i2c_master_status_t * p_status) {
+    return i2c_schedule_find(p_ctrl)->sched.p_driver->p_api->statusGet(p_ctrl, p_status);
+}
+
+static fsp_err_t i2c_schedule_drv_close(i2c_master_ctrl_t * const p_ctrl) {
+    i2c_schedule_bus * p_sched = &i2c_schedule_find(p_ctrl)->sched;
+    p_sched->open = false;
+    fsp_err_t status = p_sched->p_driver->p_api->close(p_ctrl);
+    i2c_schedule_release(p_sched);
+    return status;
+}
+
+static i2c_master_api_t const i2c_schedule_api = {
+    .open = i2c_schedule_drv_open,
+    .read = i2c_schedule_drv_read,
+    .write = i2c_schedule_drv_write,
+    .abort = i2c_schedule_drv_abort,
+    .slaveAddressSet = i2c_schedule_drv_slave_address_set,
+    .callbackSet = i2c_schedule_drv_callback_set,
+    .statusGet = i2c_schedule_drv_status_get,
+    .close = i2c_schedule_drv_close,
+};
+
+// Route the driver calls of rm_comms through the scheduler of the bus, once
+static void i2c_schedule_install(i2c_bus_entry * p_entry) {
+    i2c_schedule_bus * p_sched = &p_entry->sched;
+    if (NULL != p_sched->p_driver) return;
+    p_sched->p_driver = (i2c_master_instance_t const *) p_entry->p_bus->p_driver_instance;
+    p_sched->instance.p_ctrl = p_sched->p_driver->p_ctrl;
+    p_sched->instance.p_cfg = p_sched->p_driver->p_cfg;
+    p_sched->instance.p_api = &i2c_schedule_api;
+    p_entry->p_bus->p_driver_instance = &p_sched->instance;
+}
+#endif
+
+#if BSP_CFG_RTOS
+static void i2c_create_rtos_objects(rm_comms_i2c_bus_extended_cfg_t * p_bus) {
+    /* Create a semaphore for blocking if a semaphore is not NULL */
+    if (NULL != p_bus->p_blocking_semaphore)
+    {
+#if BSP_CFG_RTOS == 1 // AzureOS
+        tx_semaphore_create(p_bus->p_blocking_semaphore->p_semaphore_handle,
+                            p_bus->p_blocking_semaphore->p_semaphore_name,
+                            (ULONG)0);
+#elif BSP_CFG_RTOS == 2 // FreeRTOS
+        *(p_bus->p_blocking_semaphore->p_semaphore_handle) = xSemaphoreCreateCountingStatic((UBaseType_t)1, (UBaseType_t)0, p_bus->p_blocking_semaphore->p_semaphore_memory);
+#endif
+    }
+
+    /* Create a recursive mutex for bus lock if a recursive mutex is not NULL */
+    if (NULL != p_bus->p_bus_recursive_mutex)
+    {
+#if BSP_CFG_RTOS == 1 // AzureOS
+        tx_mutex_create(p_bus->p_bus_recursive_mutex->p_mutex_handle,
+                        p_bus->p_bus_recursive_mutex->p_mutex_name,
+                        TX_INHERIT);
+#elif BSP_CFG_RTOS == 2 // FreeRTOS
+        *(p_bus->p_bus_recursive_mutex->p_mutex_handle) = xSemaphoreCreateRecursiveMutexStatic(p_bus->p_bus_recursive_mutex->p_mutex_memory);
+#endif
+    }
+}
+#endif
+
+fsp_err_t i2c_bus_initialize(rm_comms_i2c_bus_extended_cfg_t const * p_bus) {
     fsp_err_t status = FSP_ERR_ALREADY_OPEN;
-    if (false == init_done) {
-        i2c_master_instance_t * p_driver_instance = (i2c_master_instance_t *) g_comms_i2c_bus0_extended_cfg.p_driver_instance;
+    i2c_bus_entry * p_entry = i2c_find_bus(p_bus);
+    if (NULL == p_entry) {
+        log_error("I2C bus not registered");
+        return FSP_ERR_NOT_FOUND;
+    }
+    if (false == p_entry->init_done) {
+#if I2C_CFG_TRACE_ENABLE
+        i2c_trace_install(p_entry);
+#endif
+#if I2C_CFG_SCHEDULE_ENABLE
+        i2c_schedule_install(p_entry);
+#endif
+        i2c_master_instance_t * p_driver_instance = (i2c_master_instance_t *) p_entry->p_bus->p_driver_instance;
+#if BSP_CFG_RTOS
+        i2c_create_rtos_objects(p_entry->p_bus);
+#endif
         /* Open I2C driver, this must be done before calling any COMMS API */
         status = p_driver_instance->p_api->open(p_driver_instance->p_ctrl, p_driver_instance->p_cfg);
         if (FSP_SUCCESS == status) {
-            init_done = true;
+            p_entry->init_done = true;
         } else {
             log_error("I2C open error %d", status)
         }
@@ -31,16 +731,153 @@ fsp_err_t i2c_initialize(void) {
     return status;
 }
 
+bool i2c_is_device_address(rm_comms_instance_t const * p_comms, uint8_t address) {
+    i2c_master_cfg_t const * p_cfg = (i2c_master_cfg_t const *) p_comms->p_cfg->p_lower_level_cfg;
+    return (NULL != p_cfg) && (address == p_cfg->slave);
+}
+
+uint8_t i2c_get_device_address(rm_comms_instance_t const * p_comms) {
+    i2c_master_cfg_t const * p_cfg = (i2c_master_cfg_t const *) p_comms->p_cfg->p_lower_level_cfg;
+    return (NULL == p_cfg) ? 0 : (uint8_t) p_cfg->slave;
+}
+
+rm_comms_instance_t const * i2c_device_create(i2c_device * p_device, rm_comms_instance_t const * p_template,
+                                              uint8_t address, void (* p_callback)(rm_comms_callback_args_t * p_args),
+                                              void const * p_context) {
+    if ((0 == address) || (NULL == p_template->p_cfg->p_lower_level_cfg) ||
+        i2c_is_device_address(p_template, address)) return p_template;
+    // Same bus and I2C settings, only the slave address differs
+    p_device->lower_level_cfg = *(i2c_master_cfg_t const *) p_template->p_cfg->p_lower_level_cfg;
+    p_device->lower_level_cfg.slave = address;
+    p_device->cfg = *p_template->p_cfg;
+    p_device->cfg.p_lower_level_cfg = &p_device->lower_level_cfg;
+    p_device->cfg.p_callback = p_callback;
+    p_device->cfg.p_context = p_context;
+    memset(&p_device->ctrl, 0, sizeof(p_device->ctrl));
+    p_device->instance.p_ctrl = &p_device->ctrl;
+    p_device->instance.p_cfg = &p_device->cfg;
+    p_device->instance.p_api = p_template->p_api;
+    return &p_device->instance;
+}
+
+// Clock the bus until SDA is released then send a STOP, with the pins as open-drain GPIOs
+static bool i2c_bus_clear(i2c_bus_entry const * p_entry) {
+    bool released;
+    R_BSP_PinAccessEnable();
+    R_BSP_PinCfg(p_entry->scl, IOPORT_CFG_PORT_DIRECTION_OUTPUT | IOPORT_CFG_PORT_OUTPUT_HIGH | IOPORT_CFG_NMOS_ENABLE);
+    R_BSP_PinCfg(p_entry->sda, IOPORT_CFG_PORT_DIRECTION_OUTPUT | IOPORT_CFG_PORT_OUTPUT_HIGH | IOPORT_CFG_NMOS_ENABLE);
+    R_BSP_SoftwareDelay(I2C_RECOVERY_HALF_PERIOD_US, BSP_DELAY_UNITS_MICROSECONDS);
+    for (uint32_t i = 0; (i < I2C_RECOVERY_CLOCKS) && (BSP_IO_LEVEL_LOW == R_BSP_PinRead(p_entry->sda)); i++) {
+        R_BSP_PinWrite(p_entry->scl, BSP_IO_LEVEL_LOW);
+        R_BSP_SoftwareDelay(I2C_RECOVERY_HALF_PERIOD_US, BSP_DELAY_UNITS_MICROSECONDS);
+        R_BSP_PinWrite(p_entry->scl, BSP_IO_LEVEL_HIGH);
+        R_BSP_SoftwareDelay(I2C_RECOVERY_HALF_PERIOD_US, BSP_DELAY_UNITS_MICROSECONDS);
+    }
+    // STOP condition: SDA rises while SCL is high
+    R_BSP_PinWrite(p_entry->scl, BSP_IO_LEVEL_LOW);
+    R_BSP_SoftwareDelay(I2C_RECOVERY_HALF_PERIOD_US, BSP_DELAY_UNITS_MICROSECONDS);
+    R_BSP_PinWrite(p_entry->sda, BSP_IO_LEVEL_LOW);
+    R_BSP_SoftwareDelay(I2C_RECOVERY_HALF_PERIOD_US, BSP_DELAY_UNITS_MICROSECONDS);
+    R_BSP_PinWrite(p_entry->scl, BSP_IO_LEVEL_HIGH);
+    R_BSP_SoftwareDelay(I2C_RECOVERY_HALF_PERIOD_US, BSP_DELAY_UNITS_MICROSECONDS);
+    R_BSP_PinWrite(p_entry->sda, BSP_IO_LEVEL_HIGH);
+    R_BSP_SoftwareDelay(I2C_RECOVERY_HALF_PERIOD_US, BSP_DELAY_UNITS_MICROSECONDS);
+    released = (BSP_IO_LEVEL_HIGH == R_BSP_PinRead(p_entry->sda)) && (BSP_IO_LEVEL_HIGH == R_BSP_PinRead(p_entry->scl));
+    // Back to the IIC peripheral
+    R_BSP_PinCfg(p_entry->scl, IOPORT_CFG_PERIPHERAL_PIN | IOPORT_PERIPHERAL_IIC | IOPORT_CFG_DRIVE_MID);
+    R_BSP_PinCfg(p_entry->sda, IOPORT_CFG_PERIPHERAL_PIN | IOPORT_PERIPHERAL_IIC | IOPORT_CFG_DRIVE_MID);
+    R_BSP_PinAccessDisable();
+    return released;
+}
+
+fsp_err_t i2c_recover(rm_comms_instance_t const * p_comms) {
+    fsp_err_t status;
+    i2c_bus_entry * p_entry = i2c_find_bus((rm_comms_i2c_bus_extended_cfg_t const *) p_comms->p_cfg->p_extend);
+    if ((NULL == p_entry) || (false == p_entry->init_done)) return FSP_ERR_NOT_OPEN;
+    i2c_master_instance_t * p_driver_instance = (i2c_master_instance_t *) p_entry->p_bus->p_driver_instance;
+    // Abort the transfer in progress (its callback is not called) and release the pins
+    p_driver_instance->p_api->abort(p_driver_instance->p_ctrl);
+    p_driver_instance->p_api->close(p_driver_instance->p_ctrl);
+    bool released = i2c_bus_clear(p_entry);
+    status = p_driver_instance->p_api->open(p_driver_instance->p_ctrl, p_driver_instance->p_cfg);
+    // The next transfer sets the slave address again, whatever the device
+    p_entry->p_bus->p_current_device = NULL;
+    if (FSP_SUCCESS != status) {
+        log_error("I2C reopen error %d", status);
+        p_entry->init_done = false;
+        return status;
+    }
+    if (!released) {
+        log_error("I2C bus still held low");
+        return FSP_ERR_INVALID_HW_CONDITION;
+    }
+    log_info("I2C bus recovered");
+    return FSP_SUCCESS;
+}
+
+#if I2C_CFG_SCHEDULE_ENABLE
+fsp_err_t i2c_submit(i2c_transaction * p_transaction) {
+    i2c_bus_entry * p_entry = i2c_find_bus((rm_comms_i2c_bus_extended_cfg_t const *) p_transaction->p_comms->p_cfg->p_extend);
+    if ((NULL == p_entry) || (false == p_entry->init_done)) return FSP_ERR_NOT_OPEN;
+    if (NULL == p_transaction->p_comms->p_cfg->p_lower_level_cfg) return FSP_ERR_INVALID_ARGUMENT;
+    i2c_schedule_bus * p_sched = &p_entry->sched;
+    p_transaction->result = FSP_ERR_IN_USE;
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    // After the transactions of the same or a higher priority
+    i2c_transaction ** pp_next = &p_sched->p_queue;
+    while ((NULL != *pp_next) && ((*pp_next)->priority <= p_transaction->priority)) pp_next = &(*pp_next)->p_next;
+    p_transaction->p_next = *pp_next;
+    *pp_next = p_transaction;
+    i2c_transaction * p_refused = i2c_schedule_next(p_entry);
+    FSP_CRITICAL_SECTION_EXIT;
+    i2c_schedule_notify(p_refused);
+    return FSP_SUCCESS;
+}
+
+fsp_err_t i2c_cancel(i2c_transaction * p_transaction) {
+    fsp_err_t status = FSP_ERR_NOT_FOUND;
+    i2c_bus_entry * p_entry = i2c_find_bus((rm_comms_i2c_bus_extended_cfg_t const *) p_transaction->p_comms->p_cfg->p_extend);
+    if (NULL == p_entry) return status;
+    i2c_schedule_bus * p_sched = &p_entry->sched;
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    if (p_transaction == p_sched->p_active) {
+        status = FSP_ERR_IN_USE;
+    } else {
+        for (i2c_transaction ** pp_next = &p_sched->p_queue; NULL != *pp_next; pp_next = &(*pp_next)->p_next) {
+            if (p_transaction == *pp_next) {
+                *pp_next = p_transaction->p_next;
+                p_transaction->result = FSP_ERR_ABORTED;
+                status = FSP_SUCCESS;
+                break;
+            }
+        }
+    }
+    FSP_CRITICAL_SECTION_EXIT;
+    return status;
+}
+#endif
+
+fsp_err_t i2c_initialize(void) {
+    return i2c_bus_initialize(&g_comms_i2c_bus0_extended_cfg);
+}
+
 void i2c_deinitialize(void) {
     fsp_err_t status = FSP_ERR_NOT_OPEN;
-    if (true == init_done) {
-        i2c_master_instance_t * p_driver_instance = (i2c_master_instance_t *) g_comms_i2c_bus0_extended_cfg.p_driver_instance;
-        /* Close I2C driver */
-        status = p_driver_instance->p_api->close(p_driver_instance->p_ctrl);
-        if (FSP_SUCCESS == status) {
-            init_done = false;
-        } else {
-            log_error("I2C open error %d", status)
-        }       
+    for (uint32_t i = 0; i < I2C_NUM_BUSES; i++) {
+        if (true == i2c_buses[i].init_done) {
+            i2c_master_instance_t * p_driver_instance = (i2c_master_instance_t *) i2c_buses[i].p_bus->p_driver_instance;
+            /* Close I2C driver */
+            status = p_driver_instance->p_api->close(p_driver_instance->p_ctrl);
+            if (FSP_SUCCESS == status) {
+                i2c_buses[i].init_done = false;
+#if I2C_CFG_SCHEDULE_ENABLE
+                i2c_schedule_flush(&i2c_buses[i].sched);
+#endif
+            } else {
+                log_error("I2C close error %d", status)
+            }
+        }
     }
 }
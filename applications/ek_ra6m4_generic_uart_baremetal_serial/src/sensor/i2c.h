@@ -3,9 +3,166 @@
  */
 #ifndef I2C_EP_H_
 #define I2C_EP_H_
+#include "hal_data.h"
 
 
+// Comms device for another address on the bus of a configured device (see i2c_device_create)
+typedef struct {
+    rm_comms_instance_t instance;
+    rm_comms_cfg_t cfg;
+    i2c_master_cfg_t lower_level_cfg;
+    rm_comms_i2c_instance_ctrl_t ctrl;
+} i2c_device;
+
+// Set to 1 to trace the transfers of the I2C buses (see i2c_trace_read), 0 builds neither the tracer nor its overhead
+#ifndef I2C_CFG_TRACE_ENABLE
+#define I2C_CFG_TRACE_ENABLE        (0)
+#endif
+// Number of transfers kept by the tracer, a power of 2 (20 bytes each)
+#ifndef I2C_CFG_TRACE_DEPTH
+#define I2C_CFG_TRACE_DEPTH         (64)
+#endif
+
+// Set to 1 to build the transaction queue of the I2C buses (see i2c_submit). While transactions are queued, the
+// transfers of rm_comms are refused with FSP_ERR_IN_USE, 0 leaves the buses to rm_comms alone
+#ifndef I2C_CFG_SCHEDULE_ENABLE
+#define I2C_CFG_SCHEDULE_ENABLE     (0)
+#endif
+
+#if I2C_CFG_SCHEDULE_ENABLE
+// Kind of a scheduled transaction (see i2c_submit)
+typedef enum {
+    I2C_TRANSACTION_WRITE,
+    I2C_TRANSACTION_READ,
+    I2C_TRANSACTION_WRITE_READ,     // write then read after a repeated START
+} i2c_transaction_type;
+
+// Transaction of the queue of a bus, owned by the scheduler from i2c_submit to its completion
+typedef struct st_i2c_transaction {
+    rm_comms_instance_t const * p_comms;    // comms device giving the bus and the slave address
+    i2c_transaction_type type;
+    uint8_t * p_src;
+    uint32_t src_bytes;
+    uint8_t * p_dest;
+    uint32_t dest_bytes;
+    uint8_t priority;                       // 0 is the highest
+    // Called from the completion interrupt, NULL to poll the result instead
+    void (* p_callback)(struct st_i2c_transaction * p_transaction);
+    void const * p_context;
+    // FSP_ERR_IN_USE until completed, then FSP_SUCCESS, FSP_ERR_ABORTED (NACK, bus error, refused by the driver,
+    // i2c_recover) or the error of the driver
+    volatile fsp_err_t result;
+    struct st_i2c_transaction * p_next;
+} i2c_transaction;
+#endif
+
+#if I2C_CFG_TRACE_ENABLE
+// Flags of a trace record
+#define I2C_TRACE_FLAG_READ         (0x01)  // read transfer, write otherwise
+#define I2C_TRACE_FLAG_RESTART      (0x02)  // no STOP, the next transfer starts with a repeated START
+
+// One transfer of the I2C driver, a writeRead of rm_comms is traced as a write (with restart) followed by a read
+typedef struct {
+    uint32_t sequence;      // sequence number of the transfer
+    uint32_t start;         // DWT cycles when the transfer was started
+    uint32_t duration;      // DWT cycles from the start to the completion (or abort)
+    uint16_t bytes;
+    uint8_t bus;            // index of the bus in the registry of i2c.c
+    uint8_t address;        // 7-bit slave address
+    uint8_t flags;          // I2C_TRACE_FLAG_xxx
+    uint8_t event;          // i2c_master_event_t of the completion, 0 when aborted by i2c_recover or closed
+    uint16_t reserved;
+} i2c_trace_record;
+
+// Activity of a bus over a window (see i2c_trace_stats)
+typedef struct {
+    uint32_t window_us;     // span covered by the records, shorter than asked when older records were overwritten
+    uint32_t transfers;
+    uint32_t errors;        // transfers not completed (NACK, arbitration lost, aborted)
+    uint32_t busy_us;
+    uint16_t utilization;   // busy time of the bus in per mille of the window
+} i2c_trace_bus_stats;
+
+// Transfer latencies of a device over a window (see i2c_trace_stats)
+typedef struct {
+    uint8_t address;
+    uint16_t transfers;
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} i2c_trace_device_stats;
+
+// Output of the export functions (ie.: a write to the UART or SEGGER_RTT_Write)
+typedef void (* i2c_trace_write)(char const * p_line, uint32_t length);
+#endif
+
 /* Function declaration */
+/*******************************************************************************************************************//**
+ * @brief       Initialize an I2C bus and its RTOS objects, only the first call for a bus has any effect
+ * @param[in]   extended configuration of the bus (ie.: g_comms_i2c_bus0_extended_cfg)
+ * @retval      FSP_SUCCESS         Upon successful open
+ * @retval      FSP_ERR_ALREADY_OPEN  The bus was already initialized
+ * @retval      Any Other Error code apart from FSP_SUCCESS  Unsuccessful open
+ ***********************************************************************************************************************/
+fsp_err_t i2c_bus_initialize(rm_comms_i2c_bus_extended_cfg_t const * p_bus);
+/*******************************************************************************************************************//**
+ * @brief       Check the slave address a comms device is configured for (used by the sensor probe functions)
+ * @param[in]   comms device instance (ie.: g_comms_i2c_device0)
+ * @param[in]   7-bit address
+ * @retval      true if the device uses this address
+ ***********************************************************************************************************************/
+bool i2c_is_device_address(rm_comms_instance_t const * p_comms, uint8_t address);
+/*******************************************************************************************************************//**
+ * @brief       Get the 7-bit slave address a comms device is configured for
+ * @param[in]   comms device instance (ie.: g_comms_i2c_device0)
+ * @retval      address, 0 if unknown
+ ***********************************************************************************************************************/
+uint8_t i2c_get_device_address(rm_comms_instance_t const * p_comms);
+/*******************************************************************************************************************//**
+ * @brief       Get a comms device for an address on the bus of a configured device. The configured device is returned
+ *              for its own address (or 0), otherwise the configured device is copied into p_device with the new address,
+ *              callback and context. The bus switches the slave address on each transfer to another device
+ * @param[in]   storage of the new device, must stay valid while the device is used
+ * @param[in]   configured comms device (ie.: g_comms_i2c_device0)
+ * @param[in]   7-bit address, 0 for the address of the configured device
+ * @param[in]   callback and context of the new device
+ * @retval      comms device to use for this address
+ ***********************************************************************************************************************/
+rm_comms_instance_t const * i2c_device_create(i2c_device * p_device, rm_comms_instance_t const * p_template,
+                                              uint8_t address, void (* p_callback)(rm_comms_callback_args_t * p_args),
+                                              void const * p_context);
+/*******************************************************************************************************************//**
+ * @brief       Recover the bus of a comms device after a transfer timed out: abort the transfer, clock the bus up to
+ *              9 times until SDA is released, send a STOP and reopen the I2C driver. The callback of the aborted
+ *              transfer is not called, its driver must forget it (ie.: close and open the sensor instance)
+ * @param[in]   comms device instance (ie.: g_comms_i2c_device0)
+ * @retval      FSP_SUCCESS         Bus free
+ * @retval      FSP_ERR_INVALID_HW_CONDITION  SDA or SCL still held low
+ * @retval      Any Other Error code apart from FSP_SUCCESS  Bus not open
+ ***********************************************************************************************************************/
+fsp_err_t i2c_recover(rm_comms_instance_t const * p_comms);
+#if I2C_CFG_SCHEDULE_ENABLE
+/*******************************************************************************************************************//**
+ * @brief       Queue a transaction on the bus of its comms device. The queue runs the highest priority first, in
+ *              submission order within a priority, each transaction starting from the completion interrupt of the
+ *              previous one. A transfer of rm_comms in progress completes first, the next ones are refused
+ *              (FSP_ERR_IN_USE) while the queue is not empty. The transaction must stay valid until its completion
+ * @param[in]   transaction
+ * @retval      FSP_SUCCESS         Queued (or started)
+ * @retval      FSP_ERR_NOT_OPEN    The bus is not initialized
+ * @retval      FSP_ERR_INVALID_ARGUMENT  The comms device has no I2C configuration
+ ***********************************************************************************************************************/
+fsp_err_t i2c_submit(i2c_transaction * p_transaction);
+/*******************************************************************************************************************//**
+ * @brief       Withdraw a queued transaction (ie.: on timeout), its callback is not called
+ * @param[in]   transaction
+ * @retval      FSP_SUCCESS         Withdrawn, result set to FSP_ERR_ABORTED
+ * @retval      FSP_ERR_IN_USE      In progress, i2c_recover aborts it
+ * @retval      FSP_ERR_NOT_FOUND   Already completed
+ ***********************************************************************************************************************/
+fsp_err_t i2c_cancel(i2c_transaction * p_transaction);
+#endif
 /*******************************************************************************************************************//**
  * @brief       Initialize  I2C.
  * @param[in]   None
@@ -14,10 +171,54 @@
  ***********************************************************************************************************************/
 fsp_err_t i2c_initialize(void);
 /*******************************************************************************************************************//**
- *  @brief       Deinitialize I2C module
+ *  @brief       Deinitialize I2C module, the transactions still queued complete with FSP_ERR_ABORTED
  *  @param[in]   None
  *  @retval      None
  **********************************************************************************************************************/
 void i2c_deinitialize(void);
 
+#if I2C_CFG_TRACE_ENABLE
+/*******************************************************************************************************************//**
+ * @brief       Copy the trace records from a sequence number on, oldest first. The buffer is written by the transfer
+ *              completions without lock, records overwritten before being read are skipped
+ * @param[in,out] sequence number of the next record to read (0 at first call), updated to the one after the last read
+ * @param[out]  records
+ * @param[in]   size of the records array
+ * @retval      number of records copied
+ ***********************************************************************************************************************/
+uint32_t i2c_trace_read(uint32_t * p_sequence, i2c_trace_record * p_records, uint32_t max);
+/*******************************************************************************************************************//**
+ * @brief       Compute the utilization of a bus and the latency percentiles of its devices from the transfers
+ *              completed during the last milliseconds
+ * @param[in]   extended configuration of the bus (ie.: g_comms_i2c_bus0_extended_cfg)
+ * @param[in]   window in ms, up to the wrap of the DWT cycle counter (10 s at 200 MHz)
+ * @param[out]  bus statistics
+ * @param[out]  device statistics, by address, NULL if not needed
+ * @param[in]   size of the device statistics array
+ * @retval      number of devices, can be more than max_devices
+ ***********************************************************************************************************************/
+uint32_t i2c_trace_stats(rm_comms_i2c_bus_extended_cfg_t const * p_bus, uint32_t window_ms,
+                         i2c_trace_bus_stats * p_stats, i2c_trace_device_stats * p_devices, uint32_t max_devices);
+/*******************************************************************************************************************//**
+ * @brief       Export the trace records as text lines, decodable on host as CSV:
+ *              I2CCLK,<cpu clock Hz>
+ *              I2C,<sequence>,<start cycles>,<duration cycles>,<bus>,<address>,<R|W>,<restart>,<bytes>,<event>
+ *              Gaps in the sequence numbers are records overwritten before the export
+ * @param[in,out] sequence number of the next record to export (0 at first call)
+ * @param[in]   output of the lines
+ * @retval      number of records exported
+ ***********************************************************************************************************************/
+uint32_t i2c_trace_export(uint32_t * p_sequence, i2c_trace_write p_write);
+/*******************************************************************************************************************//**
+ * @brief       Export the statistics of a bus (see i2c_trace_stats) as text lines, decodable on host as CSV:
+ *              I2CBUS,<bus>,<window us>,<transfers>,<errors>,<busy us>,<utilization per mille>
+ *              I2CDEV,<bus>,<address>,<transfers>,<p50 us>,<p90 us>,<p99 us>,<max us>
+ * @param[in]   extended configuration of the bus (ie.: g_comms_i2c_bus0_extended_cfg)
+ * @param[in]   window in ms
+ * @param[in]   output of the lines
+ ***********************************************************************************************************************/
+void i2c_trace_export_stats(rm_comms_i2c_bus_extended_cfg_t const * p_bus, uint32_t window_ms,
+                            i2c_trace_write p_write);
+#endif
+
 #endif
@@ -0,0 +1,141 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+#include <stdint.h>
+#include "common_utils.h"
+#include "sm_config.h"
+// Uncomment the desired debug level
+#include "log_disabled.h"
+//#include "log_error.h"
+//#include "log_warning.h"
+//#include "log_info.h"
+//#include "log_debug.h"
+
+#if SM_CFG_CONFIG_ENABLE
+#define CONFIG_MAGIC    (0x464E4353U)   // "SCNF"
+#define CONFIG_COMMIT   (0x54494D43U)   // "CMIT"
+#define CONFIG_DATA_SIZE(COUNT)     (sizeof(sm_config_header) + ((COUNT) * sizeof(sm_config_entry)))
+#define CONFIG_RECORD_SIZE(COUNT)   (CONFIG_DATA_SIZE(COUNT) + (2U * sizeof(uint32_t)))
+
+static bool flash_open = false;
+static bool scanned = false;
+static uint32_t slot_size;
+static uint16_t num_slots;
+static int32_t newest_slot;
+static uint32_t newest_sequence;
+// Records are written from RAM
+static uint32_t record[CONFIG_RECORD_SIZE(NUM_SENSORS) / sizeof(uint32_t)];
+
+// CRC-32 (IEEE 802.3), one nibble at a time to keep the table small
+static uint32_t sm_config_crc(uint8_t const * data, uint32_t size) {
+    static const uint32_t table[16] = {
+        0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+        0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+    };
+    uint32_t crc = 0xFFFFFFFFU;
+    while (0 < size--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ table[crc & 0x0FU];
+        crc = (crc >> 4) ^ table[crc & 0x0FU];
+    }
+    return ~crc;
+}
+
+static sm_result sm_config_open(void) {
+    if (!flash_open) {
+        if (SM_OK != sm_config_flash_open()) return SM_ERROR;
+        flash_open = true;
+    }
+    // A slot is made of whole erase blocks, so a save never erases another record
+    slot_size = ((CONFIG_RECORD_SIZE(NUM_SENSORS) + SM_CONFIG_FLASH_BLOCK_SIZE - 1U) / SM_CONFIG_FLASH_BLOCK_SIZE) *
+                SM_CONFIG_FLASH_BLOCK_SIZE;
+    num_slots = (uint16_t)(SM_CFG_CONFIG_FLASH_SIZE / slot_size);
+    if (2U > num_slots) {
+        log_error("Config area too small");
+        return SM_ERROR;
+    }
+    return SM_OK;
+}
+
+// Returns the header of the record in a slot, NULL if the slot holds no complete record
+static sm_config_header const * sm_config_check(uint16_t slot) {
+    uint8_t const * p_record = sm_config_flash_data() + (slot * slot_size);
+    sm_config_header const * header = (sm_config_header const *)p_record;
+    // Erased data flash reads undefined values, a record is only trusted once magic, commit word and CRC match
+    if ((CONFIG_MAGIC != header->magic) || (SM_CONFIG_VERSION != header->version)) return NULL;
+    if (CONFIG_RECORD_SIZE(header->count) > slot_size) return NULL;
+    uint32_t const * trailer = (uint32_t const *)(p_record + CONFIG_DATA_SIZE(header->count));
+    if (CONFIG_COMMIT != trailer[1]) return NULL;
+    if (sm_config_crc(p_record, CONFIG_DATA_SIZE(header->count)) != trailer[0]) return NULL;
+    return header;
+}
+
+// Find the newest record, the area is read in place once (at most SM_CFG_CONFIG_FLASH_SIZE bytes)
+static void sm_config_scan(void) {
+    newest_slot = -1;
+    newest_sequence = 0;
+    for (uint16_t slot = 0; num_slots > slot; slot++) {
+        sm_config_header const * header = sm_config_check(slot);
+        // The sequence wraps around, the records of the area are a few saves apart so the difference tells the newest
+        if ((NULL != header) && ((0 > newest_slot) || (0 < (int32_t)(header->sequence - newest_sequence)))) {
+            newest_slot = slot;
+            newest_sequence = header->sequence;
+        }
+    }
+    scanned = true;
+}
+
+sm_result sm_config_load(sm_config_entry * entries, uint16_t count, uint32_t layout) {
+    if (SM_OK != sm_config_open()) return SM_ERROR;
+    sm_config_scan();
+    if (0 > newest_slot) return SM_ERROR;
+    uint8_t const * p_record = sm_config_flash_data() + ((uint32_t)newest_slot * slot_size);
+    sm_config_header const * header = (sm_config_header const *)p_record;
+    if ((count != header->count) || (layout != header->layout)) {
+        log_info("Config written for other sensors, ignored");
+        return SM_ERROR;
+    }
+    memcpy(entries, p_record + sizeof(sm_config_header), count * sizeof(sm_config_entry));
+    log_info("Config %d loaded", newest_sequence);
+    return SM_OK;
+}
+
+sm_result sm_config_store(sm_config_entry const * entries, uint16_t count, uint32_t layout) {
+    if ((NUM_SENSORS < count) || (SM_OK != sm_config_open())) return SM_ERROR;
+    if (!scanned) sm_config_scan();
+    // The newest record is never erased, its slot is only reused after a newer record is committed
+    uint16_t slot = (0 > newest_slot) ? 0 : (uint16_t)((newest_slot + 1) % num_slots);
+    uint32_t offset = slot * slot_size;
+    uint32_t data_size = CONFIG_DATA_SIZE(count);
+    sm_config_header * header = (sm_config_header *)&record[0];
+    uint32_t * trailer = &record[data_size / sizeof(uint32_t)];
+
+    header->magic = CONFIG_MAGIC;
+    header->version = SM_CONFIG_VERSION;
+    header->count = count;
+    header->sequence = newest_sequence + 1U;
+    header->layout = layout;
+    memcpy(header + 1, entries, count * sizeof(sm_config_entry));
+    trailer[0] = sm_config_crc((uint8_t const *)record, data_size);
+    trailer[1] = CONFIG_COMMIT;
+    if (SM_OK != sm_config_flash_erase(offset, slot_size)) return SM_ERROR;
+    // Data and CRC first, the commit word makes the record valid
+    if (SM_OK != sm_config_flash_write(offset, (uint8_t const *)record, data_size + sizeof(uint32_t))) return SM_ERROR;
+    if (SM_OK != sm_config_flash_write(offset + data_size + sizeof(uint32_t), (uint8_t const *)&trailer[1],
+                                       sizeof(uint32_t))) return SM_ERROR;
+    newest_slot = slot;
+    newest_sequence++;
+    return SM_OK;
+}
+
+sm_result sm_config_clear(void) {
+    if (SM_OK != sm_config_open()) return SM_ERROR;
+    if (SM_OK != sm_config_flash_erase(0, (uint32_t)num_slots * slot_size)) return SM_ERROR;
+    newest_slot = -1;
+    newest_sequence = 0;
+    scanned = true;
+    return SM_OK;
+}
+#endif
@@ -10,13 +10,16 @@
 #if (BSP_CFG_RTOS) > 0
 #include "sensor_thread.h"
 #endif
-#include "tgs5141/rm_tgs5141_api.h"
-#include "tgs5141/rm_tgs5141.h"
+#include "figaro/rm_figaro_api.h"
+#include "figaro/rm_figaro.h"
 
 void tgs5141_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel);
 void tgs5141_sensor_close(sm_handle handle);
+sm_result tgs5141_sensor_probe(uint8_t address);
 sm_sensor_status tgs5141_sensor_read(sm_handle handle, int32_t * data);
 uint8_t * tgs5141_sensor_get_flag(sm_handle handle);
+void tgs5141_sensor_trigger(sm_handle handle);
+void tgs5141_sensor_fsm(void);
 sm_result tgs5141_sensor_set_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t value);
 sm_result tgs5141_sensor_get_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t * value);
 
@@ -0,0 +1,133 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+/*
+  Sensor Manager build configuration
+  All options below can be overridden by defining them in the project settings (compiler defines)
+*/
+#ifndef __SM_CFG_H
+#define __SM_CFG_H
+
+// Set to 1 to enable windowed aggregation (SM_WINDOW instance option)
+#ifndef SM_CFG_AGGREGATION_ENABLE
+#define SM_CFG_AGGREGATION_ENABLE       (0)
+#endif
+
+// Maximum number of slides a sliding window can hold (window_ms / slide_ms)
+#ifndef SM_CFG_AGGREGATION_MAX_PANES
+#define SM_CFG_AGGREGATION_MAX_PANES    (4)
+#endif
+
+// Number of sample records shared by all subscribers (see sm_subscriber.h)
+#ifndef SM_CFG_SAMPLE_POOL_SIZE
+#define SM_CFG_SAMPLE_POOL_SIZE         (4U * NUM_SENSORS)
+#endif
+
+// RTOS only, depth of the sample queue (g_sensor_queue) and of the window statistics queue (g_sensor_aggregate_queue)
+#ifndef SM_CFG_QUEUE_LENGTH
+#define SM_CFG_QUEUE_LENGTH             (20U * NUM_SENSORS)
+#endif
+
+#ifndef SM_CFG_AGGREGATE_QUEUE_LENGTH
+#define SM_CFG_AGGREGATE_QUEUE_LENGTH   (2U * NUM_SENSORS)
+#endif
+
+// RTOS only, what to do with a sample when its queue is full (see sm_get_queue_stats for the drop counters)
+#define SM_QUEUE_BLOCK                  (0)     // wait up to SM_CFG_QUEUE_SEND_WAIT ticks, then drop the new sample
+#define SM_QUEUE_DROP_NEWEST            (1)     // drop the new sample, SM never waits
+#define SM_QUEUE_DROP_OLDEST            (2)     // drop the oldest queued sample to make room, SM never waits
+#define SM_QUEUE_COALESCE               (3)     // keep only the freshest sample of each instance until there is room
+#ifndef SM_CFG_QUEUE_OVERFLOW
+#define SM_CFG_QUEUE_OVERFLOW           SM_QUEUE_BLOCK
+#endif
+
+#ifndef SM_CFG_QUEUE_SEND_WAIT
+#define SM_CFG_QUEUE_SEND_WAIT          (10)    // Ticks
+#endif
+
+// Set to 1 to run the callbacks (sm_callback and subscriber callbacks) after the acquisition phase of sm_run()
+// instead of inline, so a slow consumer cannot delay the acquisition of other sensors
+#ifndef SM_CFG_DEFERRED_DISPATCH
+#define SM_CFG_DEFERRED_DISPATCH        (0)
+#endif
+
+// Time budget (microseconds) for deferred callbacks in each sm_run() call, pending callbacks carry over to the next call
+#ifndef SM_CFG_DISPATCH_BUDGET_US
+#define SM_CFG_DISPATCH_BUDGET_US       (1000)
+#endif
+
+// Set to 1 to measure the time spent in each driver FSM (see sm_get_driver_fsm_stats)
+#ifndef SM_CFG_FSM_TIMING_ENABLE
+#define SM_CFG_FSM_TIMING_ENABLE        (0)
+#endif
+
+// Set to 1 to recover sensors that keep failing (reset, close and open the sensor with exponential backoff)
+#ifndef SM_CFG_RECOVERY_ENABLE
+#define SM_CFG_RECOVERY_ENABLE          (0)
+#endif
+
+// Number of consecutive read errors before a sensor is recovered
+#ifndef SM_CFG_RECOVERY_ERROR_THRESHOLD
+#define SM_CFG_RECOVERY_ERROR_THRESHOLD (3)
+#endif
+
+// Delay before a recovery (milliseconds), doubled on each new recovery until the sensor returns valid data
+#ifndef SM_CFG_RECOVERY_BACKOFF_MIN_MS
+#define SM_CFG_RECOVERY_BACKOFF_MIN_MS  (100)
+#endif
+
+#ifndef SM_CFG_RECOVERY_BACKOFF_MAX_MS
+#define SM_CFG_RECOVERY_BACKOFF_MAX_MS  (60000)
+#endif
+
+// RTOS only, set to 1 to run SM in its own thread with sm_task(). The thread sleeps until the next sampling deadline
+// or until it is woken up by sm_wake() (ie.: from an I2C completion callback) instead of polling every tick
+#ifndef SM_CFG_EVENT_DRIVEN
+#define SM_CFG_EVENT_DRIVEN             (0)
+#endif
+
+// Set to 1 to enable the discovery of sensor addresses at sm_init() (SM_PROBE instance option)
+#ifndef SM_CFG_DISCOVERY_ENABLE
+#define SM_CFG_DISCOVERY_ENABLE         (0)
+#endif
+
+// Maximum time (milliseconds) spent by sm_init() probing addresses, addresses not probed in time are skipped
+#ifndef SM_CFG_DISCOVERY_TIMEOUT_MS
+#define SM_CFG_DISCOVERY_TIMEOUT_MS     (100)
+#endif
+
+// Set to 1 to index the sensor paths in a hash table, sm_get_sensor_handle_by_path() then runs in constant time
+// instead of comparing the path of each sensor (uses 8 bytes of RAM per sensor)
+#ifndef SM_CFG_PATH_INDEX_ENABLE
+#define SM_CFG_PATH_INDEX_ENABLE        (0)
+#endif
+
+// Set to 1 to enable synchronized acquisition groups (DEFINE_SENSOR_GROUP and the SM_GROUP instance option)
+#ifndef SM_CFG_GROUP_ENABLE
+#define SM_CFG_GROUP_ENABLE             (0)
+#endif
+
+// Set to 1 to keep the attributes set with sm_set_sensor_attribute() in data flash, sm_init() restores them
+#ifndef SM_CFG_CONFIG_ENABLE
+#define SM_CFG_CONFIG_ENABLE            (0)
+#endif
+
+// Set to 1 to save the configuration on each attribute change, each save blocks on a data flash erase and write.
+// By default the application calls sm_save_config() once its changes are done
+#ifndef SM_CFG_CONFIG_AUTOSAVE
+#define SM_CFG_CONFIG_AUTOSAVE          (0)
+#endif
+
+// Data flash area of the configuration records (offset from the start of the data flash and size in bytes, multiples
+// of the 64 bytes erase block). The area must hold at least two records, saves use the records of the area in turn
+#ifndef SM_CFG_CONFIG_FLASH_OFFSET
+#define SM_CFG_CONFIG_FLASH_OFFSET      (0)
+#endif
+
+#ifndef SM_CFG_CONFIG_FLASH_SIZE
+#define SM_CFG_CONFIG_FLASH_SIZE        (1024)
+#endif
+
+#endif
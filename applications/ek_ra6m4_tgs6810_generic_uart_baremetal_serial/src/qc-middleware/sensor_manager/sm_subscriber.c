@@ -0,0 +1,183 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+#include <stdint.h>
+#include "common_utils.h"
+#include "sm_subscriber.h"
+// Uncomment the desired debug level
+#include "log_disabled.h"
+//#include "log_error.h"
+//#include "log_warning.h"
+//#include "log_info.h"
+//#include "log_debug.h"
+
+// Shared sample records, a record is free when it has no references. A record is referenced by the publisher and
+// once by each subscriber with a ring, 16 bits are more references than subscribers fit in RAM
+static sm_sample sample_pool[SM_CFG_SAMPLE_POOL_SIZE];
+static volatile uint16_t sample_references[SM_CFG_SAMPLE_POOL_SIZE];
+static uint16_t next_record;
+static uint32_t pool_drops;
+
+static sm_subscriber * subscribers = NULL;
+
+static sm_sample * sm_sample_alloc(void) {
+    // Records are allocated in order, so the next one is usually free
+    for (uint16_t n = 0; n < SM_CFG_SAMPLE_POOL_SIZE; n++) {
+        uint16_t i = next_record;
+        next_record = (uint16_t)((next_record + 1) % SM_CFG_SAMPLE_POOL_SIZE);
+        if (0 == sample_references[i]) {
+            // This reference is held by the publisher until the fan-out is complete
+            sample_references[i] = 1;
+            return &sample_pool[i];
+        }
+    }
+    return NULL;
+}
+
+// Must be called inside a critical section
+static void sm_sample_release_locked(sm_sample const * p_sample) {
+    uint16_t i = (uint16_t)(p_sample - &sample_pool[0]);
+    if ((i < SM_CFG_SAMPLE_POOL_SIZE) && (0 < sample_references[i])) {
+        sample_references[i]--;
+    }
+}
+
+static void sm_subscriber_push(sm_subscriber * p_sub, sm_sample const * p_sample) {
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    if (p_sub->count == p_sub->ring_size) {
+        p_sub->dropped++;
+        if (SM_OVERFLOW_DROP_NEWEST == p_sub->policy) {
+            FSP_CRITICAL_SECTION_EXIT;
+            return;
+        }
+        // Drop the oldest pending sample
+        sm_sample_release_locked(p_sub->pp_ring[p_sub->tail]);
+        p_sub->tail = (uint16_t)((p_sub->tail + 1) % p_sub->ring_size);
+        p_sub->count--;
+    }
+    sample_references[p_sample - &sample_pool[0]]++;
+    p_sub->pp_ring[p_sub->head] = p_sample;
+    p_sub->head = (uint16_t)((p_sub->head + 1) % p_sub->ring_size);
+    p_sub->count++;
+    FSP_CRITICAL_SECTION_EXIT;
+}
+
+static sm_result sm_subscribe(sm_subscriber * p_sub) {
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    for (sm_subscriber * p = subscribers; NULL != p; p = p->p_next) {
+        if (p == p_sub) {
+            FSP_CRITICAL_SECTION_EXIT;
+            log_error("Already subscribed");
+            return SM_ERROR;
+        }
+    }
+    p_sub->p_next = subscribers;
+    subscribers = p_sub;
+    FSP_CRITICAL_SECTION_EXIT;
+    return SM_OK;
+}
+
+void sm_subscriber_init(sm_subscriber * p_sub, sm_sample_callback callback, void * context,
+                        sm_sample const ** pp_ring, uint16_t ring_size, sm_overflow_policy policy) {
+    memset(p_sub, 0, sizeof(sm_subscriber));
+    p_sub->p_callback = callback;
+    p_sub->p_context = context;
+    p_sub->pp_ring = (0 < ring_size) ? pp_ring : NULL;
+    p_sub->ring_size = ring_size;
+    p_sub->policy = policy;
+}
+
+sm_result sm_subscribe_by_handle(sm_subscriber * p_sub, sm_handle handle) {
+    if (!IS_HANDLE_VALID(handle)) return SM_ERROR;
+    p_sub->handle = handle;
+    p_sub->type = SENSOR_ANY_TYPE;
+    return sm_subscribe(p_sub);
+}
+
+sm_result sm_subscribe_by_type(sm_subscriber * p_sub, sm_type type) {
+    p_sub->handle.value = 0;
+    p_sub->type = type;
+    return sm_subscribe(p_sub);
+}
+
+sm_result sm_unsubscribe(sm_subscriber * p_sub) {
+    sm_result result = SM_ERROR;
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    for (sm_subscriber ** pp = &subscribers; NULL != *pp; pp = &(*pp)->p_next) {
+        if (*pp == p_sub) {
+            *pp = p_sub->p_next;
+            // Release any pending samples
+            while (0 < p_sub->count) {
+                sm_sample_release_locked(p_sub->pp_ring[p_sub->tail]);
+                p_sub->tail = (uint16_t)((p_sub->tail + 1) % p_sub->ring_size);
+                p_sub->count--;
+            }
+            result = SM_OK;
+            break;
+        }
+    }
+    FSP_CRITICAL_SECTION_EXIT;
+    return result;
+}
+
+sm_result sm_subscriber_receive(sm_subscriber * p_sub, sm_sample const ** pp_sample) {
+    sm_result result = SM_ERROR;
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    if (0 < p_sub->count) {
+        *pp_sample = p_sub->pp_ring[p_sub->tail];
+        p_sub->tail = (uint16_t)((p_sub->tail + 1) % p_sub->ring_size);
+        p_sub->count--;
+        result = SM_OK;
+    }
+    FSP_CRITICAL_SECTION_EXIT;
+    return result;
+}
+
+void sm_sample_release(sm_sample const * p_sample) {
+    FSP_CRITICAL_SECTION_DEFINE;
+    FSP_CRITICAL_SECTION_ENTER;
+    sm_sample_release_locked(p_sample);
+    FSP_CRITICAL_SECTION_EXIT;
+}
+
+uint32_t sm_subscriber_get_pool_drops(void) {
+    return pool_drops;
+}
+
+void sm_subscriber_publish(sm_type type, sm_handle handle, uint8_t const * buffer, uint16_t size, uint32_t sequence) {
+    if (NULL == subscribers) return;
+    sm_sample * p_sample = sm_sample_alloc();
+    if (NULL == p_sample) {
+        // All records are held by slow subscribers
+        pool_drops++;
+        log_warning("Sample pool exhausted");
+        return;
+    }
+    // The sample is copied once, all subscribers get a reference to the same record
+    p_sample->handle = handle;
+    p_sample->sequence = sequence;
+    p_sample->timestamp = utils_systime_get();
+    p_sample->size = size;
+    memcpy(&p_sample->data, buffer, (size <= sizeof(sm_aggregate)) ? size : sizeof(sm_aggregate));
+    for (sm_subscriber * p_sub = subscribers; NULL != p_sub; p_sub = p_sub->p_next) {
+        if (0 != p_sub->handle.value) {
+            if (p_sub->handle.value != handle.value) continue;
+        } else if ((SENSOR_ANY_TYPE != p_sub->type) && (p_sub->type != type)) {
+            continue;
+        }
+        if (NULL != p_sub->p_callback) {
+            p_sub->p_callback(p_sample, p_sub->p_context);
+        }
+        if (NULL != p_sub->pp_ring) {
+            sm_subscriber_push(p_sub, p_sample);
+        }
+    }
+    // Drop the publisher reference, the record is free again if nobody kept it
+    sm_sample_release(p_sample);
+}
@@ -0,0 +1,572 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+/***********************************************************************************************************************
+ * Includes
+ **********************************************************************************************************************/
+#include <string.h>
+#include "rm_figaro.h"
+
+/***********************************************************************************************************************
+ * Macro definitions
+ **********************************************************************************************************************/
+
+#define RM_FIGARO_OPEN                                (0x4649474FUL) // Open state ("FIGO")
+
+/* Layout shared by the current modules: temperature, humidity and gas as 32-bit floats after a 0x80 request, without
+ * CRC. Valid ranges (hundredths): -40 to 125 C, 0 to 100 %RH, -1000 ppm (electrochemical offset) to 1000000 ppm */
+#define RM_FIGARO_DESCRIPTOR_FLOAT32x3                                  \
+    {                                                                   \
+        .request_command = 0x80,                                        \
+        .response_size   = 12,                                          \
+        .prepare_time_us = 200,                                         \
+        .crc_offset      = RM_FIGARO_NO_CRC,                            \
+        .fields          =                                              \
+        {                                                               \
+            [RM_FIGARO_FIELD_TEMPERATURE] = {0, RM_FIGARO_FORMAT_FLOAT32_LE, -4000, 12500}, \
+            [RM_FIGARO_FIELD_HUMIDITY]    = {4, RM_FIGARO_FORMAT_FLOAT32_LE, 0, 10000}, \
+            [RM_FIGARO_FIELD_GAS]         = {8, RM_FIGARO_FORMAT_FLOAT32_LE, -100000, 100000000}, \
+        },                                                              \
+    }
+
+#define RM_FIGARO_CRC8_POLYNOMIAL                     (0x31)
+#define RM_FIGARO_CRC8_INIT                           (0xFF)
+
+/***********************************************************************************************************************
+ * Typedef definitions
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Private function prototypes
+ **********************************************************************************************************************/
+static fsp_err_t rm_figaro_delay_us(rm_figaro_instance_ctrl_t * const p_ctrl, uint32_t const delay_us);
+static fsp_err_t rm_figaro_wait(rm_figaro_instance_ctrl_t * const p_ctrl);
+static fsp_err_t rm_figaro_read_start(rm_figaro_instance_ctrl_t * const p_ctrl, rm_figaro_transfer_t const transfer);
+static fsp_err_t rm_figaro_read_blocking(rm_figaro_instance_ctrl_t * const p_ctrl);
+static void rm_figaro_data_decode(rm_figaro_instance_ctrl_t * const p_ctrl, rm_figaro_data_t * const p_data);
+static fsp_err_t rm_figaro_fixed_data_decode(rm_figaro_instance_ctrl_t * const p_ctrl,
+                                             rm_figaro_fixed_data_t * const  p_data);
+static bool rm_figaro_float_to_fixed(uint32_t const bits, int32_t * const p_value);
+static void rm_figaro_transfer_complete(rm_figaro_instance_ctrl_t * const p_ctrl, rm_comms_event_t const event);
+
+/***********************************************************************************************************************
+ * Private global variables
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Global variables
+ **********************************************************************************************************************/
+rm_figaro_api_t const g_figaro_on_figaro =
+{
+    .open                 = RM_FIGARO_Open,
+    .close                = RM_FIGARO_Close,
+    .requestData          = RM_FIGARO_RequestData,
+    .read                 = RM_FIGARO_Read,
+    .readFixed            = RM_FIGARO_ReadFixed,
+};
+
+rm_figaro_descriptor_t const g_figaro_tgs6810_descriptor = RM_FIGARO_DESCRIPTOR_FLOAT32x3;
+rm_figaro_descriptor_t const g_figaro_tgs5141_descriptor = RM_FIGARO_DESCRIPTOR_FLOAT32x3;
+rm_figaro_descriptor_t const g_figaro_fecs43_descriptor  = RM_FIGARO_DESCRIPTOR_FLOAT32x3;
+rm_figaro_descriptor_t const g_figaro_fecs44_descriptor  = RM_FIGARO_DESCRIPTOR_FLOAT32x3;
+rm_figaro_descriptor_t const g_figaro_fecs50_descriptor  = RM_FIGARO_DESCRIPTOR_FLOAT32x3;
+
+/*******************************************************************************************************************//**
+ * @addtogroup RM_FIGARO
+ * @{
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Functions
+ **********************************************************************************************************************/
+
+/*******************************************************************************************************************//**
+ * @brief Opens and configures a Figaro module. Implements @ref rm_figaro_api_t::open.
+ * Several modules can be open at the same time, each with its own control block and comms device.
+ *
+ * @retval FSP_SUCCESS              Module successfully configured.
+ * @retval FSP_ERR_ASSERTION        Null pointer, or one or more configuration options is invalid.
+ * @retval FSP_ERR_ALREADY_OPEN     Module is already open.
+ **********************************************************************************************************************/
+fsp_err_t RM_FIGARO_Open (rm_figaro_ctrl_t * const p_api_ctrl, rm_figaro_cfg_t const * const p_cfg)
+{
+    fsp_err_t err = FSP_SUCCESS;
+    rm_figaro_instance_ctrl_t * p_ctrl = (rm_figaro_instance_ctrl_t *) p_api_ctrl;
+
+#if RM_FIGARO_CFG_PARAM_CHECKING_ENABLE
+    FSP_ASSERT(NULL != p_ctrl);
+    FSP_ASSERT(NULL != p_cfg);
+    FSP_ASSERT(NULL != p_cfg->p_instance);
+    FSP_ASSERT(NULL != p_cfg->p_descriptor);
+    FSP_ASSERT(RM_FIGARO_MAX_RESPONSE_SIZE >= p_cfg->p_descriptor->response_size);
+    for (uint32_t i = 0; i < RM_FIGARO_FIELD_NUM; i++)
+    {
+        FSP_ASSERT(p_cfg->p_descriptor->response_size >= (p_cfg->p_descriptor->fields[i].offset + sizeof(float)));
+    }
+    FSP_ASSERT((RM_FIGARO_NO_CRC == p_cfg->p_descriptor->crc_offset) ||
+               (p_cfg->p_descriptor->response_size > p_cfg->p_descriptor->crc_offset));
+    FSP_ERROR_RETURN(RM_FIGARO_OPEN != p_ctrl->open, FSP_ERR_ALREADY_OPEN);
+#endif
+
+    p_ctrl->p_cfg                  = p_cfg;
+    p_ctrl->p_descriptor           = p_cfg->p_descriptor;
+    p_ctrl->p_comms_i2c_instance   = p_cfg->p_instance;
+    p_ctrl->p_context              = p_cfg->p_context;
+    p_ctrl->p_callback             = p_cfg->p_callback;
+    p_ctrl->transfer               = RM_FIGARO_TRANSFER_NONE;
+    p_ctrl->p_data                 = NULL;
+    p_ctrl->p_fixed_data           = NULL;
+
+    /* Open Communications middleware */
+    err = p_ctrl->p_comms_i2c_instance->p_api->open(p_ctrl->p_comms_i2c_instance->p_ctrl,
+                                                    p_ctrl->p_comms_i2c_instance->p_cfg);
+    FSP_ERROR_RETURN(FSP_SUCCESS == err, err);
+
+    /* Set open flag */
+    p_ctrl->open = RM_FIGARO_OPEN;
+
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief Disables specified Figaro control block. Implements @ref rm_figaro_api_t::close.
+ *
+ * @retval FSP_SUCCESS              Successfully closed.
+ * @retval FSP_ERR_ASSERTION        Null pointer passed as a parameter.
+ * @retval FSP_ERR_NOT_OPEN         Module is not open.
+ **********************************************************************************************************************/
+fsp_err_t RM_FIGARO_Close (rm_figaro_ctrl_t * const p_api_ctrl)
+{
+    rm_figaro_instance_ctrl_t * p_ctrl = (rm_figaro_instance_ctrl_t *) p_api_ctrl;
+
+#if RM_FIGARO_CFG_PARAM_CHECKING_ENABLE
+    FSP_ASSERT(NULL != p_ctrl);
+    FSP_ERROR_RETURN(RM_FIGARO_OPEN == p_ctrl->open, FSP_ERR_NOT_OPEN);
+#endif
+
+    /* Close Communications Middleware */
+    p_ctrl->p_comms_i2c_instance->p_api->close(p_ctrl->p_comms_i2c_instance->p_ctrl);
+
+    /* Clear Open flag, a transfer still in progress is abandoned */
+    p_ctrl->open = 0;
+    p_ctrl->transfer = RM_FIGARO_TRANSFER_NONE;
+
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief Requests data from the module without waiting, the callback is called once the request is sent.
+ * Implements @ref rm_figaro_api_t::requestData.
+ *
+ * @retval FSP_SUCCESS              Successfully started.
+ * @retval FSP_ERR_ASSERTION        Null pointer, or one or more configuration options is invalid.
+ * @retval FSP_ERR_NOT_OPEN         Module is not open.
+ * @retval FSP_ERR_IN_USE           A transfer is in progress.
+ **********************************************************************************************************************/
+fsp_err_t RM_FIGARO_RequestData (rm_figaro_ctrl_t * const p_api_ctrl)
+{
+    fsp_err_t err = FSP_SUCCESS;
+    rm_figaro_instance_ctrl_t * p_ctrl = (rm_figaro_instance_ctrl_t *) p_api_ctrl;
+
+#if RM_FIGARO_CFG_PARAM_CHECKING_ENABLE
+    FSP_ASSERT(NULL != p_ctrl);
+    FSP_ASSERT(NULL != p_ctrl->p_callback);
+    FSP_ERROR_RETURN(RM_FIGARO_OPEN == p_ctrl->open, FSP_ERR_NOT_OPEN);
+#endif
+    FSP_ERROR_RETURN(RM_FIGARO_TRANSFER_NONE == p_ctrl->transfer, FSP_ERR_IN_USE);
+
+    /* Request data command */
+    p_ctrl->buf[0]   = p_ctrl->p_descriptor->request_command;
+    p_ctrl->transfer = RM_FIGARO_TRANSFER_REQUEST;
+
+    err = p_ctrl->p_comms_i2c_instance->p_api->write(p_ctrl->p_comms_i2c_instance->p_ctrl, p_ctrl->buf, 1);
+    if (FSP_SUCCESS != err)
+    {
+        p_ctrl->transfer = RM_FIGARO_TRANSFER_NONE;
+    }
+
+    return err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief Reads data from the module.
+ * Without callback, the data is requested and read before returning. With a callback, only the read of the data
+ * requested with RM_FIGARO_RequestData() is started, p_data is decoded before the callback is called.
+ * Implements @ref rm_figaro_api_t::read.
+ *
+ * @retval FSP_SUCCESS              Successfully data decoded (or read started, with a callback).
+ * @retval FSP_ERR_ASSERTION        Null pointer, or one or more configuration options is invalid.
+ * @retval FSP_ERR_NOT_OPEN         Module is not open.
+ * @retval FSP_ERR_IN_USE           A transfer is in progress.
+ * @retval FSP_ERR_INVALID_HW_CONDITION  The module did not acknowledge.
+ * @retval FSP_ERR_TIMEOUT          Without callback, a transfer did not complete in time (the bus needs a recovery).
+ **********************************************************************************************************************/
+fsp_err_t RM_FIGARO_Read (rm_figaro_ctrl_t * const p_api_ctrl, rm_figaro_data_t * const p_data)
+{
+    fsp_err_t err = FSP_SUCCESS;
+    rm_figaro_instance_ctrl_t * p_ctrl = (rm_figaro_instance_ctrl_t *) p_api_ctrl;
+
+#if RM_FIGARO_CFG_PARAM_CHECKING_ENABLE
+    FSP_ASSERT(NULL != p_ctrl);
+    FSP_ASSERT(NULL != p_data);
+    FSP_ERROR_RETURN(RM_FIGARO_OPEN == p_ctrl->open, FSP_ERR_NOT_OPEN);
+#endif
+    FSP_ERROR_RETURN(RM_FIGARO_TRANSFER_NONE == p_ctrl->transfer, FSP_ERR_IN_USE);
+
+    if (NULL != p_ctrl->p_callback)
+    {
+        /* Split-phase read, completed in the I2C Communications Middleware callback */
+        p_ctrl->p_data = p_data;
+
+        return rm_figaro_read_start(p_ctrl, RM_FIGARO_TRANSFER_READ);
+    }
+
+    err = rm_figaro_read_blocking(p_ctrl);
+    FSP_ERROR_RETURN(FSP_SUCCESS == err, err);
+
+    rm_figaro_data_decode(p_ctrl, p_data);
+
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief Reads data from the module in fixed point (hundredths of the unit), as RM_FIGARO_Read().
+ * The frame is decoded in one pass without floating-point operations, the result is bit-exact with the float data
+ * multiplied by 100 and truncated. A frame with a wrong CRC, a NaN or a value out of the range of the descriptor is
+ * rejected and p_data is left unchanged (RM_FIGARO_EVENT_INVALID_DATA with a callback).
+ * Implements @ref rm_figaro_api_t::readFixed.
+ *
+ * @retval FSP_SUCCESS              Successfully data decoded (or read started, with a callback).
+ * @retval FSP_ERR_ASSERTION        Null pointer, or one or more configuration options is invalid.
+ * @retval FSP_ERR_NOT_OPEN         Module is not open.
+ * @retval FSP_ERR_IN_USE           A transfer is in progress.
+ * @retval FSP_ERR_INVALID_HW_CONDITION  The module did not acknowledge.
+ * @retval FSP_ERR_SENSOR_INVALID_DATA   The data frame is invalid.
+ * @retval FSP_ERR_TIMEOUT          Without callback, a transfer did not complete in time (the bus needs a recovery).
+ **********************************************************************************************************************/
+fsp_err_t RM_FIGARO_ReadFixed (rm_figaro_ctrl_t * const p_api_ctrl, rm_figaro_fixed_data_t * const p_data)
+{
+    fsp_err_t err = FSP_SUCCESS;
+    rm_figaro_instance_ctrl_t * p_ctrl = (rm_figaro_instance_ctrl_t *) p_api_ctrl;
+
+#if RM_FIGARO_CFG_PARAM_CHECKING_ENABLE
+    FSP_ASSERT(NULL != p_ctrl);
+    FSP_ASSERT(NULL != p_data);
+    FSP_ERROR_RETURN(RM_FIGARO_OPEN == p_ctrl->open, FSP_ERR_NOT_OPEN);
+#endif
+    FSP_ERROR_RETURN(RM_FIGARO_TRANSFER_NONE == p_ctrl->transfer, FSP_ERR_IN_USE);
+
+    if (NULL != p_ctrl->p_callback)
+    {
+        /* Split-phase read, completed in the I2C Communications Middleware callback */
+        p_ctrl->p_fixed_data = p_data;
+
+        return rm_figaro_read_start(p_ctrl, RM_FIGARO_TRANSFER_READ_FIXED);
+    }
+
+    err = rm_figaro_read_blocking(p_ctrl);
+    FSP_ERROR_RETURN(FSP_SUCCESS == err, err);
+
+    return rm_figaro_fixed_data_decode(p_ctrl, p_data);
+}
+
+/*******************************************************************************************************************//**
+ * @} (end addtogroup RM_FIGARO)
+ **********************************************************************************************************************/
+/*******************************************************************************************************************//**
+ * @brief Figaro callback function called in the I2C Communications Middleware callback function.
+ * p_context of the comms device must point to the Figaro control block of the module.
+ **********************************************************************************************************************/
+void rm_figaro_comms_callback (rm_comms_callback_args_t * p_args)
+{
+    rm_figaro_instance_ctrl_t * p_ctrl = (rm_figaro_instance_ctrl_t *) p_args->p_context;
+
+    if (NULL == p_ctrl)
+    {
+        return;
+    }
+    if (RM_COMMS_EVENT_OPERATION_COMPLETE == p_args->event)
+    {
+        p_ctrl->completed = true;
+    }
+    if (RM_COMMS_EVENT_ERROR == p_args->event)
+    {
+        p_ctrl->nack = true;
+    }
+    if (RM_FIGARO_TRANSFER_NONE != p_ctrl->transfer)
+    {
+        rm_figaro_transfer_complete(p_ctrl, p_args->event);
+    }
+}
+
+/***********************************************************************************************************************
+ * Private Functions
+ **********************************************************************************************************************/
+/*******************************************************************************************************************//**
+ * @brief Delay some microseconds.
+ *
+ * @retval FSP_SUCCESS              successfully configured.
+ **********************************************************************************************************************/
+static fsp_err_t rm_figaro_delay_us (rm_figaro_instance_ctrl_t * const p_ctrl, uint32_t const delay_us)
+{
+    FSP_PARAMETER_NOT_USED(p_ctrl);
+
+    /* Software delay */
+    R_BSP_SoftwareDelay(delay_us, BSP_DELAY_UNITS_MICROSECONDS);
+
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief Wait for the end of a blocking transfer of this instance, at most RM_FIGARO_CFG_WAIT_TIMEOUT_US.
+ *
+ * @retval FSP_SUCCESS                   Transfer complete.
+ * @retval FSP_ERR_INVALID_HW_CONDITION  The module did not acknowledge.
+ * @retval FSP_ERR_TIMEOUT               No callback in time (lost callback or bus held low).
+ **********************************************************************************************************************/
+static fsp_err_t rm_figaro_wait (rm_figaro_instance_ctrl_t * const p_ctrl)
+{
+    uint32_t timeout_us = RM_FIGARO_CFG_WAIT_TIMEOUT_US;
+
+    while (!p_ctrl->completed && !p_ctrl->nack)
+    {
+        /* Wait callback */
+        FSP_ERROR_RETURN(0U < timeout_us, FSP_ERR_TIMEOUT);
+        rm_figaro_delay_us(p_ctrl, 1);
+        timeout_us--;
+    }
+
+    return p_ctrl->nack ? FSP_ERR_INVALID_HW_CONDITION : FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief Start the read of the data frame requested with RM_FIGARO_RequestData().
+ *
+ * @retval FSP_SUCCESS              Read started.
+ **********************************************************************************************************************/
+static fsp_err_t rm_figaro_read_start (rm_figaro_instance_ctrl_t * const p_ctrl, rm_figaro_transfer_t const transfer)
+{
+    fsp_err_t err = FSP_SUCCESS;
+
+    p_ctrl->transfer = transfer;
+
+    err = p_ctrl->p_comms_i2c_instance->p_api->read(p_ctrl->p_comms_i2c_instance->p_ctrl, p_ctrl->buf,
+                                                    p_ctrl->p_descriptor->response_size);
+    if (FSP_SUCCESS != err)
+    {
+        p_ctrl->transfer = RM_FIGARO_TRANSFER_NONE;
+    }
+
+    return err;
+}
+
+/*******************************************************************************************************************//**
+ * @brief Request and read a data frame into the buffer, waiting for each transfer.
+ *
+ * @retval FSP_SUCCESS                   Data frame in the buffer.
+ * @retval FSP_ERR_INVALID_HW_CONDITION  The module did not acknowledge.
+ * @retval FSP_ERR_TIMEOUT               A transfer did not complete in time.
+ **********************************************************************************************************************/
+static fsp_err_t rm_figaro_read_blocking (rm_figaro_instance_ctrl_t * const p_ctrl)
+{
+    fsp_err_t err = FSP_SUCCESS;
+
+    /* Request data command */
+    p_ctrl->buf[0]    = p_ctrl->p_descriptor->request_command;
+    p_ctrl->completed = false;
+    p_ctrl->nack      = false;
+
+    err = p_ctrl->p_comms_i2c_instance->p_api->write(p_ctrl->p_comms_i2c_instance->p_ctrl, p_ctrl->buf, 1);
+    FSP_ERROR_RETURN(FSP_SUCCESS == err, err);
+    err = rm_figaro_wait(p_ctrl);
+    FSP_ERROR_RETURN(FSP_SUCCESS == err, err);
+
+    rm_figaro_delay_us(p_ctrl, p_ctrl->p_descriptor->prepare_time_us);
+
+    /* Read data frame */
+    p_ctrl->completed = false;
+    p_ctrl->nack      = false;
+
+    err = p_ctrl->p_comms_i2c_instance->p_api->read(p_ctrl->p_comms_i2c_instance->p_ctrl, p_ctrl->buf,
+                                                    p_ctrl->p_descriptor->response_size);
+    FSP_ERROR_RETURN(FSP_SUCCESS == err, err);
+
+    return rm_figaro_wait(p_ctrl);
+}
+
+/*******************************************************************************************************************//**
+ * @brief Decode the data frame in the buffer, as laid out by the descriptor.
+ **********************************************************************************************************************/
+static void rm_figaro_data_decode (rm_figaro_instance_ctrl_t * const p_ctrl, rm_figaro_data_t * const p_data)
+{
+    float * p_fields[RM_FIGARO_FIELD_NUM] = {&p_data->temperature, &p_data->humidity, &p_data->gas};
+
+    for (uint32_t i = 0; i < RM_FIGARO_FIELD_NUM; i++)
+    {
+        /* RM_FIGARO_FORMAT_FLOAT32_LE, the MCU is little endian */
+        memcpy(p_fields[i], &p_ctrl->buf[p_ctrl->p_descriptor->fields[i].offset], sizeof(float));
+    }
+}
+
+/*******************************************************************************************************************//**
+ * @brief Decode and check the data frame in the buffer in fixed point, in one pass over the fields.
+ *
+ * @retval FSP_SUCCESS                   Data decoded.
+ * @retval FSP_ERR_SENSOR_INVALID_DATA   Wrong CRC, NaN or value out of range, p_data is unchanged.
+ **********************************************************************************************************************/
+static fsp_err_t rm_figaro_fixed_data_decode (rm_figaro_instance_ctrl_t * const p_ctrl,
+                                              rm_figaro_fixed_data_t * const  p_data)
+{
+    rm_figaro_descriptor_t const * p_descriptor = p_ctrl->p_descriptor;
+    int32_t values[RM_FIGARO_FIELD_NUM];
+
+    if (RM_FIGARO_NO_CRC != p_descriptor->crc_offset)
+    {
+        uint8_t crc = RM_FIGARO_CRC8_INIT;
+        for (uint32_t i = 0; i < p_descriptor->crc_offset; i++)
+        {
+            crc ^= p_ctrl->buf[i];
+            for (uint32_t bit = 0; bit < 8; bit++)
+            {
+                crc = (uint8_t) ((crc & 0x80U) ? ((crc << 1) ^ RM_FIGARO_CRC8_POLYNOMIAL) : (crc << 1));
+            }
+        }
+
+        FSP_ERROR_RETURN(p_ctrl->buf[p_descriptor->crc_offset] == crc, FSP_ERR_SENSOR_INVALID_DATA);
+    }
+
+    for (uint32_t i = 0; i < RM_FIGARO_FIELD_NUM; i++)
+    {
+        /* RM_FIGARO_FORMAT_FLOAT32_LE, the MCU is little endian, a single load at any offset */
+        uint32_t bits;
+        memcpy(&bits, &p_ctrl->buf[p_descriptor->fields[i].offset], sizeof(uint32_t));
+
+        FSP_ERROR_RETURN(rm_figaro_float_to_fixed(bits, &values[i]), FSP_ERR_SENSOR_INVALID_DATA);
+        FSP_ERROR_RETURN((values[i] >= p_descriptor->fields[i].min) && (values[i] <= p_descriptor->fields[i].max),
+                         FSP_ERR_SENSOR_INVALID_DATA);
+    }
+
+    p_data->temperature = values[RM_FIGARO_FIELD_TEMPERATURE];
+    p_data->humidity    = values[RM_FIGARO_FIELD_HUMIDITY];
+    p_data->gas         = values[RM_FIGARO_FIELD_GAS];
+
+    return FSP_SUCCESS;
+}
+
+/*******************************************************************************************************************//**
+ * @brief Convert an IEEE 754 single to hundredths, as (int32_t) (value * 100.0F) does: the product is rounded to single
+ * precision (to nearest, ties to even) and truncated toward zero. Without a single-precision FPU, the conversion is
+ * done with integer operations only and gives the same result.
+ *
+ * @retval true                     Converted.
+ * @retval false                    NaN, infinity or out of the int32_t range.
+ **********************************************************************************************************************/
+static bool rm_figaro_float_to_fixed (uint32_t const bits, int32_t * const p_value)
+{
+#if defined(__ARM_FP) && (__ARM_FP & 0x4)
+    float value;
+
+    memcpy(&value, &bits, sizeof(float));
+    value *= (float) RM_FIGARO_FIXED_SCALE;
+
+    /* Also false for NaN */
+    if (!((value > -2147483648.0F) && (value < 2147483648.0F)))
+    {
+        return false;
+    }
+
+    *p_value = (int32_t) value;
+
+    return true;
+#else
+    uint32_t exponent = (bits >> 23) & 0xFFU;
+    uint32_t product;
+    uint32_t drop;
+    uint32_t rest;
+    uint32_t half;
+    int32_t  shift;
+    uint32_t magnitude;
+
+    if (0xFFU == exponent)
+    {
+        return false;
+    }
+
+    if (0U == exponent)
+    {
+        /* Zero or subnormal, far below 0.01 */
+        *p_value = 0;
+
+        return true;
+    }
+
+    /* 24-bit significand times 100 is a 30 or 31-bit product, keep its 24 most significant bits */
+    product = ((bits & 0x7FFFFFU) | 0x800000U) * RM_FIGARO_FIXED_SCALE;
+    drop    = (product >= 0x40000000U) ? 7U : 6U;
+    rest    = product & ((1U << drop) - 1U);
+    half    = 1U << (drop - 1U);
+    product >>= drop;
+    if ((rest > half) || ((rest == half) && (product & 1U)))
+    {
+        product++;
+    }
+
+    /* Value is product * 2^(exponent - 150 + drop) */
+    shift = (int32_t) exponent - 150 + (int32_t) drop;
+    if (shift >= 0)
+    {
+        if (shift > 7)
+        {
+            return false;
+        }
+
+        magnitude = product << shift;
+    }
+    else
+    {
+        magnitude = (shift > -32) ? (product >> -shift) : 0U;
+    }
+
+    if (magnitude > (uint32_t) INT32_MAX)
+    {
+        return false;
+    }
+
+    *p_value = (bits & 0x80000000U) ? -(int32_t) magnitude : (int32_t) magnitude;
+
+    return true;
+#endif
+}
+
+/*******************************************************************************************************************//**
+ * @brief End a split-phase transfer and notify the user, called from the I2C Communications Middleware callback.
+ **********************************************************************************************************************/
+static void rm_figaro_transfer_complete (rm_figaro_instance_ctrl_t * const p_ctrl, rm_comms_event_t const event)
+{
+    rm_figaro_callback_args_t figaro_callback_args;
+
+    figaro_callback_args.p_context = p_ctrl->p_context;
+    figaro_callback_args.event     = RM_FIGARO_EVENT_ERROR;
+    if (RM_COMMS_EVENT_OPERATION_COMPLETE == event)
+    {
+        figaro_callback_args.event = RM_FIGARO_EVENT_SUCCESS;
+        if (RM_FIGARO_TRANSFER_READ == p_ctrl->transfer)
+        {
+            rm_figaro_data_decode(p_ctrl, p_ctrl->p_data);
+        }
+        else if ((RM_FIGARO_TRANSFER_READ_FIXED == p_ctrl->transfer) &&
+                 (FSP_SUCCESS != rm_figaro_fixed_data_decode(p_ctrl, p_ctrl->p_fixed_data)))
+        {
+            figaro_callback_args.event = RM_FIGARO_EVENT_INVALID_DATA;
+        }
+    }
+    p_ctrl->transfer = RM_FIGARO_TRANSFER_NONE;
+
+    if (NULL != p_ctrl->p_callback)
+    {
+        p_ctrl->p_callback(&figaro_callback_args);
+    }
+}
@@ -0,0 +1,108 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+/*******************************************************************************************************************//**
+ * @addtogroup RM_FIGARO
+ * @{
+ **********************************************************************************************************************/
+
+#ifndef RM_FIGARO_H
+#define RM_FIGARO_H
+
+/***********************************************************************************************************************
+ * Includes
+ **********************************************************************************************************************/
+#include "rm_figaro_api.h"
+
+#if defined(__CCRX__) || defined(__ICCRX__) || defined(__RX__)
+ #include "r_figaro_rx_config.h"
+#elif defined(__CCRL__) || defined(__ICCRL__) || defined(__RL78__)
+ #include "r_figaro_rl_config.h"
+#else
+ #include "rm_figaro_cfg.h"
+
+/* Common macro for FSP header files. There is also a corresponding FSP_FOOTER macro at the end of this file. */
+FSP_HEADER
+#endif
+
+/**********************************************************************************************************************
+ * Macro definitions
+ **********************************************************************************************************************/
+
+/***********************************************************************************************************************
+ * Typedef definitions
+ **********************************************************************************************************************/
+
+/** Figaro split-phase transfer in progress */
+typedef enum e_rm_figaro_transfer
+{
+    RM_FIGARO_TRANSFER_NONE = 0,
+    RM_FIGARO_TRANSFER_REQUEST,        ///< Data request command being sent
+    RM_FIGARO_TRANSFER_READ,           ///< Data frame being read
+    RM_FIGARO_TRANSFER_READ_FIXED,     ///< Data frame being read, decoded in fixed point
+} rm_figaro_transfer_t;
+
+/** Figaro Control Block, each module on the bus has its own so transfers never share completion state */
+typedef struct rm_figaro_instance_ctrl
+{
+    uint32_t                             open;                 ///< Open flag
+    rm_figaro_cfg_t const              * p_cfg;                ///< Pointer to Figaro Configuration
+    rm_figaro_descriptor_t const       * p_descriptor;         ///< Protocol of the module
+    rm_comms_instance_t const          * p_comms_i2c_instance; ///< Pointer of I2C Communications Middleware instance structure
+    void const                         * p_context;            ///< Pointer to the user-provided context
+    uint8_t buf[RM_FIGARO_MAX_RESPONSE_SIZE];                  ///< Buffer for I2C communications
+    volatile rm_figaro_transfer_t        transfer;             ///< Split-phase transfer in progress
+    volatile bool                        completed;            ///< Blocking read, the transfer is complete
+    volatile bool                        nack;                 ///< Blocking read, the transfer failed
+    rm_figaro_data_t                   * p_data;               ///< Where the frame being read is decoded
+    rm_figaro_fixed_data_t             * p_fixed_data;         ///< Where the frame being read is decoded (readFixed)
+
+    /* Pointer to callback and optional working memory */
+    void (* p_callback)(rm_figaro_callback_args_t * p_args);
+} rm_figaro_instance_ctrl_t;
+
+/**********************************************************************************************************************
+ * Exported global variables
+ **********************************************************************************************************************/
+
+/** @cond INC_HEADER_DEFS_SEC */
+/** Filled in Interface API structure for this Instance. */
+extern rm_figaro_api_t const g_figaro_on_figaro;
+
+/** Protocol descriptors of the supported modules. */
+extern rm_figaro_descriptor_t const g_figaro_tgs6810_descriptor;
+extern rm_figaro_descriptor_t const g_figaro_tgs5141_descriptor;
+extern rm_figaro_descriptor_t const g_figaro_fecs43_descriptor;
+extern rm_figaro_descriptor_t const g_figaro_fecs44_descriptor;
+extern rm_figaro_descriptor_t const g_figaro_fecs50_descriptor;
+
+/** @endcond */
+
+/**********************************************************************************************************************
+ * Public Function Prototypes
+ **********************************************************************************************************************/
+fsp_err_t RM_FIGARO_Open(rm_figaro_ctrl_t * const p_api_ctrl, rm_figaro_cfg_t const * const p_cfg);
+fsp_err_t RM_FIGARO_Close(rm_figaro_ctrl_t * const p_api_ctrl);
+fsp_err_t RM_FIGARO_RequestData(rm_figaro_ctrl_t * const p_api_ctrl);
+fsp_err_t RM_FIGARO_Read(rm_figaro_ctrl_t * const p_api_ctrl, rm_figaro_data_t * const p_data);
+fsp_err_t RM_FIGARO_ReadFixed(rm_figaro_ctrl_t * const p_api_ctrl, rm_figaro_fixed_data_t * const p_data);
+
+/* I2C Communications Middleware callback, p_context of the comms device is the Figaro control block */
+void rm_figaro_comms_callback(rm_comms_callback_args_t * p_args);
+
+#if defined(__CCRX__) || defined(__ICCRX__) || defined(__RX__)
+#elif defined(__CCRL__) || defined(__ICCRL__) || defined(__RL78__)
+#else
+
+/* Common macro for FSP header files. There is also a corresponding FSP_FOOTER macro at the end of this file. */
+FSP_FOOTER
+#endif
+
+#endif                                 /* RM_FIGARO_H_*/
+
+/*******************************************************************************************************************//**
+ * @} (end addtogroup RM_FIGARO)
+ **********************************************************************************************************************/
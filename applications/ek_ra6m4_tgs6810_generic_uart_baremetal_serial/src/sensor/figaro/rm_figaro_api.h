@@ -0,0 +1,207 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+/*******************************************************************************************************************//**
+ * @ingroup RENESAS_SENSOR_INTERFACES
+ * @defgroup RM_FIGARO_API Figaro Digital Module Middleware Interface
+ * @brief Interface for Figaro digital gas sensor modules (TGS6810, TGS5141, FECS43, FECS44, FECS50).
+ *
+ * @section RM_FIGARO_API_Summary Summary
+ * The modules share one protocol: a request command, then a data frame holding temperature, humidity and gas
+ * concentration. The command, the frame size and the position of each field are given by a protocol descriptor.
+ * The data is returned as floats (read) or, checked against the valid range of each field, in fixed point (readFixed).
+ *
+ *
+ * @{
+ **********************************************************************************************************************/
+
+#ifndef RM_FIGARO_API_H_
+#define RM_FIGARO_API_H_
+
+/***********************************************************************************************************************
+ * Includes
+ **********************************************************************************************************************/
+#if defined(__CCRX__) || defined(__ICCRX__) || defined(__RX__)
+ #include <string.h>
+ #include "platform.h"
+#elif defined(__CCRL__) || defined(__ICCRL__) || defined(__RL78__)
+ #include <string.h>
+ #include "r_cg_macrodriver.h"
+ #include "r_fsp_error.h"
+#else
+ #include "bsp_api.h"
+#endif
+
+#include "rm_comms_api.h"
+
+#if defined(__CCRX__) || defined(__ICCRX__) || defined(__RX__)
+#elif defined(__CCRL__) || defined(__ICCRL__) || defined(__RL78__)
+#else
+
+/* Common macro for FSP header files. There is also a corresponding FSP_FOOTER macro at the end of this file. */
+FSP_HEADER
+#endif
+
+/**********************************************************************************************************************
+ * Macro definitions
+ **********************************************************************************************************************/
+#define RM_FIGARO_MAX_RESPONSE_SIZE                   (16) ///< Largest data frame of the supported modules
+#define RM_FIGARO_NO_CRC                              (0xFF) ///< The data frame has no CRC
+#define RM_FIGARO_FIXED_SCALE                         (100)  ///< Fixed-point data is in hundredths of the unit
+
+/**********************************************************************************************************************
+ * Typedef definitions
+ **********************************************************************************************************************/
+
+/** Event in the callback function */
+typedef enum e_rm_figaro_event
+{
+    RM_FIGARO_EVENT_SUCCESS = 0,
+    RM_FIGARO_EVENT_ERROR,
+    RM_FIGARO_EVENT_INVALID_DATA,      ///< readFixed only, the frame failed the CRC or range checks
+} rm_figaro_event_t;
+
+/** Fields of a data frame */
+typedef enum e_rm_figaro_field
+{
+    RM_FIGARO_FIELD_TEMPERATURE = 0,
+    RM_FIGARO_FIELD_HUMIDITY,
+    RM_FIGARO_FIELD_GAS,
+    RM_FIGARO_FIELD_NUM,
+} rm_figaro_field_t;
+
+/** Encoding of a field */
+typedef enum e_rm_figaro_format
+{
+    RM_FIGARO_FORMAT_FLOAT32_LE = 0,   ///< IEEE 754 single precision, little endian
+} rm_figaro_format_t;
+
+/** Position, encoding and valid range of a field in the data frame */
+typedef struct st_rm_figaro_field_layout
+{
+    uint8_t            offset;         ///< Offset of the field in the frame
+    rm_figaro_format_t format;         ///< Encoding of the field
+    int32_t            min;            ///< Smallest valid value, in hundredths (readFixed only)
+    int32_t            max;            ///< Largest valid value, in hundredths (readFixed only)
+} rm_figaro_field_layout_t;
+
+/** Protocol of a Figaro module */
+typedef struct st_rm_figaro_descriptor
+{
+    uint8_t                  request_command;                ///< Command requesting a data frame
+    uint8_t                  response_size;                  ///< Size of the data frame (RM_FIGARO_MAX_RESPONSE_SIZE max.)
+    uint16_t                 prepare_time_us;                ///< Time to prepare the data frame after a request
+    uint8_t                  crc_offset;                     ///< Offset of the CRC-8 of the preceding bytes, RM_FIGARO_NO_CRC if none
+    rm_figaro_field_layout_t fields[RM_FIGARO_FIELD_NUM];    ///< Layout of the frame
+} rm_figaro_descriptor_t;
+
+/** Figaro callback parameter definition */
+typedef struct st_rm_figaro_callback_args
+{
+    void const      * p_context;
+    rm_figaro_event_t event;
+} rm_figaro_callback_args_t;
+
+/** Figaro data */
+typedef struct st_rm_figaro_data
+{
+    float temperature;
+    float humidity;
+    float gas;
+} rm_figaro_data_t;
+
+/** Figaro data in fixed point, hundredths of the unit (ie.: 2512 is 25.12 C), as Sensor Manager expects it */
+typedef struct st_rm_figaro_fixed_data
+{
+    int32_t temperature;
+    int32_t humidity;
+    int32_t gas;
+} rm_figaro_fixed_data_t;
+
+/** Figaro Configuration */
+typedef struct st_rm_figaro_cfg
+{
+    rm_comms_instance_t const    * p_instance;                 ///< Pointer to Communications Middleware instance.
+    rm_figaro_descriptor_t const * p_descriptor;               ///< Protocol of the module.
+    void const                   * p_context;                  ///< Pointer to the user-provided context.
+    void const                   * p_extend;                   ///< Pointer to extended configuration by instance of interface.
+    void (* p_callback)(rm_figaro_callback_args_t * p_args);   ///< Pointer to callback function.
+} rm_figaro_cfg_t;
+
+/** Figaro control block.  Allocate an instance specific control block to pass into the Figaro API calls.
+ */
+typedef void rm_figaro_ctrl_t;
+
+/** Figaro APIs */
+typedef struct st_rm_figaro_api
+{
+    /** Open sensor.
+     *
+     * @param[in]  p_ctrl       Pointer to control structure.
+     * @param[in]  p_cfg        Pointer to configuration structure.
+     */
+    fsp_err_t (* open)(rm_figaro_ctrl_t * const p_ctrl, rm_figaro_cfg_t const * const p_cfg);
+
+    /** Request data from the module, the callback is called once the request is sent.
+     * The data can be read prepare_time_us (see the descriptor) later.
+     *
+     * @param[in]  p_ctrl       Pointer to control structure.
+     */
+    fsp_err_t (* requestData)(rm_figaro_ctrl_t * const p_ctrl);
+
+    /** Read data from the module.
+     * Without callback, the data is requested and read before returning.
+     * With a callback, the read is only started after requestData, p_data is valid when the callback is called.
+     *
+     * @param[in]  p_ctrl       Pointer to control structure.
+     * @param[in]  p_data       Pointer to data structure.
+     */
+    fsp_err_t (* read)(rm_figaro_ctrl_t * const p_ctrl, rm_figaro_data_t * const p_data);
+
+    /** Read data from the module in fixed point, as read. The frame is decoded in one pass and checked (CRC, NaN and
+     * range of each field), an invalid frame leaves p_data unchanged.
+     *
+     * @param[in]  p_ctrl       Pointer to control structure.
+     * @param[in]  p_data       Pointer to fixed-point data structure.
+     */
+    fsp_err_t (* readFixed)(rm_figaro_ctrl_t * const p_ctrl, rm_figaro_fixed_data_t * const p_data);
+
+    /** Close the module.
+     *
+     * @param[in]  p_ctrl       Pointer to control structure.
+     */
+    fsp_err_t (* close)(rm_figaro_ctrl_t * const p_ctrl);
+} rm_figaro_api_t;
+
+/** Figaro instance */
+typedef struct st_rm_figaro_instance
+{
+    rm_figaro_ctrl_t      * p_ctrl;    /**< Pointer to the control structure for this instance */
+    rm_figaro_cfg_t const * p_cfg;     /**< Pointer to the configuration structure for this instance */
+    rm_figaro_api_t const * p_api;     /**< Pointer to the API structure for this instance */
+} rm_figaro_instance_t;
+
+/**********************************************************************************************************************
+ * Exported global variables
+ **********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Public Function Prototypes
+ **********************************************************************************************************************/
+
+#if defined(__CCRX__) || defined(__ICCRX__) || defined(__RX__)
+#elif defined(__CCRL__) || defined(__ICCRL__) || defined(__RL78__)
+#else
+
+/* Common macro for FSP header files. There is also a corresponding FSP_FOOTER macro at the end of this file. */
+FSP_FOOTER
+#endif
+
+#endif                                 /* RM_FIGARO_API_H_*/
+
+/*******************************************************************************************************************//**
+ * @} (end defgroup RM_FIGARO_API)
+ **********************************************************************************************************************/
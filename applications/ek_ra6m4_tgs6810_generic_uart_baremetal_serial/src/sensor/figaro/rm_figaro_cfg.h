@@ -0,0 +1,13 @@
+#ifndef RM_FIGARO_CFG_H_
+#define RM_FIGARO_CFG_H_
+#ifdef __cplusplus
+            extern "C" {
+            #endif
+
+#define RM_FIGARO_CFG_PARAM_CHECKING_ENABLE   (BSP_CFG_PARAM_CHECKING_ENABLE)
+#define RM_FIGARO_CFG_WAIT_TIMEOUT_US         (10000)
+
+#ifdef __cplusplus
+            }
+            #endif
+#endif /* RM_FIGARO_CFG_H_ */
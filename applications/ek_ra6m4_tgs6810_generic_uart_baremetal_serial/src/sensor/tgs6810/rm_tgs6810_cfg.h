@@ -1,12 +0,0 @@
-#ifndef RM_TGS6810_CFG_H_
-#define RM_TGS6810_CFG_H_
-#ifdef __cplusplus
-            extern "C" {
-            #endif
-
-#define RM_TGS6810_CFG_PARAM_CHECKING_ENABLE   (BSP_CFG_PARAM_CHECKING_ENABLE)
-
-#ifdef __cplusplus
-            }
-            #endif
-#endif /* RM_TGS6810_CFG_H_ */
@@ -7,6 +7,7 @@
 #include <stdint.h>
 #include "common_utils.h"
 #include "sm_handle.h"
+#include "sm.h"
 #include "i2c.h"
 #include "common_utils.h"
 #include "tgs6810_sensor.h"
@@ -24,112 +25,238 @@
 
 // Number of sensor channels
 #define NUM_CHANNELS 3
+// Maximum number of TGS6810 modules on the bus, one per distinct instance address
+#ifndef TGS6810_MAX_DEVICES
+#define TGS6810_MAX_DEVICES 4
+#endif
 // Interval between each sample
 #define WAITING_INTERVAL_MS  1000
+// Maximum time for an I2C transfer
+#define I2C_TIMEOUT_MS 10
+// Time for the sensor to prepare its data in systime ticks
+#define REQUEST_WAIT_MS ((g_figaro_tgs6810_descriptor.prepare_time_us + 999U) / 1000U)
+
+typedef enum {
+    SENSOR_NEXT_SAMPLE,
+    SENSOR_WAIT_SAMPLE,
+    SENSOR_REQUEST,
+    SENSOR_REQUEST_WAIT,
+    SENSOR_PREPARE_WAIT,
+    SENSOR_READ,
+    SENSOR_READ_WAIT
+} sstate;
+
+// A module at one address, with its own control block, comms device and FSM
+typedef struct {
+    bool used;
+    uint8_t address;                        // 7-bit address, instances with address 0 use the configured one
+    uint8_t channels_open;
+    bool open;                              // the Figaro driver is open, its transfers are not started otherwise
+    sstate state;
+    uint32_t timer;
+    uint32_t acq_interval;
+    bool bus_busy;
+    uint32_t bus_busy_since;                // first attempt on a bus used by another device
+    volatile bool transfer_done;
+    volatile rm_figaro_event_t transfer_event;
+    rm_figaro_fixed_data_t data;            // hundredths, as SM expects them
+    sm_sensor_status status[NUM_CHANNELS];
+    uint8_t data_ready[NUM_CHANNELS];
+    rm_figaro_instance_ctrl_t ctrl;
+    rm_figaro_cfg_t cfg;
+    i2c_device comms;                       // comms device of an address other than the configured one
+} tgs6810_device;
 
-rm_tgs6810_instance_ctrl_t g_tgs6810_sensor0_ctrl;
-const rm_tgs6810_cfg_t g_tgs6810_sensor0_cfg =
+static void tgs6810_sensor_callback(rm_figaro_callback_args_t * p_args);
+
+// TGS6810 module on the generic Figaro driver, each device gets a copy bound to the comms device of its address
+const rm_figaro_cfg_t g_tgs6810_sensor0_cfg =
 {
- .p_instance = &g_comms_i2c_tgs6810,
- .p_callback = NULL,
- .p_context  = NULL,
+ .p_instance   = &g_comms_i2c_tgs6810,
+ .p_descriptor = &g_figaro_tgs6810_descriptor,
+ .p_callback   = tgs6810_sensor_callback,
+ .p_context    = NULL,
 };
-const rm_tgs6810_instance_t g_tgs6810_sensor0 =
-{ .p_ctrl = &g_tgs6810_sensor0_ctrl, .p_cfg = &g_tgs6810_sensor0_cfg, .p_api = &g_tgs6810_on_tgs6810, };
 
 volatile i2c_master_event_t g_master_event = (i2c_master_event_t)0x00;
-static uint8_t data_ready[3] = { 0 };
-static uint8_t channels_open = 0;
-static sm_sensor_status sensor_status[3] = {SM_SENSOR_ERROR};
-static rm_tgs6810_data_t p_data;
-static uint32_t acq_interval = WAITING_INTERVAL_MS;
-
+static tgs6810_device devices[TGS6810_MAX_DEVICES];
+// Device served first by the FSM, the one after the last device that got the bus (round robin)
+static uint8_t first_device = 0;
 
-void tgs6810_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel)
-{
-    fsp_err_t status;
+static uint8_t tgs6810_device_address(uint8_t address) {
+    return (0 == address) ? i2c_get_device_address(g_tgs6810_sensor0_cfg.p_instance) : address;
+}
 
-#if BSP_CFG_RTOS
-    /* Create a semaphore for blocking if a semaphore is not NULL */
-    if (NULL != g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore)
-    {
-#if BSP_CFG_RTOS == 1 // AzureOS
-        tx_semaphore_create(g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_handle,
-                            g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_name,
-                            (ULONG)0);
-#elif BSP_CFG_RTOS == 2 // FreeRTOS
-        *(g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_handle) = xSemaphoreCreateCountingStatic((UBaseType_t)1, (UBaseType_t)0, g_comms_i2c_bus0_extended_cfg.p_blocking_semaphore->p_semaphore_memory);
-#endif
+static tgs6810_device * tgs6810_find_device(uint8_t address) {
+    address = tgs6810_device_address(address);
+    for (int i = 0; i < TGS6810_MAX_DEVICES; i++) {
+        if (devices[i].used && (address == devices[i].address)) return &devices[i];
     }
+    return NULL;
+}
 
-    /* Create a recursive mutex for bus lock if a recursive mutex is not NULL */
-    if (NULL != g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex)
-    {
-#if BSP_CFG_RTOS == 1 // AzureOS
-        tx_mutex_create(g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_handle,
-                        g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_name,
-                        TX_INHERIT);
-#elif BSP_CFG_RTOS == 2 // FreeRTOS
-        *(g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_handle) = xSemaphoreCreateRecursiveMutexStatic(g_comms_i2c_bus0_extended_cfg.p_bus_recursive_mutex->p_mutex_memory);
-#endif
+static tgs6810_device * tgs6810_add_device(uint8_t address) {
+    for (int i = 0; i < TGS6810_MAX_DEVICES; i++) {
+        tgs6810_device * dev = &devices[i];
+        if (dev->used) continue;
+        memset(dev, 0, sizeof(tgs6810_device));
+        dev->used = true;
+        dev->address = tgs6810_device_address(address);
+        // The first measurement starts right away, following ones wait for the acquisition interval
+        dev->state = SENSOR_REQUEST;
+        dev->acq_interval = WAITING_INTERVAL_MS;
+        for (int ch = 0; ch < NUM_CHANNELS; ch++) dev->status[ch] = SM_SENSOR_ERROR;
+        dev->cfg = g_tgs6810_sensor0_cfg;
+        dev->cfg.p_context = dev;
+        dev->cfg.p_instance = i2c_device_create(&dev->comms, g_tgs6810_sensor0_cfg.p_instance, dev->address,
+                                                rm_figaro_comms_callback, &dev->ctrl);
+        return dev;
     }
-#endif
-    if (0 == channels_open) {
-        status = i2c_initialize();
-        if (FSP_SUCCESS != status && FSP_ERR_ALREADY_OPEN != status)
-        {
-            log_error("I2C init failed");
-            APP_TRAP();
+    log_error("Too many tgs6810 devices");
+    return NULL;
+}
+
+// I2C Communications Middleware callback of g_comms_i2c_tgs6810 (see configuration.xml), routed to the device using it
+void tgs6810_callback(rm_comms_callback_args_t * p_args) {
+    for (int i = 0; i < TGS6810_MAX_DEVICES; i++) {
+        if (devices[i].used && (g_tgs6810_sensor0_cfg.p_instance == devices[i].cfg.p_instance)) {
+            rm_comms_callback_args_t args = *p_args;
+            args.p_context = &devices[i].ctrl;
+            rm_figaro_comms_callback(&args);
+            return;
         }
-        status = g_tgs6810_sensor0.p_api->open(g_tgs6810_sensor0.p_ctrl, g_tgs6810_sensor0.p_cfg);
-        if(FSP_SUCCESS != status )
+    }
+}
+
+static void tgs6810_sensor_callback(rm_figaro_callback_args_t * p_args) {
+    tgs6810_device * dev = (tgs6810_device *) p_args->p_context;
+    dev->transfer_event = p_args->event;
+    dev->transfer_done = true;
+    // Let Sensor Manager run the FSM again
+    sm_wake();
+}
+
+// A transfer timed out (lost callback or bus held low): the driver forgets it and the bus is recovered
+static void tgs6810_recover(tgs6810_device * dev) {
+    fsp_err_t status;
+    if (dev->open) g_figaro_on_figaro.close(&dev->ctrl);
+    status = i2c_recover(dev->cfg.p_instance);
+    if (FSP_SUCCESS != status) {
+        log_error("tgs6810 0x%x bus recovery err %d", dev->address, status);
+    }
+    dev->transfer_done = false;
+    status = g_figaro_on_figaro.open(&dev->ctrl, &dev->cfg);
+    dev->open = (FSP_SUCCESS == status);
+    if (FSP_SUCCESS != status) {
+        log_error("tgs6810 0x%x reopen err %d", dev->address, status);
+    }
+}
+
+// Wait for the end of a transfer, only used by the probe (sm_init)
+static fsp_err_t i2c_waiting(tgs6810_device * dev) {
+    uint32_t start = utils_systime_get();
+    while (!dev->transfer_done && (utils_systime_get() - start < I2C_TIMEOUT_MS)) {}
+    if (!dev->transfer_done) {
+        tgs6810_recover(dev);
+        return FSP_ERR_TIMEOUT;
+    }
+    dev->transfer_done = false;
+    return (RM_FIGARO_EVENT_SUCCESS == dev->transfer_event) ? FSP_SUCCESS : FSP_ERR_INVALID_HW_CONDITION;
+}
+
+static fsp_err_t tgs6810_device_open(tgs6810_device * dev) {
+    fsp_err_t status = i2c_initialize();
+    if (FSP_SUCCESS != status && FSP_ERR_ALREADY_OPEN != status) return status;
+    status = g_figaro_on_figaro.open(&dev->ctrl, &dev->cfg);
+    return (FSP_ERR_ALREADY_OPEN == status) ? FSP_SUCCESS : status;
+}
+
+void tgs6810_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel)
+{
+    fsp_err_t status;
+    tgs6810_device * dev;
+
+    handle->address = address;
+    handle->channel = channel;
+    dev = tgs6810_find_device(address);
+    if (NULL == dev) dev = tgs6810_add_device(address);
+    if (NULL == dev) return;
+    if (0 == dev->channels_open) {
+        status = tgs6810_device_open(dev);
+        dev->open = (FSP_SUCCESS == status);
+        if (FSP_SUCCESS != status)
         {
-            // Do something in case of error
+            // The device keeps its channels, its FSM reports the error on each of them until Sensor Manager
+            // recovers them
             log_error("Sensor open err %d", status);
-            APP_TRAP();
         }
     }
-    log_info("Sensor channel %d open success",channel);
-    channels_open++;
-    handle->address = address;
-    handle->channel = channel;
+    if (dev->open) {
+        log_info("Sensor 0x%x channel %d open success", dev->address, channel);
+    }
+    dev->channels_open++;
 }
 
 void tgs6810_sensor_close(sm_handle handle) {
-    // Handle not used here
-    FSP_PARAMETER_NOT_USED(handle);
     fsp_err_t status = FSP_SUCCESS;
-    if (0 == channels_open)
+    tgs6810_device * dev = tgs6810_find_device(handle.address);
+    if ((NULL == dev) || (0 == dev->channels_open))
     {
         log_error("Sensor not open");
     }
     else
     {
-        channels_open--;
-        if (0 == channels_open)
+        dev->channels_open--;
+        if (0 == dev->channels_open)
         {
-            status = g_tgs6810_sensor0.p_api->close(g_tgs6810_sensor0.p_ctrl);
+            // A transfer in progress is abandoned, the device is set up again on the next open
+            if (dev->open) status = g_figaro_on_figaro.close(&dev->ctrl);
             if(FSP_SUCCESS != status)
             {
-                // Do something in case of error
                 log_error("Sensor close err %d", status);
-                APP_TRAP();
             }
+            dev->used = false;
         }
     }
 }
 
+sm_result tgs6810_sensor_probe(uint8_t address)
+{
+    fsp_err_t status;
+    sm_result result = SM_ERROR;
+    tgs6810_device * dev = tgs6810_find_device(address);
+
+    // An address already in use answered before
+    if (NULL != dev) return SM_OK;
+    dev = tgs6810_add_device(address);
+    if (NULL == dev) return SM_ERROR;
+    if (FSP_SUCCESS == tgs6810_device_open(dev)) {
+        // The sensor is present if it answers a data request
+        status = g_figaro_on_figaro.requestData(&dev->ctrl);
+        if ((FSP_SUCCESS == status) && (FSP_SUCCESS == i2c_waiting(dev))) {
+            R_BSP_SoftwareDelay(g_figaro_tgs6810_descriptor.prepare_time_us, BSP_DELAY_UNITS_MICROSECONDS);
+            status = g_figaro_on_figaro.readFixed(&dev->ctrl, &dev->data);
+            if ((FSP_SUCCESS == status) && (FSP_SUCCESS == i2c_waiting(dev))) result = SM_OK;
+        }
+        g_figaro_on_figaro.close(&dev->ctrl);
+    }
+    dev->used = false;
+    return result;
+}
+
 uint8_t * tgs6810_sensor_get_flag(sm_handle handle) {
-    if (handle.channel < NUM_CHANNELS) return &data_ready[handle.channel]; else return NULL;
+    tgs6810_device * dev = tgs6810_find_device(handle.address);
+    if ((NULL != dev) && (handle.channel < NUM_CHANNELS)) return &dev->data_ready[handle.channel]; else return NULL;
 }
 
 sm_result tgs6810_sensor_set_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t value) {
-    FSP_PARAMETER_NOT_USED(handle);	// tgs6810 can't set attributes per channel
+    // The channels of a device share its acquisition interval
     sm_result result = SM_ERROR;
-    if (handle.channel < NUM_CHANNELS) {
+    tgs6810_device * dev = tgs6810_find_device(handle.address);
+    if ((NULL != dev) && (handle.channel < NUM_CHANNELS)) {
         switch (attr) {
             case SM_ACQUISITION_INTERVAL:
-                acq_interval = value;
+                dev->acq_interval = value;
                 result = SM_OK;
                 break;
             default:
@@ -140,12 +267,13 @@ sm_result tgs6810_sensor_set_attr(sm_handle handle, sm_sensor_attributes attr, u
 }
 
 sm_result tgs6810_sensor_get_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t * value) {
-    FSP_PARAMETER_NOT_USED(handle);	// tgs6810 can't get attributes per channel
+    // The channels of a device share its acquisition interval
     sm_result result = SM_ERROR;
-    if (handle.channel < NUM_CHANNELS) {
+    tgs6810_device * dev = tgs6810_find_device(handle.address);
+    if ((NULL != dev) && (handle.channel < NUM_CHANNELS)) {
         switch (attr) {
             case SM_ACQUISITION_INTERVAL:
-                *value = acq_interval;
+                *value = dev->acq_interval;
                 result = SM_OK;
                 break;
             default:
@@ -155,46 +283,163 @@ sm_result tgs6810_sensor_get_attr(sm_handle handle, sm_sensor_attributes attr, u
     return result;
 }
 
-/* Quick getting tgs6810 data*/
 sm_sensor_status tgs6810_sensor_read(sm_handle handle, int32_t * data)
 {
-    static sm_sensor_status status;
-    fsp_err_t err = FSP_SUCCESS;
+    // The FSM reads the sensor, channels only return the last decoded data
+    sm_sensor_status status = SM_SENSOR_ERROR;
+    tgs6810_device * dev = tgs6810_find_device(handle.address);
 
+    if (NULL == dev) return status;
     switch(handle.channel){
         case SM_CH0:
-            err = g_tgs6810_sensor0.p_api->read(g_tgs6810_sensor0.p_ctrl, &p_data);
-            if(err != FSP_SUCCESS)
-            {
-            	status = SM_SENSOR_ERROR;
-                sensor_status[0] = SM_SENSOR_ERROR;
-                sensor_status[1] = SM_SENSOR_ERROR;
-                sensor_status[2] = SM_SENSOR_ERROR;
-                // Do something in case of error
-                log_error("tgs6810 read err %d", err);
-                APP_TRAP();
-            }
-            else
-            {
-                status = SM_SENSOR_DATA_VALID;
-                *data = (int32_t)(p_data.temperature*100);
-                sensor_status[0] = SM_SENSOR_DATA_VALID;
-                sensor_status[1] = SM_SENSOR_DATA_VALID;
-                sensor_status[2] = SM_SENSOR_DATA_VALID;
-            }
+            *data = dev->data.temperature;
             break;
         case SM_CH1:
-            status = sensor_status[1];
-            *data = (int32_t)(p_data.humidity*100);
-            sensor_status[1] = SM_SENSOR_STALE_DATA;
+            *data = dev->data.humidity;
             break;
         case SM_CH2:
-            status = sensor_status[2];
-            *data = (int32_t)(p_data.gas*100);
-            sensor_status[2] = SM_SENSOR_STALE_DATA;
+            *data = dev->data.gas;
             break;
+        default:
+            return status;
     }
+    status = dev->status[handle.channel];
+    dev->status[handle.channel] = SM_SENSOR_STALE_DATA;
     return status;
+}
 
+void tgs6810_sensor_trigger(sm_handle handle) {
+    // All channels share the measurement, a second trigger while measuring is ignored
+    tgs6810_device * dev = tgs6810_find_device(handle.address);
+    if ((NULL != dev) && ((SENSOR_NEXT_SAMPLE == dev->state) || (SENSOR_WAIT_SAMPLE == dev->state))) {
+        dev->state = SENSOR_REQUEST;
+    }
 }
 
+// Flag all channels of a device, so Sensor Manager reads the new status
+static void tgs6810_report(tgs6810_device * dev, sm_sensor_status status) {
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        dev->status[i] = status;
+        dev->data_ready[i] = 1;
+    }
+}
+
+// Start a transfer, a bus busy with another device is retried on the next run (its completion wakes SM up)
+static void tgs6810_start(tgs6810_device * dev, fsp_err_t status, sstate next) {
+    if (FSP_ERR_IN_USE == status) {
+        if (!dev->bus_busy) {
+            dev->bus_busy = true;
+            dev->bus_busy_since = utils_systime_get();
+            return;
+        }
+        // Each other device holds the bus for one transfer at most, longer means a transfer of this one is stuck
+        if (utils_systime_get() - dev->bus_busy_since < (I2C_TIMEOUT_MS * TGS6810_MAX_DEVICES)) return;
+        // or of a device closed meanwhile, nobody else will release the bus
+        tgs6810_recover(dev);
+    }
+    dev->bus_busy = false;
+    if (FSP_SUCCESS != status) {
+        // Sensor Manager recovers the sensor on repeated errors
+        log_error("tgs6810 0x%x transfer err %d", dev->address, status);
+        tgs6810_report(dev, SM_SENSOR_ERROR);
+        dev->state = SENSOR_NEXT_SAMPLE;
+    } else {
+        dev->timer = utils_systime_get();
+        dev->state = next;
+        first_device = (uint8_t)(((dev - devices) + 1) % TGS6810_MAX_DEVICES);
+    }
+}
+
+// Wait for the end of a transfer started by tgs6810_start
+static bool tgs6810_transfer_done(tgs6810_device * dev) {
+    if (dev->transfer_done) {
+        dev->transfer_done = false;
+        if (RM_FIGARO_EVENT_SUCCESS == dev->transfer_event) return true;
+        if (RM_FIGARO_EVENT_INVALID_DATA == dev->transfer_event) {
+            // The last valid data is kept, the module answers again on the next measurement
+            log_error("tgs6810 0x%x invalid data", dev->address);
+            tgs6810_report(dev, SM_SENSOR_INVALID_DATA);
+            dev->state = SENSOR_NEXT_SAMPLE;
+            return false;
+        }
+        log_error("tgs6810 0x%x nack", dev->address);
+    } else if (utils_systime_get() - dev->timer >= I2C_TIMEOUT_MS) {
+        log_error("tgs6810 0x%x timeout", dev->address);
+        tgs6810_recover(dev);
+    } else {
+        return false;
+    }
+    tgs6810_report(dev, SM_SENSOR_ERROR);
+    dev->state = SENSOR_NEXT_SAMPLE;
+    return false;
+}
+
+// Run the FSM of a device, returns the time until it needs to run again
+static uint32_t tgs6810_device_fsm(tgs6810_device * dev) {
+    switch (dev->state) {
+        case SENSOR_NEXT_SAMPLE:
+            dev->timer = utils_systime_get();
+            dev->state = SENSOR_WAIT_SAMPLE;
+            break;
+        case SENSOR_WAIT_SAMPLE:
+            if (utils_systime_get() - dev->timer >= dev->acq_interval) dev->state = SENSOR_REQUEST;
+            break;
+        case SENSOR_REQUEST:
+            dev->transfer_done = false;
+            // A device that failed to open reports the error at each measurement, until it is recovered
+            tgs6810_start(dev, dev->open ? g_figaro_on_figaro.requestData(&dev->ctrl) : FSP_ERR_NOT_OPEN,
+                          SENSOR_REQUEST_WAIT);
+            break;
+        case SENSOR_REQUEST_WAIT:
+            if (tgs6810_transfer_done(dev)) {
+                dev->timer = utils_systime_get();
+                dev->state = SENSOR_PREPARE_WAIT;
+            }
+            break;
+        case SENSOR_PREPARE_WAIT:
+            // The tick may come right after the request, one more tick guarantees the wait
+            if (utils_systime_get() - dev->timer > REQUEST_WAIT_MS) dev->state = SENSOR_READ;
+            break;
+        case SENSOR_READ:
+            dev->transfer_done = false;
+            tgs6810_start(dev, g_figaro_on_figaro.readFixed(&dev->ctrl, &dev->data), SENSOR_READ_WAIT);
+            break;
+        case SENSOR_READ_WAIT:
+            if (tgs6810_transfer_done(dev)) {
+                tgs6810_report(dev, SM_SENSOR_DATA_VALID);
+                dev->state = SENSOR_NEXT_SAMPLE;
+            }
+            break;
+        default:
+            dev->state = SENSOR_NEXT_SAMPLE;
+            break;
+    }
+    uint32_t elapsed = utils_systime_get() - dev->timer;
+    uint32_t wait = 0;
+    if (SENSOR_WAIT_SAMPLE == dev->state) {
+        wait = dev->acq_interval;
+    } else if ((SENSOR_REQUEST_WAIT == dev->state) || (SENSOR_READ_WAIT == dev->state)) {
+        wait = I2C_TIMEOUT_MS;
+    } else if (SENSOR_PREPARE_WAIT == dev->state) {
+        wait = REQUEST_WAIT_MS + 1;
+    } else if ((SENSOR_REQUEST == dev->state) || (SENSOR_READ == dev->state)) {
+        // Waiting for the bus, the transfer of the other device wakes SM up
+        wait = I2C_TIMEOUT_MS;
+        elapsed = 0;
+    }
+    return (elapsed < wait) ? (wait - elapsed) : 0;
+}
+
+void tgs6810_sensor_fsm(void) {
+    // The devices run independently, one can wait for its data while another uses the bus
+    uint8_t first = first_device;
+    uint32_t next = UINT32_MAX;
+    for (int n = 0; n < TGS6810_MAX_DEVICES; n++) {
+        tgs6810_device * dev = &devices[(first + n) % TGS6810_MAX_DEVICES];
+        if (!dev->used || (0 == dev->channels_open)) continue;
+        uint32_t wait = tgs6810_device_fsm(dev);
+        if (wait < next) next = wait;
+    }
+    // Tell Sensor Manager when the FSM needs to run again, completions call sm_wake()
+    if (UINT32_MAX != next) sm_wake_after(next);
+}
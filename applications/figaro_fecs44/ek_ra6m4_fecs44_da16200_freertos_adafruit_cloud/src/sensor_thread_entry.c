@@ -37,6 +37,8 @@
 /*End adding @GLOBAL_VARIABLES code */
 extern TaskHandle_t sensor_thread;
 QueueHandle_t g_sensor_queue;
+/* Messages not sent because the queue was full */
+uint32_t g_sensor_queue_drops = 0;
 
 void g_comms_i2c_bus0_quick_setup(void);
 
@@ -46,7 +48,7 @@ void sensor_thread_entry(void *pvParameters) {
 
 	g_comms_i2c_bus0_quick_setup();
 
-	g_sensor_queue = xQueueCreate(20, SENSOR_DATA_COUNT * sizeof(float));
+	g_sensor_queue = xQueueCreate(20, sizeof(sensor_message_t));
 
 /*Start adding @MAIN_INITIALIZATION code */
 	float data_temperature;
@@ -57,13 +59,21 @@ void sensor_thread_entry(void *pvParameters) {
 
 	vTaskSuspend(sensor_thread);
 
+	uint32_t sequence = 0;
+
 	/* TODO: add your own code here */
 	while (1) {
 /*Start adding @MAIN_LOOP code */
 		g_fecs44_sensor0_read(&data_temperature, &data_humidity, &data_gas);
 		float data[SENSOR_DATA_COUNT] = { data_temperature, data_humidity, data_gas};
 /*End adding @MAIN_LOOP code */
-		xQueueSend(g_sensor_queue, (uint32_t*) data, 0);
+		sensor_message_t message = { .sequence = ++sequence };
+		for (int i = 0; i < SENSOR_DATA_COUNT; i++) {
+			message.data[i] = data[i];
+		}
+		if (pdPASS != xQueueSend(g_sensor_queue, &message, 0)) {
+			g_sensor_queue_drops++;
+		}
 		vTaskDelay(pdMS_TO_TICKS(30000));
 	}
 
@@ -49,6 +49,7 @@ static void ftoa(float n, char *res, int afterpoint);
 extern TaskHandle_t sensor_thread;
 extern TaskHandle_t sub_thread;
 extern QueueHandle_t g_sensor_queue;
+extern uint32_t g_sensor_queue_drops;
 NetworkContext_t xNetworkContext;
 MQTTContext_t mqttContext;
 TlsTransportParams_t transport_params;
@@ -107,12 +108,24 @@ void main_thread_entry(void *pvParameters) {
 	vTaskResume(sub_thread);
 	vTaskResume(sensor_thread);
 
+	uint32_t next_sequence = 0;
+	uint32_t lost_messages = 0;
+
 	/* TODO: add your own code here */
 	while (1) {
-		float sens_data[SENSOR_DATA_COUNT] = { 0 };
+		sensor_message_t message;
+		float *sens_data = message.data;
 		char sensdata[SENSOR_DATA_COUNT][10] = { 0 };
 
-		xQueueReceive(g_sensor_queue, &sens_data, portMAX_DELAY);
+		xQueueReceive(g_sensor_queue, &message, portMAX_DELAY);
+
+		/* A gap in the sequence numbers means messages were dropped by the sensor thread */
+		if ((0 != next_sequence) && (message.sequence != next_sequence)) {
+			lost_messages += message.sequence - next_sequence;
+			printf("Lost %lu sensor messages, %lu since start\r\n",
+					message.sequence - next_sequence, lost_messages);
+		}
+		next_sequence = message.sequence + 1;
 
 		/* Place message in the sensor queue */
 		for (int i = 0; i < SENSOR_DATA_COUNT; i++) {
@@ -130,6 +143,17 @@ void main_thread_entry(void *pvParameters) {
 /*End adding @MAIN_LOOP code */
 			vTaskDelay(pdMS_TO_TICKS(1000));
 		}
+
+		/* Publish the sequence number and the messages dropped by the sensor thread ("sequence,drops"), MQTT
+		 * consumers can detect lost publications (QoS0) the same way */
+		snprintf(pub_topic, WIDTH_64, IO_USERNAME "%s", USER_SEQUENCE_TOPIC);
+		snprintf((char*) pub_message, WIDTH_64, "%lu,%lu", message.sequence, g_sensor_queue_drops);
+		printf("Topic:%s\r\ndata: %s\r\n", pub_topic, pub_message);
+		mqtt_status = aws_mqtt_publish(&mqttContext, pub_topic, pub_message);
+		if (pdPASS != mqtt_status) {
+			/* Only diagnostics, the next message publishes a newer sequence number */
+			printf("\r\n aws_mqtt_publish of the sequence failed\r\n");
+		}
 	}
 
 	FSP_PARAMETER_NOT_USED(pvParameters);
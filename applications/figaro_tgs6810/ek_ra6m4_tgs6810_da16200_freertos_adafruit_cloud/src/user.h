@@ -23,8 +23,15 @@
 #define USER_TEMPERATURE_TOPIC  "/feeds/temperature"
 #define USER_HUMIDITY_TOPIC     "/feeds/humidity"
 #define USER_CO_TOPIC           "/feeds/gas"
+#define USER_SEQUENCE_TOPIC     "/feeds/sequence"
 /*end adding @EXTERN_GLOBAL_VARIABLES code */
 
+/* Sensor queue message, the sequence number lets the main thread detect lost messages */
+typedef struct {
+	uint32_t sequence;
+	float data[SENSOR_DATA_COUNT];
+} sensor_message_t;
+
 /*Start adding @FN_DECLARATION code */
 /*end adding @FN_DECLARATION code */
 
@@ -0,0 +1,130 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Fixed-point decode of the Figaro driver (readFixed): rm_figaro_float_to_fixed is bit-exact with (int32_t) (f * 100.0F)
+// and rejects NaN, infinities and values out of the int32_t range, an invalid frame leaves the data unchanged, and the
+// cost of the float decode plus three conversions against the fixed-point decode. The host has no ARM FPU, the integer
+// conversion of the driver is the one tested. Checks one float in CHECK_STRIDE, all of them with "full".
+#include <math.h>
+#include <string.h>
+#include "host.h"
+#include "rm_figaro.c"
+
+// Odd, so every exponent and every low significand bit pattern is reached
+#define CHECK_STRIDE    (257U)
+#define FRAMES          (256U)
+#define BENCH_RUNS      (10000000U)
+
+static volatile int32_t sink;
+
+static void check_conversion(uint32_t stride) {
+    uint64_t checked = 0;
+    uint64_t rejected = 0;
+    uint64_t mismatches = 0;
+    for (uint64_t b = 0; b <= 0xFFFFFFFFULL; b += stride) {
+        uint32_t bits = (uint32_t) b;
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        int32_t value = 0;
+        bool ok = rm_figaro_float_to_fixed(bits, &value);
+        float product = f * 100.0F;
+        if (isnan(product) || (product >= 2147483648.0F) || (product <= -2147483648.0F)) {
+            if (ok) mismatches++;
+            rejected++;
+            continue;
+        }
+        checked++;
+        if (!ok || (value != (int32_t) product)) {
+            if (mismatches < 10) printf("mismatch %08x %.9g: %d, converted %d (%d)\n", bits, (double) f,
+                                        (int32_t) product, value, ok);
+            mismatches++;
+        }
+    }
+    printf("floats checked %llu, rejected (NaN, infinity, out of range) %llu, mismatches %llu\n",
+           (unsigned long long) checked, (unsigned long long) rejected, (unsigned long long) mismatches);
+    CHECK(0 == mismatches);
+}
+
+// Products on a tie or next to one after rounding to single precision, and the limits of the int32_t range
+static void check_edges(void) {
+    static float const values[] = {0.0F, -0.0F, 0.01F, -0.01F, 0.005F, 0.015F, 1.005F, 20.125F, -40.0F, 125.0F,
+                                   21474836.0F, -21474836.0F, 21474838.0F, -21474838.0F, 1e-45F, -1e-45F};
+    for (unsigned i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        uint32_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        int32_t value = 0;
+        float product = values[i] * 100.0F;
+        bool in_range = (product < 2147483648.0F) && (product > -2147483648.0F);
+        CHECK(in_range == rm_figaro_float_to_fixed(bits, &value));
+        CHECK(!in_range || (value == (int32_t) product));
+    }
+}
+
+static void frame_set(rm_figaro_instance_ctrl_t * p_ctrl, float temperature, float humidity, float gas) {
+    memcpy(&p_ctrl->buf[0], &temperature, sizeof(float));
+    memcpy(&p_ctrl->buf[4], &humidity, sizeof(float));
+    memcpy(&p_ctrl->buf[8], &gas, sizeof(float));
+}
+
+static void check_frames(rm_figaro_instance_ctrl_t * p_ctrl) {
+    rm_figaro_fixed_data_t data;
+    frame_set(p_ctrl, 21.37F, 45.5F, 12.25F);
+    CHECK(FSP_SUCCESS == rm_figaro_fixed_data_decode(p_ctrl, &data));
+    CHECK((2137 == data.temperature) && (4550 == data.humidity) && (1225 == data.gas));
+
+    // Invalid frames: NaN, infinity, above and below the range of the field
+    static float const invalid[][3] = {{NAN, 45.5F, 12.25F}, {21.37F, INFINITY, 12.25F}, {125.01F, 45.5F, 12.25F},
+                                       {21.37F, -0.01F, 12.25F}, {21.37F, 45.5F, -1000.01F}, {21.37F, 45.5F, 1e7F}};
+    for (unsigned i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        frame_set(p_ctrl, invalid[i][0], invalid[i][1], invalid[i][2]);
+        CHECK(FSP_ERR_SENSOR_INVALID_DATA == rm_figaro_fixed_data_decode(p_ctrl, &data));
+        CHECK((2137 == data.temperature) && (4550 == data.humidity) && (1225 == data.gas));
+    }
+}
+
+static void bench(rm_figaro_instance_ctrl_t * p_ctrl) {
+    static float frames[FRAMES][3];
+    for (uint32_t i = 0; i < FRAMES; i++) {
+        frames[i][0] = 20.0F + (float) i * 0.013F;
+        frames[i][1] = 30.0F + (float) i * 0.17F;
+        frames[i][2] = (float) i * 7.31F;
+    }
+    rm_figaro_data_t data;
+    rm_figaro_fixed_data_t fixed;
+    double start = host_ns();
+    for (uint32_t n = 0; n < BENCH_RUNS; n++) {
+        memcpy(p_ctrl->buf, frames[n % FRAMES], sizeof(frames[0]));
+        __asm__ volatile ("" ::: "memory");
+        rm_figaro_data_decode(p_ctrl, &data);
+        sink = (int32_t) (data.temperature * 100.0F);
+        sink = (int32_t) (data.humidity * 100.0F);
+        sink = (int32_t) (data.gas * 100.0F);
+    }
+    double middle = host_ns();
+    for (uint32_t n = 0; n < BENCH_RUNS; n++) {
+        memcpy(p_ctrl->buf, frames[n % FRAMES], sizeof(frames[0]));
+        __asm__ volatile ("" ::: "memory");
+        if (FSP_SUCCESS == rm_figaro_fixed_data_decode(p_ctrl, &fixed)) {
+            sink = fixed.temperature;
+            sink = fixed.humidity;
+            sink = fixed.gas;
+        }
+    }
+    double end = host_ns();
+    printf("ns per frame: float decode and 3 conversions %.1f, fixed-point decode with range checks %.1f\n",
+           (middle - start) / BENCH_RUNS, (end - middle) / BENCH_RUNS);
+}
+
+int main(int argc, char ** argv) {
+    rm_figaro_instance_ctrl_t ctrl;
+    memset(&ctrl, 0, sizeof(ctrl));
+    ctrl.p_descriptor = &g_figaro_tgs6810_descriptor;
+
+    check_edges();
+    check_conversion(((1 < argc) && (0 == strcmp(argv[1], "full"))) ? 1U : CHECK_STRIDE);
+    check_frames(&ctrl);
+    bench(&ctrl);
+    return host_result("figaro_decode");
+}
@@ -0,0 +1,25 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// DSP path of gas_compensation.c (Cortex-M33 with the DSP extension) built on host, SMLAD emulated as specified by
+// the Armv8-M architecture: two signed 16 x 16 products of the halfwords added to the accumulator, modulo 2^32. The
+// functions and tables are renamed so the test links both paths
+#include <stdint.h>
+
+#define __ARM_FEATURE_DSP                   1
+#define gas_compensate                      gas_compensate_dsp
+#define g_gas_compensation_tgs5141          g_gas_compensation_dsp_tgs5141
+#define g_gas_compensation_fecs43           g_gas_compensation_dsp_fecs43
+#define g_gas_compensation_fecs44           g_gas_compensation_dsp_fecs44
+#define g_gas_compensation_fecs50           g_gas_compensation_dsp_fecs50
+
+uint32_t host_smlad(uint32_t x, uint32_t y, uint32_t acc) {
+    int32_t low = (int32_t) (int16_t) x * (int32_t) (int16_t) y;
+    int32_t high = (int32_t) (int16_t) (x >> 16) * (int32_t) (int16_t) (y >> 16);
+    return acc + (uint32_t) low + (uint32_t) high;
+}
+#define __SMLAD(x, y, acc)                  host_smlad((x), (y), (acc))
+
+#include "gas_compensation.c"
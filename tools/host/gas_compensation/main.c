@@ -0,0 +1,197 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Temperature and humidity compensation of the electrochemical gas modules (gas_compensation.c): the Q13/Q14 and SMLAD
+// vectors of vectors.h, the DSP path (SMLAD emulated, see dsp.c) bit-exact with the C path, and the error against a
+// double-precision evaluation of the same curves within its analytic bound, over random readings, temperatures and
+// humidities covering every node. SAMPLES per table, four times more with "full". Ends with the cost per sample on
+// the host, the cycles on the Cortex-M33 are not measured here.
+#include <math.h>
+#include <string.h>
+#include "host.h"
+#include "gas_compensation.c"
+#include "vectors.h"
+
+#define SAMPLES         (1000000L)
+#define BENCH_SAMPLES   (4096)
+#define BENCH_RUNS      (2000)
+
+uint32_t host_smlad(uint32_t x, uint32_t y, uint32_t acc);
+int32_t gas_compensate_dsp(gas_compensation_table const * p_table, int32_t gas, int32_t temperature, int32_t humidity);
+extern gas_compensation_table const g_gas_compensation_dsp_tgs5141;
+extern gas_compensation_table const g_gas_compensation_dsp_fecs43;
+extern gas_compensation_table const g_gas_compensation_dsp_fecs44;
+extern gas_compensation_table const g_gas_compensation_dsp_fecs50;
+
+static struct {
+    char const * name;
+    gas_compensation_table const * p_table;
+    gas_compensation_table const * p_dsp;
+} const tables[] = {
+    {"tgs5141", &g_gas_compensation_tgs5141, &g_gas_compensation_dsp_tgs5141},
+    {"fecs43", &g_gas_compensation_fecs43, &g_gas_compensation_dsp_fecs43},
+    {"fecs44", &g_gas_compensation_fecs44, &g_gas_compensation_dsp_fecs44},
+    {"fecs50", &g_gas_compensation_fecs50, &g_gas_compensation_dsp_fecs50},
+};
+#define TABLES          (sizeof(tables) / sizeof(tables[0]))
+
+static volatile int32_t sink;
+
+// Same table in the DSP build
+static gas_compensation_table const * dsp_table(gas_compensation_table const * p_table) {
+    for (unsigned i = 0; i < TABLES; i++) {
+        if (p_table == tables[i].p_table) return tables[i].p_dsp;
+    }
+    return NULL;
+}
+
+// Exact interpolation of a curve
+static double curve_reference(gas_compensation_curve const * p_curve, double x) {
+    double u = (x - p_curve->first) / p_curve->step;
+    if (u <= 0) return p_curve->p_values[0];
+    int node = (int) floor(u);
+    if (node >= p_curve->nodes - 1) return p_curve->p_values[p_curve->nodes - 1];
+    double f = u - node;
+    return p_curve->p_values[node] * (1 - f) + p_curve->p_values[node + 1] * f;
+}
+
+// Error bound of a curve value: half a node LSB of rounding plus 2.5/16384 of the segment (truncation of the Q14
+// weight and rounding of the reciprocal)
+static double curve_bound(gas_compensation_curve const * p_curve, double x) {
+    double u = (x - p_curve->first) / p_curve->step;
+    if (u <= 0) return 0;
+    int node = (int) floor(u);
+    if (node >= p_curve->nodes - 1) return 0;
+    return 0.5 + fabs((double) p_curve->p_values[node + 1] - p_curve->p_values[node]) * 2.5 / 16384;
+}
+
+static double compensation_reference(gas_compensation_table const * p_table, double gas, double temperature,
+                                     double humidity) {
+    return (gas - curve_reference(&p_table->offset, temperature)) *
+           curve_reference(&p_table->span, temperature) / GAS_COMPENSATION_GAIN_ONE *
+           curve_reference(&p_table->humidity, humidity) / GAS_COMPENSATION_GAIN_ONE;
+}
+
+// Half an LSB of the final rounding, the offset error through the gains and the relative errors of both gains
+static double compensation_bound(gas_compensation_table const * p_table, double gas, double temperature,
+                                 double humidity) {
+    double span = curve_reference(&p_table->span, temperature);
+    double humidity_gain = curve_reference(&p_table->humidity, humidity);
+    double gain = span / GAS_COMPENSATION_GAIN_ONE * humidity_gain / GAS_COMPENSATION_GAIN_ONE;
+    double relative = curve_bound(&p_table->span, temperature) / span +
+                      curve_bound(&p_table->humidity, humidity) / humidity_gain;
+    return 0.5 + gain * curve_bound(&p_table->offset, temperature) +
+           fabs(gas - curve_reference(&p_table->offset, temperature)) * gain * relative * 1.0001;
+}
+
+static uint64_t random_state = 88172645463325252ULL;
+
+static int32_t random_range(int32_t low, int32_t high) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return low + (int32_t) (random_state % (uint64_t) ((int64_t) high - low + 1));
+}
+
+static void check_vectors(void) {
+    for (unsigned i = 0; i < sizeof(smlad_vectors) / sizeof(smlad_vectors[0]); i++) {
+        CHECK(smlad_vectors[i].result == host_smlad(smlad_vectors[i].x, smlad_vectors[i].y, smlad_vectors[i].acc));
+    }
+    for (unsigned i = 0; i < sizeof(macro_vectors) / sizeof(macro_vectors[0]); i++) {
+        CHECK(macro_vectors[i].expected == macro_vectors[i].value);
+    }
+    for (unsigned i = 0; i < sizeof(curve_vectors) / sizeof(curve_vectors[0]); i++) {
+        gas_compensation_curve const * p_curve = curve_vectors[i].p_curve;
+        int32_t value = gas_compensation_curve_value(p_curve, curve_vectors[i].x);
+        CHECK(curve_vectors[i].value == value);
+        CHECK(fabs(value - curve_reference(p_curve, curve_vectors[i].x)) <= curve_bound(p_curve, curve_vectors[i].x));
+    }
+    for (unsigned i = 0; i < sizeof(compensation_vectors) / sizeof(compensation_vectors[0]); i++) {
+        gas_compensation_table const * p_table = compensation_vectors[i].p_table;
+        int32_t gas = compensation_vectors[i].gas;
+        int32_t temperature = compensation_vectors[i].temperature;
+        int32_t humidity = compensation_vectors[i].humidity;
+        int32_t expected = compensation_vectors[i].expected;
+        CHECK(expected == gas_compensate(p_table, gas, temperature, humidity));
+        CHECK(expected == gas_compensate_dsp(dsp_table(p_table), gas, temperature, humidity));
+        // Saturated to the int32_t range, the others within the bound of the reference
+        double reference = compensation_reference(p_table, gas, temperature, humidity);
+        if ((reference < INT32_MAX) && (reference > INT32_MIN)) {
+            CHECK(fabs(expected - reference) <= compensation_bound(p_table, gas, temperature, humidity));
+        } else {
+            CHECK(expected == ((reference > 0) ? INT32_MAX : INT32_MIN));
+        }
+    }
+}
+
+static void check_reference(long samples) {
+    uint64_t mismatches = 0;
+    for (unsigned k = 0; k < TABLES; k++) {
+        gas_compensation_table const * p_table = tables[k].p_table;
+        double max_ratio = 0;
+        double max_small = 0;
+        double max_relative = 0;
+        uint64_t beyond = 0;
+        for (long i = 0; i < samples; i++) {
+            int32_t temperature = random_range(-4000, 12500);
+            int32_t humidity = random_range(0, 10000);
+            int32_t gas;
+            switch (i % 4) {
+                case 0: gas = random_range(-100000, 100000); break;             // +-1000 ppm
+                case 1: gas = random_range(-2000, 2000); break;                 // around zero
+                case 2: gas = random_range(-100000, 100000000); break;          // up to 1000000 ppm
+                default: gas = (int32_t) pow(10, random_range(0, 8000) / 1000.0); break;
+            }
+            // Every node of the temperature and humidity curves, and one step outside
+            if (i < 17 * 11) {
+                temperature = -4000 + (int32_t) (i % 17) * 1000;
+                humidity = (int32_t) (i / 17) * 1000;
+            }
+            int32_t value = gas_compensate(p_table, gas, temperature, humidity);
+            if (value != gas_compensate_dsp(tables[k].p_dsp, gas, temperature, humidity)) {
+                if (mismatches < 10) printf("mismatch %s %d %d %d\n", tables[k].name, gas, temperature, humidity);
+                mismatches++;
+            }
+            double reference = compensation_reference(p_table, gas, temperature, humidity);
+            double error = fabs(value - reference);
+            double ratio = error / compensation_bound(p_table, gas, temperature, humidity);
+            if (ratio > 1.0) beyond++;
+            if (ratio > max_ratio) max_ratio = ratio;
+            if ((fabs((double) gas) < 200000) && (error > max_small)) max_small = error;
+            if ((fabs(reference) > 100000) && (error / fabs(reference) > max_relative)) {
+                max_relative = error / fabs(reference);
+            }
+        }
+        printf("%-8s %ld samples: error below 2000 ppm %.3f hundredths, relative above 1000 ppm %.2e, "
+               "error/bound %.3f\n", tables[k].name, samples, max_small, max_relative, max_ratio);
+        CHECK(0 == beyond);
+    }
+    printf("C and DSP paths: %llu mismatches\n", (unsigned long long) mismatches);
+    CHECK(0 == mismatches);
+}
+
+static void bench(void) {
+    static int32_t input[3][BENCH_SAMPLES];
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        input[0][i] = random_range(-100000, 1000000);
+        input[1][i] = random_range(-4000, 12500);
+        input[2][i] = random_range(0, 10000);
+    }
+    double start = host_ns();
+    for (int n = 0; n < BENCH_RUNS; n++) {
+        for (int i = 0; i < BENCH_SAMPLES; i++) {
+            sink = gas_compensate(&g_gas_compensation_fecs43, input[0][i], input[1][i], input[2][i]);
+        }
+    }
+    double end = host_ns();
+    printf("ns per sample on the host: %.1f\n", (end - start) / ((double) BENCH_RUNS * BENCH_SAMPLES));
+}
+
+int main(int argc, char ** argv) {
+    check_vectors();
+    check_reference(((1 < argc) && (0 == strcmp(argv[1], "full"))) ? 4 * SAMPLES : SAMPLES);
+    bench();
+    return host_result("gas_compensation");
+}
@@ -0,0 +1,132 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Test vectors of gas_compensation.c. The SMLAD vectors follow the Armv8-M definition of the instruction, the curve and
+// compensation vectors are the outputs of the firmware arithmetic, checked against the double-precision reference of
+// main.c when they were recorded: a change of the rounding, of the Q formats or of the tables shows here first
+#ifndef GAS_COMPENSATION_VECTORS_H_
+#define GAS_COMPENSATION_VECTORS_H_
+
+// SMLAD: acc + x.lo * y.lo + x.hi * y.hi, signed halfwords, modulo 2^32
+static struct { uint32_t x; uint32_t y; uint32_t acc; uint32_t result; } const smlad_vectors[] =
+{
+    {0x00020003U, 0x00040005U, 0x00000001U, 0x00000018U},
+    {0xFFFF0001U, 0x00020003U, 0x00000000U, 0x00000001U},   // negative high halfword
+    {0x80008000U, 0x80008000U, 0x00000000U, 0x80000000U},   // 2^31 wraps (sets the Q flag on the target)
+    {0x7FFF7FFFU, 0x7FFF7FFFU, 0x00000000U, 0x7FFE0002U},
+    {0x00008000U, 0x00017FFFU, 0x00002000U, 0xC000A000U},
+    {0x0000FFFFU, 0x0000FFFFU, 0xFFFFFFFFU, 0x00000000U},   // accumulator wraps
+    // Nodes 8192 and 7728 (fecs43 span at 20 C and 30 C), weights 8193 and 8191 in Q14, rounding: 7960 after >> 14
+    {0x1E302000U, 0x1FFF2001U, 0x00002000U, 0x07C621D0U},
+};
+
+// Q13 gains and Q14 reciprocals (scaled by 2^24) of the table macros
+static struct { int32_t value; int32_t expected; } const macro_vectors[] =
+{
+    {GAS_COMPENSATION_GAIN(1.0), 8192},
+    {GAS_COMPENSATION_GAIN(1 / 0.55), 14895},
+    {GAS_COMPENSATION_GAIN(1 / 1.06), 7728},
+    {GAS_COMPENSATION_GAIN(3.9998), 32766},
+    {(int32_t) GAS_COMPENSATION_RECIP(1), 16777216},
+    {(int32_t) GAS_COMPENSATION_RECIP(1000), 16777},
+    {(int32_t) GAS_COMPENSATION_RECIP(2500), 6711},
+    {(int32_t) GAS_COMPENSATION_RECIP(5000), 3355},
+};
+
+// Curves of the FECS43 table: below the first node, on the nodes, between them, one below the next node, above
+static struct { gas_compensation_curve const * p_curve; int32_t x; int32_t value; } const curve_vectors[] =
+{
+    {&g_gas_compensation_fecs43.offset,   -4000, -20},
+    {&g_gas_compensation_fecs43.offset,   -2000, -20},
+    {&g_gas_compensation_fecs43.offset,   -1999, -20},
+    {&g_gas_compensation_fecs43.offset,   -1500, -15},
+    {&g_gas_compensation_fecs43.offset,   -1001, -10},
+    {&g_gas_compensation_fecs43.offset,   0,     -5},
+    {&g_gas_compensation_fecs43.offset,   2000,  0},
+    {&g_gas_compensation_fecs43.offset,   2500,  5},
+    {&g_gas_compensation_fecs43.offset,   2999,  10},
+    {&g_gas_compensation_fecs43.offset,   4500,  45},
+    {&g_gas_compensation_fecs43.offset,   4999,  60},
+    {&g_gas_compensation_fecs43.offset,   5000,  60},
+    {&g_gas_compensation_fecs43.offset,   12500, 60},
+    {&g_gas_compensation_fecs43.span,     -4000, 14895},
+    {&g_gas_compensation_fecs43.span,     -2000, 14895},
+    {&g_gas_compensation_fecs43.span,     -1999, 14892},
+    {&g_gas_compensation_fecs43.span,     -1500, 13471},
+    {&g_gas_compensation_fecs43.span,     -1001, 12050},
+    {&g_gas_compensation_fecs43.span,     0,     10240},
+    {&g_gas_compensation_fecs43.span,     2000,  8192},
+    {&g_gas_compensation_fecs43.span,     2500,  7960},
+    {&g_gas_compensation_fecs43.span,     2999,  7728},
+    {&g_gas_compensation_fecs43.span,     4500,  7381},
+    {&g_gas_compensation_fecs43.span,     4999,  7314},
+    {&g_gas_compensation_fecs43.span,     5000,  7314},
+    {&g_gas_compensation_fecs43.span,     12500, 7314},
+    {&g_gas_compensation_fecs43.humidity, 0,     8533},
+    {&g_gas_compensation_fecs43.humidity, 1,     8533},
+    {&g_gas_compensation_fecs43.humidity, 1250,  8446},
+    {&g_gas_compensation_fecs43.humidity, 2500,  8359},
+    {&g_gas_compensation_fecs43.humidity, 3333,  8303},
+    {&g_gas_compensation_fecs43.humidity, 7499,  8031},
+    {&g_gas_compensation_fecs43.humidity, 9999,  7953},
+    {&g_gas_compensation_fecs43.humidity, 10000, 7953},
+};
+
+// Compensation of each table: zero, +-100 ppm, 1000000 ppm and the int32_t limits (saturated) at the temperature and
+// humidity limits, on nodes and between them
+static struct { gas_compensation_table const * p_table; int32_t gas; int32_t temperature; int32_t humidity;
+                int32_t expected; } const compensation_vectors[] =
+{
+    {&g_gas_compensation_tgs5141, 0,          -4000, 5000,  0},
+    {&g_gas_compensation_tgs5141, 0,          2537,  8765,  -26},
+    {&g_gas_compensation_tgs5141, 10000,      2000,  0,     10309},
+    {&g_gas_compensation_tgs5141, 10000,      4999,  10000, 8680},
+    {&g_gas_compensation_tgs5141, -10000,     -4000, 5000,  -16666},
+    {&g_gas_compensation_tgs5141, -10000,     2537,  8765,  -9627},
+    {&g_gas_compensation_tgs5141, 100000000,  2000,  0,     103088379},
+    {&g_gas_compensation_tgs5141, 100000000,  4999,  10000, 89944578},
+    {&g_gas_compensation_tgs5141, INT32_MAX,  -4000, 5000,  INT32_MAX},
+    {&g_gas_compensation_tgs5141, INT32_MAX,  2537,  8765,  2061785349},
+    {&g_gas_compensation_tgs5141, INT32_MIN,  2000,  0,     INT32_MIN},
+    {&g_gas_compensation_tgs5141, INT32_MIN,  4999,  10000, -1931552187},
+    {&g_gas_compensation_fecs43,  0,          -4000, 5000,  36},
+    {&g_gas_compensation_fecs43,  0,          2537,  8765,  -5},
+    {&g_gas_compensation_fecs43,  10000,      2000,  0,     10416},
+    {&g_gas_compensation_fecs43,  10000,      4999,  10000, 8616},
+    {&g_gas_compensation_fecs43,  -10000,     -4000, 5000,  -18146},
+    {&g_gas_compensation_fecs43,  -10000,     2537,  8765,  -9464},
+    {&g_gas_compensation_fecs43,  100000000,  2000,  0,     104162598},
+    {&g_gas_compensation_fecs43,  100000000,  4999,  10000, 86677383},
+    {&g_gas_compensation_fecs43,  INT32_MAX,  -4000, 5000,  INT32_MAX},
+    {&g_gas_compensation_fecs43,  INT32_MAX,  2537,  8765,  2031374586},
+    {&g_gas_compensation_fecs43,  INT32_MIN,  2000,  0,     INT32_MIN},
+    {&g_gas_compensation_fecs43,  INT32_MIN,  4999,  10000, -1861383796},
+    {&g_gas_compensation_fecs44,  0,          -4000, 5000,  222},
+    {&g_gas_compensation_fecs44,  0,          2537,  8765,  -25},
+    {&g_gas_compensation_fecs44,  10000,      2000,  0,     10989},
+    {&g_gas_compensation_fecs44,  10000,      4999,  10000, 7450},
+    {&g_gas_compensation_fecs44,  -10000,     -4000, 5000,  -21999},
+    {&g_gas_compensation_fecs44,  -10000,     2537,  8765,  -9171},
+    {&g_gas_compensation_fecs44,  100000000,  2000,  0,     109887695},
+    {&g_gas_compensation_fecs44,  100000000,  4999,  10000, 76800372},
+    {&g_gas_compensation_fecs44,  INT32_MAX,  -4000, 5000,  INT32_MAX},
+    {&g_gas_compensation_fecs44,  INT32_MAX,  2537,  8765,  1964082662},
+    {&g_gas_compensation_fecs44,  INT32_MIN,  2000,  0,     INT32_MIN},
+    {&g_gas_compensation_fecs44,  INT32_MIN,  4999,  10000, -1649280614},
+    {&g_gas_compensation_fecs50,  0,          -4000, 5000,  0},
+    {&g_gas_compensation_fecs50,  0,          2537,  8765,  -3},
+    {&g_gas_compensation_fecs50,  10000,      2000,  0,     10204},
+    {&g_gas_compensation_fecs50,  10000,      4999,  10000, 9312},
+    {&g_gas_compensation_fecs50,  -10000,     -4000, 5000,  -14286},
+    {&g_gas_compensation_fecs50,  -10000,     2537,  8765,  -9749},
+    {&g_gas_compensation_fecs50,  100000000,  2000,  0,     102038574},
+    {&g_gas_compensation_fecs50,  100000000,  4999,  10000, 93403144},
+    {&g_gas_compensation_fecs50,  INT32_MAX,  -4000, 5000,  INT32_MAX},
+    {&g_gas_compensation_fecs50,  INT32_MAX,  2537,  8765,  2093027324},
+    {&g_gas_compensation_fecs50,  INT32_MIN,  2000,  0,     INT32_MIN},
+    {&g_gas_compensation_fecs50,  INT32_MIN,  4999,  10000, -2005817884},
+};
+
+#endif
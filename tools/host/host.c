@@ -0,0 +1,76 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+#include <stdarg.h>
+#include <time.h>
+#include "hal_data.h"
+#include "host.h"
+
+uint32_t host_time_ms;
+uint32_t host_failures;
+uint32_t host_critical_depth;
+static uint32_t host_us;            // microseconds within the current ms
+
+static dwt_t host_dwt;
+dwt_t * DWT = &host_dwt;
+static cdbg_t host_core_debug;
+cdbg_t * CoreDebug = &host_core_debug;
+uint32_t SystemCoreClock = HOST_CPU_HZ;
+
+void host_advance_us(uint32_t us) {
+    host_dwt.CYCCNT += us * HOST_CYCLES_PER_US;
+    host_us += us;
+    host_time_ms += host_us / 1000U;
+    host_us %= 1000U;
+}
+
+uint64_t host_time_us(void) {
+    return (uint64_t) host_time_ms * 1000U + host_us;
+}
+
+double host_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec * 1e9 + (double) t.tv_nsec;
+}
+
+int host_result(char const * name) {
+    printf("%s: %s\n", name, (0 == host_failures) ? "PASS" : "FAIL");
+    return (0 == host_failures) ? 0 : 1;
+}
+
+// The clock functions are weak, the rm_comms emulator replaces them to deliver its completions when time advances
+__attribute__((weak)) uint32_t utils_systime_get(void) {
+    return host_time_ms;
+}
+
+fsp_err_t utils_systime_init(uint32_t freq) {
+    (void) freq;
+    return FSP_SUCCESS;
+}
+
+__attribute__((weak)) void utils_delay_us(uint32_t delay) {
+    host_advance_us(delay);
+}
+
+__attribute__((weak)) void utils_delay_ms(uint32_t delay) {
+    host_advance_us(delay * 1000U);
+}
+
+__attribute__((weak)) void R_BSP_SoftwareDelay(uint32_t delay, bsp_delay_units_t units) {
+    host_advance_us(delay * (uint32_t) units);
+}
+
+void R_BSP_PinAccessEnable(void) {}
+void R_BSP_PinAccessDisable(void) {}
+void R_BSP_PinWrite(bsp_io_port_pin_t pin, bsp_io_level_t level) { (void) pin; (void) level; }
+bsp_io_level_t R_BSP_PinRead(bsp_io_port_pin_t pin) { (void) pin; return BSP_IO_LEVEL_HIGH; }
+void R_BSP_PinCfg(bsp_io_port_pin_t pin, uint32_t cfg) { (void) pin; (void) cfg; }
+
+int SEGGER_RTT_printf(unsigned index, const char * format, ...) {
+    (void) index;
+    (void) format;
+    return 0;
+}
@@ -0,0 +1,33 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Simulated time and board stubs shared by the host tests
+#ifndef HOST_H_
+#define HOST_H_
+#include <stdint.h>
+#include <stdio.h>
+
+// Time returned by utils_systime_get (ms)
+extern uint32_t host_time_ms;
+// CPU clock of the simulated DWT cycle counter (RA6M4, 200 MHz)
+#define HOST_CPU_HZ     (200000000U)
+#define HOST_CYCLES_PER_US  (HOST_CPU_HZ / 1000000U)
+
+extern uint32_t host_failures;
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); host_failures++; } } while (0)
+
+// Nesting of FSP_CRITICAL_SECTION_ENTER, 0 when the interrupts are enabled
+extern uint32_t host_critical_depth;
+
+// Advance the simulated time, the cycle counter follows
+void host_advance_us(uint32_t us);
+// Simulated time (us)
+uint64_t host_time_us(void);
+// Wall clock of the host (ns), for the benchmarks
+double host_ns(void);
+// Print the verdict of a test, returns its exit status
+int host_result(char const * name);
+
+#endif
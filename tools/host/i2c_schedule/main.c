@@ -0,0 +1,349 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Transaction queue of i2c.c (I2C_CFG_SCHEDULE_ENABLE) over a fake r_iic_master driver, with rm_comms transfers
+// sharing the bus: priority order, cancel, recovery, transactions refused by the driver (their callback runs with the
+// interrupts enabled), rm_comms refused while the queue owns the bus, and the latency of a high priority transaction
+// against back-to-back low priority ones. The driver flags any transfer, address or callback change while the bus is
+// busy. Time advances by 1 us steps, the completion interrupt runs when a transfer is due.
+#include <string.h>
+#include "host.h"
+#include "i2c.h"
+
+// Bit time at 100 kHz, in 0.1 us
+#define BIT_TENTHS_US       (100U)
+#define DEVICES             (4)
+
+// Fake driver: completes a transfer after its bus time, refuses overlapping ones
+static struct {
+    bool open;
+    uint32_t slave;
+    void (* p_callback)(i2c_master_callback_args_t *);
+    void const * p_context;
+    bool pending;
+    bool held;                  // repeated START, only the read may follow
+    bool read;
+    uint64_t due_us;
+    uint32_t transfers;
+    uint32_t violations;
+    fsp_err_t refuse;           // error returned by the next transfers, FSP_SUCCESS to accept them
+} drv;
+
+static fsp_err_t drv_open(i2c_master_ctrl_t * const p_ctrl, i2c_master_cfg_t const * const p_cfg) {
+    if (drv.open) return FSP_ERR_ALREADY_OPEN;
+    drv.open = true;
+    drv.slave = p_cfg->slave;
+    drv.pending = drv.held = false;
+    return FSP_SUCCESS;
+}
+static fsp_err_t drv_close(i2c_master_ctrl_t * const p_ctrl) {
+    drv.open = drv.pending = drv.held = false;
+    return FSP_SUCCESS;
+}
+static fsp_err_t drv_abort(i2c_master_ctrl_t * const p_ctrl) {
+    drv.pending = drv.held = false;
+    return FSP_SUCCESS;
+}
+static fsp_err_t drv_address_set(i2c_master_ctrl_t * const p_ctrl, uint32_t const slave,
+                                 i2c_master_addr_mode_t const mode) {
+    if (drv.pending || drv.held) {
+        drv.violations++;
+        return FSP_ERR_IN_USE;
+    }
+    drv.slave = slave;
+    return FSP_SUCCESS;
+}
+static fsp_err_t drv_callback_set(i2c_master_ctrl_t * const p_ctrl, void (* p_callback)(i2c_master_callback_args_t *),
+                                  void const * const p_context, i2c_master_callback_args_t * const p_memory) {
+    if (drv.pending) drv.violations++;
+    drv.p_callback = p_callback;
+    drv.p_context = p_context;
+    return FSP_SUCCESS;
+}
+static fsp_err_t drv_status_get(i2c_master_ctrl_t * const p_ctrl, i2c_master_status_t * p_status) {
+    p_status->open = drv.open;
+    return FSP_SUCCESS;
+}
+static fsp_err_t drv_transfer(uint32_t bytes, bool read, bool restart) {
+    if (!drv.open) return FSP_ERR_NOT_OPEN;
+    if (FSP_SUCCESS != drv.refuse) return drv.refuse;
+    if (drv.pending || (drv.held && !read)) {
+        drv.violations++;
+        return FSP_ERR_IN_USE;
+    }
+    drv.pending = true;
+    drv.read = read;
+    drv.held = restart;
+    drv.transfers++;
+    // Address and data bytes, 9 bits each
+    drv.due_us = host_time_us() + ((bytes + 1U) * 9U * BIT_TENTHS_US + 9U) / 10U;
+    return FSP_SUCCESS;
+}
+static fsp_err_t drv_read(i2c_master_ctrl_t * const p_ctrl, uint8_t * const p_dest, uint32_t const bytes,
+                          bool const restart) {
+    return drv_transfer(bytes, true, restart);
+}
+static fsp_err_t drv_write(i2c_master_ctrl_t * const p_ctrl, uint8_t * const p_src, uint32_t const bytes,
+                           bool const restart) {
+    return drv_transfer(bytes, false, restart);
+}
+
+static i2c_master_api_t const drv_api = {
+    .open = drv_open, .read = drv_read, .write = drv_write, .abort = drv_abort, .slaveAddressSet = drv_address_set,
+    .callbackSet = drv_callback_set, .statusGet = drv_status_get, .close = drv_close};
+static int drv_ctrl;
+static i2c_master_cfg_t const drv_cfg = {.slave = 0x40};
+static i2c_master_instance_t const drv_instance = {.p_ctrl = &drv_ctrl, .p_cfg = &drv_cfg, .p_api = &drv_api};
+rm_comms_i2c_bus_extended_cfg_t g_comms_i2c_bus0_extended_cfg = {.p_driver_instance = &drv_instance};
+
+static i2c_master_instance_t const * bus(void) {
+    return (i2c_master_instance_t const *) g_comms_i2c_bus0_extended_cfg.p_driver_instance;
+}
+
+// Completion interrupt of the driver
+static void drv_isr(void) {
+    if (!drv.pending || (host_time_us() < drv.due_us)) return;
+    drv.pending = false;
+    if (drv.read) drv.held = false;
+    i2c_master_callback_args_t args = {.p_context = drv.p_context,
+                                       .event = drv.read ? I2C_MASTER_EVENT_RX_COMPLETE : I2C_MASTER_EVENT_TX_COMPLETE};
+    drv.p_callback(&args);
+}
+
+static void run_us(uint32_t us) {
+    for (uint32_t t = 0; t < us; t++) {
+        host_advance_us(1);
+        drv_isr();
+    }
+}
+
+// Comms devices of the bus
+static i2c_master_cfg_t device_lower[DEVICES];
+static rm_comms_cfg_t device_cfg[DEVICES];
+static rm_comms_instance_t device[DEVICES];
+const rm_comms_instance_t g_comms_i2c_device0 = {.p_cfg = &device_cfg[0]};
+
+// What rm_comms_i2c does on baremetal: address and callback before each transfer, the read of a writeRead from the
+// callback of its write
+typedef struct {
+    int device;
+    bool write_pending;
+    uint8_t * p_dest;
+    uint32_t dest_bytes;
+    volatile bool done;
+    volatile bool error;
+} comms_transfer;
+
+static void comms_callback(i2c_master_callback_args_t * p_args) {
+    comms_transfer * p_transfer = (comms_transfer *) p_args->p_context;
+    if (I2C_MASTER_EVENT_ABORTED == p_args->event) {
+        p_transfer->error = p_transfer->done = true;
+        return;
+    }
+    if (p_transfer->write_pending) {
+        p_transfer->write_pending = false;
+        if (FSP_SUCCESS != bus()->p_api->read(bus()->p_ctrl, p_transfer->p_dest, p_transfer->dest_bytes, false)) {
+            p_transfer->error = p_transfer->done = true;
+        }
+        return;
+    }
+    p_transfer->done = true;
+}
+
+static fsp_err_t comms_write_read(comms_transfer * p_transfer, uint8_t * p_src, uint32_t src_bytes, uint8_t * p_dest,
+                                  uint32_t dest_bytes) {
+    bus()->p_api->callbackSet(bus()->p_ctrl, comms_callback, p_transfer, NULL);
+    bus()->p_api->slaveAddressSet(bus()->p_ctrl, device_lower[p_transfer->device].slave, I2C_MASTER_ADDR_MODE_7BIT);
+    p_transfer->done = p_transfer->error = false;
+    p_transfer->write_pending = true;
+    p_transfer->p_dest = p_dest;
+    p_transfer->dest_bytes = dest_bytes;
+    fsp_err_t err = bus()->p_api->write(bus()->p_ctrl, p_src, src_bytes, true);
+    if (FSP_SUCCESS != err) p_transfer->write_pending = false;
+    return err;
+}
+
+static uint8_t src[64];
+static uint8_t dest[64];
+
+static void transaction_set(i2c_transaction * p_transaction, int dev, uint8_t priority,
+                            void (* p_callback)(i2c_transaction *)) {
+    memset(p_transaction, 0, sizeof(*p_transaction));
+    p_transaction->p_comms = &device[dev];
+    p_transaction->type = I2C_TRANSACTION_WRITE_READ;
+    p_transaction->p_src = src;
+    p_transaction->src_bytes = 1;
+    p_transaction->p_dest = dest;
+    p_transaction->dest_bytes = 2;
+    p_transaction->priority = priority;
+    p_transaction->p_callback = p_callback;
+}
+
+static i2c_transaction queued[5];
+static int order[8];
+static int completed;
+static uint32_t critical_in_callback;
+
+static void order_callback(i2c_transaction * p_transaction) {
+    order[completed++] = (int) (p_transaction - queued);
+    if (0 != host_critical_depth) critical_in_callback++;
+}
+
+static void reset(void) {
+    i2c_deinitialize();
+    memset(&drv, 0, sizeof(drv));
+    completed = 0;
+    critical_in_callback = 0;
+    CHECK(FSP_SUCCESS == i2c_initialize());
+}
+
+static void check_order(void) {
+    reset();
+    CHECK(&drv_instance != bus());
+    static uint8_t const priorities[5] = {3, 2, 0, 2, 1};
+    for (int i = 0; i < 5; i++) transaction_set(&queued[i], 1, priorities[i], order_callback);
+    for (int i = 0; i < 5; i++) CHECK(FSP_SUCCESS == i2c_submit(&queued[i]));
+    // queued[0] started on the free bus, then by priority and in submission order within a priority
+    CHECK(FSP_ERR_IN_USE == i2c_cancel(&queued[0]));
+    CHECK(FSP_SUCCESS == i2c_cancel(&queued[3]));
+    CHECK(FSP_ERR_ABORTED == queued[3].result);
+    run_us(10000);
+    static int const expected[4] = {0, 2, 4, 1};
+    CHECK(4 == completed);
+    for (int i = 0; i < 4; i++) {
+        CHECK(expected[i] == order[i]);
+        CHECK(FSP_SUCCESS == queued[expected[i]].result);
+    }
+    CHECK(FSP_ERR_NOT_FOUND == i2c_cancel(&queued[0]));
+    CHECK(0 == critical_in_callback);
+    CHECK(0 == drv.violations);
+}
+
+// A recovery aborts the transaction in progress, the queue resumes after the reopen
+static void check_recover(void) {
+    reset();
+    for (int i = 0; i < 3; i++) {
+        transaction_set(&queued[i], 1, 1, order_callback);
+        CHECK(FSP_SUCCESS == i2c_submit(&queued[i]));
+    }
+    run_us(100);
+    CHECK(FSP_SUCCESS == i2c_recover(&g_comms_i2c_device0));
+    CHECK((1 == completed) && (0 == order[0]) && (FSP_ERR_ABORTED == queued[0].result));
+    run_us(10000);
+    CHECK((3 == completed) && (FSP_SUCCESS == queued[1].result) && (FSP_SUCCESS == queued[2].result));
+    CHECK(0 == critical_in_callback);
+}
+
+// Transactions refused by the driver complete at once, their callbacks are called after the critical section of
+// i2c_submit (or from the completion interrupt), never with the interrupts disabled
+static void check_refused(void) {
+    reset();
+    transaction_set(&queued[0], 1, 1, order_callback);
+    queued[0].type = I2C_TRANSACTION_READ;
+    transaction_set(&queued[1], 1, 1, order_callback);
+    transaction_set(&queued[2], 1, 1, NULL);
+    CHECK(FSP_SUCCESS == i2c_submit(&queued[0]));
+    // Refused when they start from the completion of queued[0]
+    drv.refuse = FSP_ERR_INVALID_ARGUMENT;
+    CHECK(FSP_SUCCESS == i2c_submit(&queued[1]));
+    CHECK(FSP_SUCCESS == i2c_submit(&queued[2]));
+    run_us(1000);
+    CHECK((2 == completed) && (0 == order[0]) && (1 == order[1]));
+    CHECK(FSP_SUCCESS == queued[0].result);
+    CHECK(FSP_ERR_INVALID_ARGUMENT == queued[1].result);
+    CHECK(FSP_ERR_INVALID_ARGUMENT == queued[2].result);
+    // Refused at submission on a free bus
+    completed = 0;
+    transaction_set(&queued[3], 1, 1, order_callback);
+    CHECK(FSP_SUCCESS == i2c_submit(&queued[3]));
+    CHECK((1 == completed) && (3 == order[0]) && (FSP_ERR_INVALID_ARGUMENT == queued[3].result));
+    drv.refuse = FSP_SUCCESS;
+    printf("refused: %u callbacks with the interrupts disabled\n", critical_in_callback);
+    CHECK(0 == critical_in_callback);
+}
+
+// rm_comms is refused while the queue owns the bus and gets it back when the queue is empty, a transaction submitted
+// during its writeRead waits for the read
+static void check_comms(void) {
+    reset();
+    comms_transfer transfer = {.device = 2};
+    transaction_set(&queued[0], 1, 1, order_callback);
+    transaction_set(&queued[1], 1, 1, order_callback);
+    CHECK(FSP_SUCCESS == i2c_submit(&queued[0]));
+    CHECK(FSP_SUCCESS == i2c_submit(&queued[1]));
+    CHECK(FSP_ERR_IN_USE == comms_write_read(&transfer, src, 1, dest, 4));
+    run_us(5000);
+    CHECK(FSP_SUCCESS == comms_write_read(&transfer, src, 1, dest, 4));
+    transaction_set(&queued[2], 1, 1, order_callback);
+    CHECK(FSP_SUCCESS == i2c_submit(&queued[2]));
+    run_us(5000);
+    CHECK(transfer.done && !transfer.error);
+    CHECK((3 == completed) && (FSP_SUCCESS == queued[2].result));
+    CHECK(0 == drv.violations);
+}
+
+// A writeRead 1+2 bytes of priority 0 every 5 ms against three requesters looping 32 byte reads of priority 1
+#define HIGH_PERIOD_US      (5000U)
+#define LOW_READ_US         ((33U * 9U * BIT_TENTHS_US + 9U) / 10U)
+#define HIGH_US             ((2U * 9U * BIT_TENTHS_US + 9U) / 10U + (3U * 9U * BIT_TENTHS_US + 9U) / 10U)
+
+static i2c_transaction low[3];
+static i2c_transaction high;
+static uint64_t high_submitted_us;
+static uint32_t high_done;
+static uint32_t high_max_us;
+static uint32_t low_done;
+
+static void low_callback(i2c_transaction * p_transaction) {
+    low_done++;
+    i2c_submit(p_transaction);
+}
+static void high_callback(i2c_transaction * p_transaction) {
+    uint32_t latency = (uint32_t) (host_time_us() - high_submitted_us);
+    if (latency > high_max_us) high_max_us = latency;
+    high_done++;
+}
+
+static void check_priority(void) {
+    reset();
+    for (int i = 0; i < 3; i++) {
+        transaction_set(&low[i], 1 + i, 1, low_callback);
+        low[i].type = I2C_TRANSACTION_READ;
+        low[i].dest_bytes = 32;
+        CHECK(FSP_SUCCESS == i2c_submit(&low[i]));
+    }
+    transaction_set(&high, 0, 0, high_callback);
+    for (uint32_t n = 0; n < 400; n++) {
+        run_us(1 + (n * 37U) % 100U);
+        high_submitted_us = host_time_us();
+        CHECK(FSP_SUCCESS == i2c_submit(&high));
+        run_us(HIGH_PERIOD_US - 1 - (n * 37U) % 100U);
+    }
+    printf("priority: %u high transactions, max latency %u us (bound %u us), %u low reads\n", high_done, high_max_us,
+           LOW_READ_US + HIGH_US, low_done);
+    // One low read already on the bus, then the high transaction
+    CHECK(400 == high_done);
+    CHECK(high_max_us <= LOW_READ_US + HIGH_US + 1U);
+    CHECK(0 == drv.violations);
+    for (int i = 0; i < 3; i++) low[i].p_callback = NULL;
+    run_us(10000);
+}
+
+int main(void) {
+    for (int i = 0; i < DEVICES; i++) {
+        device_lower[i].slave = 0x40U + (uint32_t) i;
+        device_lower[i].addr_mode = I2C_MASTER_ADDR_MODE_7BIT;
+        device_cfg[i].p_lower_level_cfg = &device_lower[i];
+        device_cfg[i].p_extend = &g_comms_i2c_bus0_extended_cfg;
+        device[i].p_cfg = &device_cfg[i];
+    }
+    check_order();
+    check_recover();
+    check_refused();
+    check_comms();
+    check_priority();
+    CHECK(0 == host_critical_depth);
+    return host_result("i2c_schedule");
+}
@@ -0,0 +1,10 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host stub of the FSP header, only what the tested sources use
+#ifndef SEGGER_RTT_H
+#define SEGGER_RTT_H
+int SEGGER_RTT_printf(unsigned, const char*, ...); int SEGGER_RTT_Write(unsigned, const void*, unsigned); int SEGGER_RTT_Read(unsigned, void*, unsigned); int SEGGER_RTT_HasKey(void);
+#endif
@@ -0,0 +1,7 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host stub of the FSP header, only what the tested sources use
+// Empty, the tests run without the application thread
@@ -0,0 +1,24 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host stub of the FSP header, only what the tested sources use
+#ifndef FREERTOS_H
+#define FREERTOS_H
+#include <stdint.h>
+typedef long BaseType_t; typedef unsigned long UBaseType_t; typedef uint32_t TickType_t;
+#define pdPASS 1
+#define pdTRUE 1
+#define pdFALSE 0
+#define errQUEUE_FULL 0
+#define portMAX_DELAY 0xffffffffu
+// The tick rate is a variable, so a test can run at several rates
+extern uint32_t host_tick_rate_hz;
+#define configTICK_RATE_HZ host_tick_rate_hz
+#define pdMS_TO_TICKS(x) ((TickType_t) (((TickType_t) (x) * (TickType_t) configTICK_RATE_HZ) / (TickType_t) 1000U))
+typedef void * QueueHandle_t; typedef void * TaskHandle_t; typedef void * SemaphoreHandle_t; typedef void * TimerHandle_t; typedef void * EventGroupHandle_t;
+typedef struct { int x; } StaticQueue_t; typedef StaticQueue_t StaticSemaphore_t; typedef struct {int x;} StaticTask_t; typedef struct {int x;} StaticTimer_t; typedef uint32_t StackType_t;
+typedef uint32_t EventBits_t; typedef struct {int x;} StaticEventGroup_t;
+#define portYIELD_FROM_ISR(x) (void)(x)
+#endif
@@ -0,0 +1,13 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host stub of the FSP header, only what the tested sources use
+#include "FreeRTOS.h"
+QueueHandle_t xQueueCreateStatic(UBaseType_t, UBaseType_t, uint8_t*, StaticQueue_t*);
+BaseType_t xQueueSend(QueueHandle_t, const void*, TickType_t);
+BaseType_t xQueueSendToBack(QueueHandle_t, const void*, TickType_t);
+BaseType_t xQueueOverwrite(QueueHandle_t, const void*);
+BaseType_t xQueueReceive(QueueHandle_t, void*, TickType_t);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t); UBaseType_t uxQueueSpacesAvailable(QueueHandle_t);
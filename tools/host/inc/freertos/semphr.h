@@ -0,0 +1,9 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host stub of the FSP header, only what the tested sources use
+#include "queue.h"
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t, UBaseType_t, StaticSemaphore_t*);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutexStatic(StaticSemaphore_t*);
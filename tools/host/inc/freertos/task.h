@@ -0,0 +1,15 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host stub of the FSP header, only what the tested sources use
+#include "FreeRTOS.h"
+void vTaskDelay(TickType_t); TickType_t xTaskGetTickCount(void);
+BaseType_t xTaskNotifyGive(TaskHandle_t); void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t*); uint32_t ulTaskNotifyTake(BaseType_t, TickType_t);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TaskHandle_t xTaskCreateStatic(void (*)(void*), const char*, uint32_t, void*, UBaseType_t, StackType_t*, StaticTask_t*);
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+#define taskENTER_CRITICAL_FROM_ISR() 0
+#define taskEXIT_CRITICAL_FROM_ISR(x) (void)(x)
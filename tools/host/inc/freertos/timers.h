@@ -0,0 +1,9 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host stub of the FSP header, only what the tested sources use
+#include "FreeRTOS.h"
+TimerHandle_t xTimerCreateStatic(const char*, TickType_t, UBaseType_t, void*, void (*)(TimerHandle_t), StaticTimer_t*);
+BaseType_t xTimerChangePeriod(TimerHandle_t, TickType_t, TickType_t); BaseType_t xTimerStop(TimerHandle_t, TickType_t);
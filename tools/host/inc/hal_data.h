@@ -0,0 +1,147 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host stub of the FSP header, only what the tested sources use
+#ifndef HAL_DATA_H
+#define HAL_DATA_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+#ifndef BSP_CFG_RTOS
+#define BSP_CFG_RTOS 0
+#endif
+#define BSP_CFG_PARAM_CHECKING_ENABLE 1
+typedef int fsp_err_t;
+enum { FSP_SUCCESS=0, FSP_ERR_ASSERTION=1, FSP_ERR_INVALID_POINTER, FSP_ERR_INVALID_ARGUMENT, FSP_ERR_ALREADY_OPEN, FSP_ERR_NOT_OPEN, FSP_ERR_TIMEOUT, FSP_ERR_ABORTED, FSP_ERR_INVALID_HW_CONDITION, FSP_ERR_NOT_FOUND, FSP_ERR_SENSOR_INVALID_DATA, FSP_ERR_WRITE_FAILED, FSP_ERR_IN_USE, FSP_ERR_INVALID_DATA, FSP_ERR_UNSUPPORTED, FSP_ERR_OUT_OF_MEMORY, FSP_ERR_NOT_INITIALIZED, FSP_ERR_INVALID_STATE, FSP_ERR_INVALID_SIZE, FSP_ERR_OVERFLOW, FSP_ERR_NOT_ERASED, FSP_ERR_PE_FAILURE, FSP_ERR_INVALID_ADDRESS,FSP_ERR_BLANK_CHECK_FAILED};
+#define FSP_PARAMETER_NOT_USED(p) (void)(p)
+#define BSP_WEAK_REFERENCE __attribute__((weak))
+#define FSP_HEADER
+#define FSP_FOOTER
+#define FSP_ERROR_RETURN(a, err) do { if (!(a)) return (err); } while (0)
+#define FSP_ASSERT(a) FSP_ERROR_RETURN((a), FSP_ERR_ASSERTION)
+#define FSP_CRITICAL_SECTION_DEFINE uint32_t old_mask_level = 0
+/* Nesting of the critical sections, for the tests of what runs with the interrupts disabled (host.c) */
+extern uint32_t host_critical_depth;
+#define FSP_CRITICAL_SECTION_ENTER ((void)old_mask_level, host_critical_depth++)
+#define FSP_CRITICAL_SECTION_EXIT ((void)old_mask_level, host_critical_depth--)
+typedef enum { BSP_DELAY_UNITS_SECONDS=1000000, BSP_DELAY_UNITS_MILLISECONDS=1000, BSP_DELAY_UNITS_MICROSECONDS=1 } bsp_delay_units_t;
+void R_BSP_SoftwareDelay(uint32_t delay, bsp_delay_units_t units);
+typedef int bsp_io_port_pin_t;
+typedef int bsp_io_level_t;
+enum {BSP_IO_LEVEL_LOW, BSP_IO_LEVEL_HIGH};
+#define BSP_IO_PORT_04_PIN_00 0x400
+#define BSP_IO_PORT_04_PIN_04 0x404
+#define BSP_IO_PORT_04_PIN_15 0x40f
+#define BSP_IO_PORT_00_PIN_05 5
+#define BSP_IO_PORT_00_PIN_06 6
+#define BSP_IO_PORT_04_PIN_07 0x407
+#define BSP_IO_PORT_04_PIN_08 0x408
+void R_BSP_PinAccessEnable(void); void R_BSP_PinAccessDisable(void);
+void R_BSP_PinWrite(bsp_io_port_pin_t pin, bsp_io_level_t lvl);
+bsp_io_level_t R_BSP_PinRead(bsp_io_port_pin_t pin);
+void R_BSP_PinCfg(bsp_io_port_pin_t pin, uint32_t cfg);
+typedef struct { volatile uint32_t CTRL; } systick_t; extern systick_t *SysTick;
+#define SysTick_CTRL_ENABLE_Msk 1
+extern uint32_t SystemCoreClock; uint32_t SysTick_Config(uint32_t);
+void NVIC_SystemReset(void);
+static inline void __WFI(void) {}
+static inline void __DMB(void) {}
+static inline uint32_t __get_PRIMASK(void){return 0;}
+static inline uint32_t __get_IPSR(void){return 0;}
+static inline void __disable_irq(void){}
+static inline void __set_PRIMASK(uint32_t x){(void)x;}
+typedef struct { uint32_t CTRL; uint32_t CYCCNT; } dwt_t; extern dwt_t *DWT;
+typedef struct { uint32_t DEMCR; } cdbg_t; extern cdbg_t *CoreDebug;
+#define CoreDebug_DEMCR_TRCENA_Msk (1u<<24)
+#define DWT_CTRL_CYCCNTENA_Msk 1u
+typedef struct { uint32_t major, minor, patch, aa; } fsp_pack_version_t;
+/* rm_comms */
+typedef enum { RM_COMMS_EVENT_OPERATION_COMPLETE=0, RM_COMMS_EVENT_ERROR } rm_comms_event_t;
+typedef struct { void const *p_context; rm_comms_event_t event; } rm_comms_callback_args_t;
+typedef struct { uint8_t *p_src; uint8_t *p_dest; uint8_t src_bytes; uint8_t dest_bytes; } rm_comms_write_read_params_t;
+typedef void rm_comms_ctrl_t;
+typedef struct st_rm_comms_cfg { uint32_t semaphore_timeout; void const *p_lower_level_cfg; void const *p_extend; void (*p_callback)(rm_comms_callback_args_t*); void const *p_context; } rm_comms_cfg_t;
+typedef struct st_rm_comms_api {
+  fsp_err_t (*open)(rm_comms_ctrl_t * const p_ctrl, rm_comms_cfg_t const * const p_cfg);
+  fsp_err_t (*read)(rm_comms_ctrl_t * const p_ctrl, uint8_t * const p_dest, uint32_t const bytes);
+  fsp_err_t (*write)(rm_comms_ctrl_t * const p_ctrl, uint8_t * const p_src, uint32_t const bytes);
+  fsp_err_t (*writeRead)(rm_comms_ctrl_t * const p_ctrl, rm_comms_write_read_params_t const write_read_params);
+  fsp_err_t (*close)(rm_comms_ctrl_t * const p_ctrl);
+} rm_comms_api_t;
+typedef struct st_rm_comms_instance { rm_comms_ctrl_t *p_ctrl; rm_comms_cfg_t const *p_cfg; rm_comms_api_t const *p_api; } rm_comms_instance_t;
+typedef enum { I2C_MASTER_EVENT_ABORTED=1, I2C_MASTER_EVENT_RX_COMPLETE, I2C_MASTER_EVENT_TX_COMPLETE } i2c_master_event_t;
+typedef int i2c_master_addr_mode_t;
+typedef void i2c_master_ctrl_t;
+typedef struct { void const *p_context; i2c_master_event_t event; } i2c_master_callback_args_t;
+typedef struct { bool open; } i2c_master_status_t;
+typedef struct { uint8_t channel; uint32_t slave; i2c_master_addr_mode_t addr_mode; void (*p_callback)(i2c_master_callback_args_t *); void const *p_context; } i2c_master_cfg_t;
+typedef struct {
+  fsp_err_t (*open)(i2c_master_ctrl_t * const, i2c_master_cfg_t const * const);
+  fsp_err_t (*read)(i2c_master_ctrl_t * const, uint8_t * const, uint32_t const, bool const);
+  fsp_err_t (*write)(i2c_master_ctrl_t * const, uint8_t * const, uint32_t const, bool const);
+  fsp_err_t (*abort)(i2c_master_ctrl_t * const);
+  fsp_err_t (*slaveAddressSet)(i2c_master_ctrl_t * const, uint32_t const, i2c_master_addr_mode_t const);
+  fsp_err_t (*callbackSet)(i2c_master_ctrl_t * const, void (*)(i2c_master_callback_args_t *), void const * const, i2c_master_callback_args_t * const);
+  fsp_err_t (*statusGet)(i2c_master_ctrl_t * const, i2c_master_status_t *);
+  fsp_err_t (*close)(i2c_master_ctrl_t * const);
+} i2c_master_api_t;
+typedef struct { i2c_master_ctrl_t *p_ctrl; i2c_master_cfg_t const *p_cfg; i2c_master_api_t const *p_api; } i2c_master_instance_t;
+#define I2C_MASTER_ADDR_MODE_7BIT 1
+typedef struct { void *p_semaphore_handle; char *p_semaphore_name; void *p_semaphore_memory; } rm_comms_sem_t;
+typedef struct { void *p_mutex_handle; char *p_mutex_name; void *p_mutex_memory; } rm_comms_mutex_t;
+typedef struct { void const *p_driver_instance; void *p_current_device; rm_comms_sem_t const *p_blocking_semaphore; rm_comms_mutex_t const *p_bus_recursive_mutex; uint32_t bus_timeout; } rm_comms_i2c_bus_extended_cfg_t;
+typedef struct { void const *p_driver_instance; } rm_comms_i2c_device_extended_cfg_t;
+typedef struct { uint32_t open; rm_comms_cfg_t const *p_cfg; void *p_bus; void *p_lower_level_cfg; void (*p_callback)(rm_comms_callback_args_t*); void const *p_context; } rm_comms_i2c_instance_ctrl_t;
+extern rm_comms_i2c_bus_extended_cfg_t g_comms_i2c_bus0_extended_cfg;
+extern const rm_comms_instance_t g_comms_i2c_tgs6810, g_comms_i2c_tgs5141, g_comms_i2c_fecs43, g_comms_i2c_fecs44, g_comms_i2c_fecs50, g_comms_i2c_dummy_sensor, g_comms_i2c_device0;
+/* hs300x */
+typedef enum { RM_HS300X_EVENT_SUCCESS, RM_HS300X_EVENT_ERROR } rm_hs300x_event_t;
+typedef struct { void const *p_context; rm_hs300x_event_t event; } rm_hs300x_callback_args_t;
+typedef struct { uint8_t humidity[2]; uint8_t temperature[2]; } rm_hs300x_raw_data_t;
+typedef struct { int16_t integer_part; int16_t decimal_part; } rm_hs300x_sensor_data_t;
+typedef struct { rm_hs300x_sensor_data_t humidity, temperature; } rm_hs300x_data_t;
+typedef struct { fsp_err_t (*open)(void*, void const*); fsp_err_t (*measurementStart)(void*); fsp_err_t (*read)(void*, rm_hs300x_raw_data_t*); fsp_err_t (*dataCalculate)(void*, rm_hs300x_raw_data_t*, rm_hs300x_data_t*); fsp_err_t (*close)(void*); } rm_hs300x_api_t;
+typedef struct { rm_comms_instance_t const *p_instance; void const *p_context; void (*p_callback)(rm_hs300x_callback_args_t*); } rm_hs300x_cfg_t;
+typedef struct { void *p_ctrl; rm_hs300x_cfg_t const *p_cfg; rm_hs300x_api_t const *p_api; } rm_hs300x_instance_t;
+typedef struct { uint32_t open; void const *p_context; } rm_hs300x_instance_ctrl_t;
+void rm_hs300x_callback(rm_comms_callback_args_t * p_args);
+extern const rm_hs300x_instance_t g_hs300x_sensor0;
+/* uart */
+typedef struct { int event; uint32_t data; } uart_callback_args_t;
+enum { UART_EVENT_RX_CHAR=1, UART_EVENT_TX_COMPLETE=2, UART_EVENT_BREAK_DETECT=4, UART_EVENT_ERR_OVERFLOW=8, UART_EVENT_ERR_FRAMING=16, UART_EVENT_ERR_PARITY=32 };
+typedef struct { fsp_err_t (*open)(void*, void const*); fsp_err_t (*close)(void*); fsp_err_t (*write)(void*, uint8_t const*, uint32_t); } uart_api_t;
+typedef struct { void *p_ctrl; void const *p_cfg; uart_api_t const *p_api; } uart_instance_t;
+extern const uart_instance_t g_uart0; extern int g_uart0_ctrl, g_uart0_cfg;
+/* flash */
+typedef struct { fsp_err_t (*open)(void*, void const*); fsp_err_t (*write)(void*, uint32_t, uint32_t, uint32_t); fsp_err_t (*erase)(void*, uint32_t, uint32_t); fsp_err_t (*blankCheck)(void*, uint32_t, uint32_t, int*); fsp_err_t (*close)(void*); } flash_api_t;
+typedef struct { void *p_ctrl; void const *p_cfg; flash_api_t const *p_api; } flash_instance_t;
+typedef enum { FLASH_RESULT_BLANK, FLASH_RESULT_NOT_BLANK, FLASH_RESULT_BGO_ACTIVE } flash_result_t;
+extern const flash_instance_t g_flash0;
+#define BSP_FEATURE_FLASH_HP_VERSION 40
+#define BSP_FEATURE_FLASH_DATA_FLASH_START 0x08000000U
+#define BSP_DATA_FLASH_SIZE_BYTES 8192
+#define BSP_FEATURE_FLASH_HP_DF_BLOCK_SIZE 64
+#define BSP_FEATURE_FLASH_HP_DF_WRITE_SIZE 4
+/* gpt */
+typedef struct { fsp_err_t (*open)(void*, void const*); fsp_err_t (*start)(void*); fsp_err_t (*stop)(void*); fsp_err_t (*periodSet)(void*, uint32_t); } timer_api_t;
+void R_IOPORT_Open(void*, void*); extern int g_ioport_ctrl, g_bsp_pin_cfg;
+void R_FSP_VersionGet(fsp_pack_version_t*);
+/* common_utils.h, traps abort the test instead of hitting a breakpoint */
+#include <stdlib.h>
+#define APP_READ(read_data)
+#define APP_CHECK_DATA 0
+#define APP_TRAP() abort();
+/* ioport */
+typedef enum { BSP_WARM_START_RESET, BSP_WARM_START_POST_CLOCK, BSP_WARM_START_POST_C } bsp_warm_start_event_t;
+#define BSP_IO_PORT_05_PIN_11 0x50b
+#define BSP_IO_PORT_05_PIN_12 0x50c
+#define IOPORT_CFG_PORT_DIRECTION_OUTPUT 0x4
+#define IOPORT_CFG_PORT_OUTPUT_HIGH 0x1
+#define IOPORT_CFG_NMOS_ENABLE 0x40
+#define IOPORT_CFG_DRIVE_MID 0x400
+#define IOPORT_CFG_PERIPHERAL_PIN 0x10000
+#define IOPORT_PERIPHERAL_IIC (0x7UL << 24)
+#endif
@@ -0,0 +1,10 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host stub of the FSP header, only what the tested sources use
+#ifndef HOST_RM_COMMS_API_H
+#define HOST_RM_COMMS_API_H
+#include "hal_data.h"
+#endif
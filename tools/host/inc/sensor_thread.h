@@ -0,0 +1,17 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host stub of the FSP header, only what the tested sources use
+#ifndef HOST_SENSOR_THREAD_H
+#define HOST_SENSOR_THREAD_H
+#include "hal_data.h"
+#if BSP_CFG_RTOS == 1
+#include "tx_api.h"
+#elif BSP_CFG_RTOS == 2
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#endif
+#endif
@@ -0,0 +1,28 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host stub of the FSP header, only what the tested sources use
+#ifndef TX_API_H
+#define TX_API_H
+#include <stdint.h>
+typedef unsigned long ULONG; typedef unsigned int UINT; typedef char CHAR;
+typedef struct {int x;} TX_QUEUE; typedef struct {int x;} TX_SEMAPHORE; typedef struct {int x;} TX_MUTEX; typedef struct {int x;} TX_EVENT_FLAGS_GROUP; typedef struct {int x;} TX_THREAD; typedef struct {int x;} TX_TIMER;
+#define TX_SUCCESS 0
+#define TX_QUEUE_FULL 0x0B
+#define TX_NO_WAIT 0
+#define TX_WAIT_FOREVER 0xFFFFFFFFUL
+#define TX_INHERIT 1
+#define TX_OR 0
+#define TX_OR_CLEAR 1
+#define TX_AUTO_ACTIVATE 1
+#define TX_NO_ACTIVATE 0
+#define TX_TIMER_TICKS_PER_SECOND 1000
+UINT tx_queue_create(TX_QUEUE*, CHAR*, UINT, void*, ULONG); UINT tx_queue_send(TX_QUEUE*, void*, ULONG); UINT tx_queue_receive(TX_QUEUE*, void*, ULONG); UINT tx_queue_front_send(TX_QUEUE*, void*, ULONG); UINT tx_queue_info_get(TX_QUEUE*, CHAR**, ULONG*, ULONG*, void**, void**, void**);
+void tx_thread_sleep(ULONG); ULONG tx_time_get(void);
+UINT tx_semaphore_create(TX_SEMAPHORE*, CHAR*, ULONG); UINT tx_mutex_create(TX_MUTEX*, CHAR*, UINT);
+UINT tx_event_flags_create(TX_EVENT_FLAGS_GROUP*, CHAR*); UINT tx_event_flags_set(TX_EVENT_FLAGS_GROUP*, ULONG, UINT); UINT tx_event_flags_get(TX_EVENT_FLAGS_GROUP*, ULONG, UINT, ULONG*, ULONG);
+UINT tx_timer_create(TX_TIMER*, CHAR*, void (*)(ULONG), ULONG, ULONG, ULONG, UINT); UINT tx_timer_change(TX_TIMER*, ULONG, ULONG); UINT tx_timer_activate(TX_TIMER*); UINT tx_timer_deactivate(TX_TIMER*);
+UINT tx_thread_create(TX_THREAD*, CHAR*, void (*)(ULONG), ULONG, void*, ULONG, UINT, UINT, ULONG, UINT);
+#endif
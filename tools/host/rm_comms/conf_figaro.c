@@ -0,0 +1,15 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Comms device of the TGS6810 application (hal_data.c of the configurator), on the emulated bus
+#include "emu.h"
+
+void tgs6810_callback(rm_comms_callback_args_t * p_args);
+
+static i2c_master_cfg_t const tgs6810_lower = {.slave = 0x3E};
+static rm_comms_i2c_instance_ctrl_t tgs6810_ctrl;
+static rm_comms_cfg_t const tgs6810_cfg = {.p_lower_level_cfg = &tgs6810_lower, .p_extend = &g_comms_i2c_bus0_extended_cfg,
+                                           .p_callback = tgs6810_callback};
+const rm_comms_instance_t g_comms_i2c_tgs6810 = {.p_ctrl = &tgs6810_ctrl, .p_cfg = &tgs6810_cfg, .p_api = &emu_comms_api};
@@ -0,0 +1,21 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Comms devices of the generic application (hal_data.c of the configurator), on the emulated bus
+#include "emu.h"
+
+extern rm_hs300x_instance_ctrl_t g_hs300x_sensor0_ctrl;
+void dummy_sensor_callback(rm_comms_callback_args_t * p_args);
+
+static i2c_master_cfg_t const device0_lower = {.slave = 0x44};
+static i2c_master_cfg_t const dummy_lower = {.slave = 0x50};
+static rm_comms_i2c_instance_ctrl_t device0_ctrl;
+static rm_comms_i2c_instance_ctrl_t dummy_ctrl;
+static rm_comms_cfg_t const device0_cfg = {.p_lower_level_cfg = &device0_lower, .p_extend = &g_comms_i2c_bus0_extended_cfg,
+                                           .p_callback = rm_hs300x_callback, .p_context = &g_hs300x_sensor0_ctrl};
+static rm_comms_cfg_t const dummy_cfg = {.p_lower_level_cfg = &dummy_lower, .p_extend = &g_comms_i2c_bus0_extended_cfg,
+                                         .p_callback = dummy_sensor_callback};
+const rm_comms_instance_t g_comms_i2c_device0 = {.p_ctrl = &device0_ctrl, .p_cfg = &device0_cfg, .p_api = &emu_comms_api};
+const rm_comms_instance_t g_comms_i2c_dummy_sensor = {.p_ctrl = &dummy_ctrl, .p_cfg = &dummy_cfg, .p_api = &emu_comms_api};
@@ -0,0 +1,237 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+#include <string.h>
+#include "emu.h"
+#include "host.h"
+
+emu_faults emu_fault;
+emu_stats emu_stat[128];
+static emu_model * models[128];
+
+// The transfer of the I2C driver on the bus, completed through its callback
+static struct {
+    bool pending;
+    bool lost;
+    bool nack;
+    uint64_t due_us;
+    bool read;
+} xfer;
+
+static void (* driver_callback)(i2c_master_callback_args_t *);
+static void const * driver_context;
+static uint32_t driver_slave;
+static bool driver_restart;             // the last write of the I2C driver ended with a repeated START
+
+// The writeRead of a comms device waiting for the completion of its write, one transfer is on the bus at a time
+static struct {
+    bool pending;
+    uint8_t * p_dest;
+    uint32_t dest_bytes;
+} comms_read;
+
+// Fixed seed, the runs are reproducible
+static uint32_t rng = 12345;
+static uint32_t emu_random(void) {
+    rng = rng * 1664525U + 1013904223U;
+    return rng >> 8;
+}
+static bool emu_chance(uint32_t ppm) {
+    return (0 != ppm) && ((emu_random() % 1000000U) < ppm);
+}
+
+void emu_add_model(emu_model * m) {
+    models[m->address] = m;
+}
+
+void emu_reset_stats(void) {
+    memset(emu_stat, 0, sizeof(emu_stat));
+}
+
+static void emu_deliver(void) {
+    if (!xfer.pending || xfer.lost || (host_time_us() < xfer.due_us)) return;
+    xfer.pending = false;
+    i2c_master_callback_args_t args = {
+        .p_context = driver_context,
+        .event = xfer.nack ? I2C_MASTER_EVENT_ABORTED :
+                 (xfer.read ? I2C_MASTER_EVENT_RX_COMPLETE : I2C_MASTER_EVENT_TX_COMPLETE)};
+    driver_callback(&args);
+}
+
+void emu_advance(uint32_t us) {
+    host_advance_us(us);
+    emu_deliver();
+}
+
+// Clock of the drivers, replaces the one of host.c: a read costs 1 us, so the busy-wait loops make time progress
+uint32_t utils_systime_get(void) {
+    emu_advance(1);
+    return host_time_ms;
+}
+void utils_delay_us(uint32_t delay) {
+    emu_advance(delay);
+}
+void utils_delay_ms(uint32_t delay) {
+    emu_advance(delay * 1000U);
+}
+void R_BSP_SoftwareDelay(uint32_t delay, bsp_delay_units_t units) {
+    emu_advance(delay * (uint32_t) units);
+}
+
+// One transfer: START, address, bytes (9 bit times each), STOP. A NACK ends the transfer after the address byte. A read
+// after a repeated START continues the transfer of the write
+static fsp_err_t emu_transfer_at(uint8_t address, uint8_t * p_src, uint32_t src_bytes, uint8_t * p_dest,
+                                 uint32_t dest_bytes, bool restarted) {
+    if (xfer.pending) {
+        emu_stat[address].busy_rejects++;
+        return FSP_ERR_IN_USE;
+    }
+    emu_model * m = models[address];
+    uint32_t bits = (restarted ? 1U : 2U) + ((NULL != p_src) ? (1U + src_bytes) * 9U : 0U) +
+                    ((NULL != p_dest) ? (1U + dest_bytes) * 9U : 0U);
+    bool ack = (NULL != m) && (restarted || !emu_chance(emu_fault.nack_ppm));
+    if (ack && (NULL != p_src)) ack = m->write(m, p_src, src_bytes);
+    if (ack && (NULL != p_dest)) {
+        ack = m->read(m, p_dest, dest_bytes);
+        if (ack && emu_chance(emu_fault.corrupt_ppm)) {
+            p_dest[emu_random() % dest_bytes] ^= (uint8_t) (1U << (emu_random() % 8U));
+            emu_stat[address].corruptions++;
+        }
+    }
+    uint64_t us = ack ? ((uint64_t) bits * 10U + emu_fault.latency_us) : 110U;
+    if (!restarted) emu_stat[address].transfers++;
+    emu_stat[address].busy_us += us;
+    if (!ack) emu_stat[address].nacks++;
+    xfer.pending = true;
+    xfer.nack = !ack;
+    xfer.due_us = host_time_us() + us;
+    xfer.lost = emu_chance(emu_fault.drop_ppm);
+    if (xfer.lost) emu_stat[address].drops++;
+    return FSP_SUCCESS;
+}
+
+// Driver of the bus of a comms device, the queue of i2c.c when it is installed
+static i2c_master_instance_t const * emu_bus(rm_comms_i2c_instance_ctrl_t const * p_ctrl) {
+    return ((rm_comms_i2c_bus_extended_cfg_t const *) p_ctrl->p_cfg->p_extend)->p_driver_instance;
+}
+
+// rm_comms_i2c callback of the driver: the read of a writeRead follows its write after a repeated START
+static void emu_comms_callback(i2c_master_callback_args_t * p_args) {
+    rm_comms_i2c_instance_ctrl_t * p_ctrl = (rm_comms_i2c_instance_ctrl_t *) p_args->p_context;
+    bool error = (I2C_MASTER_EVENT_ABORTED == p_args->event);
+    if (!error && comms_read.pending) {
+        comms_read.pending = false;
+        i2c_master_instance_t const * p_bus = emu_bus(p_ctrl);
+        if (FSP_SUCCESS == p_bus->p_api->read(p_bus->p_ctrl, comms_read.p_dest, comms_read.dest_bytes, false)) return;
+        error = true;
+    }
+    comms_read.pending = false;
+    rm_comms_callback_args_t args = {.p_context = p_ctrl->p_context,
+                                     .event = error ? RM_COMMS_EVENT_ERROR : RM_COMMS_EVENT_OPERATION_COMPLETE};
+    if (NULL != p_ctrl->p_callback) p_ctrl->p_callback(&args);
+}
+
+// What rm_comms_i2c does on baremetal: address and callback of the device before each transfer, through the driver of
+// the bus, so the transfers of the comms devices and the transactions of the queue share the bus as on the target
+static fsp_err_t emu_transfer(rm_comms_ctrl_t * p_comms, uint8_t * p_src, uint32_t src_bytes, uint8_t * p_dest,
+                              uint32_t dest_bytes) {
+    rm_comms_i2c_instance_ctrl_t * p_ctrl = p_comms;
+    // As the parameter checking of rm_comms_i2c
+    if (1 != p_ctrl->open) return FSP_ERR_NOT_OPEN;
+    i2c_master_instance_t const * p_bus = emu_bus(p_ctrl);
+    uint32_t address = ((i2c_master_cfg_t const *) p_ctrl->p_cfg->p_lower_level_cfg)->slave;
+    fsp_err_t err = p_bus->p_api->slaveAddressSet(p_bus->p_ctrl, address, I2C_MASTER_ADDR_MODE_7BIT);
+    if (FSP_SUCCESS != err) return err;
+    p_bus->p_api->callbackSet(p_bus->p_ctrl, emu_comms_callback, p_ctrl, NULL);
+    if (NULL == p_src) return p_bus->p_api->read(p_bus->p_ctrl, p_dest, dest_bytes, false);
+    err = p_bus->p_api->write(p_bus->p_ctrl, p_src, src_bytes, NULL != p_dest);
+    if ((FSP_SUCCESS == err) && (NULL != p_dest)) {
+        comms_read.pending = true;
+        comms_read.p_dest = p_dest;
+        comms_read.dest_bytes = dest_bytes;
+    }
+    return err;
+}
+
+static fsp_err_t emu_open(rm_comms_ctrl_t * const p_comms, rm_comms_cfg_t const * const p_cfg) {
+    rm_comms_i2c_instance_ctrl_t * p_ctrl = p_comms;
+    if (1 == p_ctrl->open) return FSP_ERR_ALREADY_OPEN;
+    p_ctrl->p_cfg = p_cfg;
+    p_ctrl->p_callback = p_cfg->p_callback;
+    p_ctrl->p_context = p_cfg->p_context;
+    p_ctrl->open = 1;
+    return FSP_SUCCESS;
+}
+static fsp_err_t emu_close(rm_comms_ctrl_t * const p_comms) {
+    ((rm_comms_i2c_instance_ctrl_t *) p_comms)->open = 0;
+    return FSP_SUCCESS;
+}
+static fsp_err_t emu_read(rm_comms_ctrl_t * const p_comms, uint8_t * const p_dest, uint32_t const bytes) {
+    return emu_transfer(p_comms, NULL, 0, p_dest, bytes);
+}
+static fsp_err_t emu_write(rm_comms_ctrl_t * const p_comms, uint8_t * const p_src, uint32_t const bytes) {
+    return emu_transfer(p_comms, p_src, bytes, NULL, 0);
+}
+static fsp_err_t emu_write_read(rm_comms_ctrl_t * const p_comms, rm_comms_write_read_params_t const params) {
+    return emu_transfer(p_comms, params.p_src, params.src_bytes, params.p_dest, params.dest_bytes);
+}
+
+rm_comms_api_t const emu_comms_api = {
+    .open = emu_open, .read = emu_read, .write = emu_write, .writeRead = emu_write_read, .close = emu_close};
+
+// Lower level I2C driver of the bus, used by i2c_recover and by the transaction queue of i2c.c
+static fsp_err_t emu_driver_open(i2c_master_ctrl_t * const p_ctrl, i2c_master_cfg_t const * const p_cfg) {
+    return FSP_SUCCESS;
+}
+static fsp_err_t emu_driver_close(i2c_master_ctrl_t * const p_ctrl) {
+    return FSP_SUCCESS;
+}
+static fsp_err_t emu_driver_abort(i2c_master_ctrl_t * const p_ctrl) {
+    xfer.pending = false;
+    driver_restart = false;
+    comms_read.pending = false;
+    return FSP_SUCCESS;
+}
+static fsp_err_t emu_driver_callback_set(i2c_master_ctrl_t * const p_ctrl, void (* p_callback)(i2c_master_callback_args_t *),
+                                         void const * const p_context, i2c_master_callback_args_t * const p_memory) {
+    driver_callback = p_callback;
+    driver_context = p_context;
+    return FSP_SUCCESS;
+}
+static fsp_err_t emu_driver_address_set(i2c_master_ctrl_t * const p_ctrl, uint32_t const slave,
+                                        i2c_master_addr_mode_t const mode) {
+    // As r_iic_master, not while a transfer is in progress
+    if (xfer.pending) {
+        emu_stat[slave & 0x7FU].busy_rejects++;
+        return FSP_ERR_IN_USE;
+    }
+    driver_slave = slave;
+    return FSP_SUCCESS;
+}
+static fsp_err_t emu_driver_write(i2c_master_ctrl_t * const p_ctrl, uint8_t * const p_src, uint32_t const bytes,
+                                  bool const restart) {
+    fsp_err_t err = emu_transfer_at((uint8_t) driver_slave, p_src, bytes, NULL, 0, false);
+    if (FSP_SUCCESS == err) {
+        xfer.read = false;
+        driver_restart = restart && !xfer.nack;
+    }
+    return err;
+}
+static fsp_err_t emu_driver_read(i2c_master_ctrl_t * const p_ctrl, uint8_t * const p_dest, uint32_t const bytes,
+                                 bool const restart) {
+    fsp_err_t err = emu_transfer_at((uint8_t) driver_slave, NULL, 0, p_dest, bytes, driver_restart);
+    if (FSP_SUCCESS == err) {
+        xfer.read = true;
+        driver_restart = false;
+    }
+    return err;
+}
+
+static i2c_master_api_t const emu_driver_api = {
+    .open = emu_driver_open, .read = emu_driver_read, .write = emu_driver_write, .abort = emu_driver_abort,
+    .slaveAddressSet = emu_driver_address_set, .callbackSet = emu_driver_callback_set, .close = emu_driver_close};
+static i2c_master_cfg_t const emu_driver_cfg = {.slave = 0};
+static i2c_master_instance_t const emu_driver = {.p_cfg = &emu_driver_cfg, .p_api = &emu_driver_api};
+rm_comms_i2c_bus_extended_cfg_t g_comms_i2c_bus0_extended_cfg = {.p_driver_instance = &emu_driver};
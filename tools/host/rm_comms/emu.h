@@ -0,0 +1,47 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Emulated rm_comms_api_t and I2C master driver: 100 kHz bus timing on the simulated time of host.c, device models
+// behind the 7-bit addresses and fault injection
+#ifndef EMU_H_
+#define EMU_H_
+#include "hal_data.h"
+
+typedef struct emu_model {
+    uint8_t address;
+    // Bytes written (also the write part of writeRead), returns false to NACK
+    bool (*write)(struct emu_model * m, uint8_t const * p, uint32_t n);
+    // Bytes read, returns false to NACK
+    bool (*read)(struct emu_model * m, uint8_t * p, uint32_t n);
+    void * state;
+} emu_model;
+
+typedef struct {
+    uint32_t latency_us;        // clock stretching added to every transfer
+    uint32_t nack_ppm;          // probability of a NACK per transfer
+    uint32_t corrupt_ppm;       // probability of a bit flip per read transfer
+    uint32_t drop_ppm;          // probability of a lost completion callback
+} emu_faults;
+
+typedef struct {
+    uint32_t transfers;         // a writeRead is one transfer, also as a write and a read after a repeated START
+    uint32_t nacks;
+    uint32_t corruptions;
+    uint32_t drops;
+    uint32_t busy_rejects;      // transfers refused with FSP_ERR_IN_USE, the bus was busy
+    uint64_t busy_us;
+} emu_stats;
+
+extern emu_faults emu_fault;
+// Per 7-bit address
+extern emu_stats emu_stat[128];
+extern rm_comms_api_t const emu_comms_api;
+
+void emu_add_model(emu_model * m);
+// Advance the simulated time, a completion is delivered when it is due
+void emu_advance(uint32_t us);
+void emu_reset_stats(void);
+
+#endif
@@ -0,0 +1,376 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Conformance of the sensor drivers on the emulated rm_comms (emu.c): the thin layers run through Sensor Manager
+// against device models, nominal and with faults injected (latency, NACK, bit flips, lost completions). Reports per
+// driver the samples, transactions and bus-busy time per sample and the time spent in one driver call, and checks
+// that sampling goes on and sm_run() never blocks on a fault, and the time from sm_init() to the first sample
+// published by each driver. Built for the TGS6810 application (KIT_FIGARO), with FIGARO_MODULES modules at consecutive
+// addresses from 0x3E (each sample comes from the module at the address of its instance), and for the generic one
+// (HS3001 and Sensor Dummy).
+// Without argument the standard scenarios run, each in its own process. A scenario is also given by its parameters:
+//   seconds=<s> interval=<ms> latency=<us> nack=<ppm> corrupt=<ppm> drop=<ppm>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "common_utils.h"
+#include "sm.h"
+#include "host.h"
+#include "emu.h"
+#include "models.h"
+
+typedef struct {
+    char const * name;
+    uint8_t address;
+    int32_t truth;              // value of channel 0, hundredths
+    uint32_t samples;
+    uint32_t errors;
+    uint32_t invalid;
+    uint32_t wrong;             // published but different from the model, an undetected corruption
+    uint32_t calls;
+    uint64_t worst_us;
+    uint64_t total_us;
+    uint64_t first_publish_us;  // from sm_init(), 0 before the first sample
+} driver_stats;
+
+// Drivers of the application: name, address, channel 0 value, bus transactions per sample without fault (the dummy
+// driver reads the LO/HI registers of both channels in one burst)
+#ifdef KIT_FIGARO
+#define DRIVERS(X)  X(tgs6810_sensor, 0x3E, 2550, 2)
+#else
+#define DRIVERS(X)  X(hs3001_sensor, 0x44, 2500, 2) X(dummy_sensor, 0x50, 2500, 1)
+#endif
+
+enum {
+#define X(D, A, T, B) KIT_##D,
+    DRIVERS(X)
+#undef X
+    NUM_DRIVERS
+};
+static driver_stats stats[NUM_DRIVERS] = {
+#define X(D, A, T, B) {.name = #D, .address = A, .truth = T},
+    DRIVERS(X)
+#undef X
+};
+static uint32_t const transfers_per_sample[NUM_DRIVERS] = {
+#define X(D, A, T, B) B,
+    DRIVERS(X)
+#undef X
+};
+
+#ifdef KIT_FIGARO
+#ifndef FIGARO_MODULES
+#define FIGARO_MODULES  (1)
+#endif
+#define FIGARO_ADDRESS  (0x3E)
+
+// Samples of each module, the gas channel tells the module that answered
+typedef struct {
+    uint32_t samples;
+    uint32_t wrong;
+} module_stats;
+static module_stats modules[FIGARO_MODULES];
+static uint32_t misrouted;              // samples of an instance address without module
+
+static int32_t module_gas(int m) {
+    return 150 + 100 * m;
+}
+
+static void module_sample(sm_handle handle, int32_t value) {
+    int m = ((0 == handle.address) ? FIGARO_ADDRESS : handle.address) - FIGARO_ADDRESS;
+    if ((0 > m) || (FIGARO_MODULES <= m)) {
+        misrouted++;
+    } else if (SM_CH0 == handle.channel) {
+        modules[m].samples++;
+    } else if ((SM_CH2 == handle.channel) && (module_gas(m) != value)) {
+        modules[m].wrong++;
+    }
+}
+#define DEVICES         FIGARO_MODULES
+#else
+#define DEVICES         (1)
+static void module_sample(sm_handle handle, int32_t value) {
+    (void) handle;
+    (void) value;
+}
+#endif
+
+// Bus use of a driver, over the consecutive addresses of its devices
+static emu_stats driver_bus(driver_stats const * s) {
+    emu_stats bus = {0};
+    for (int a = s->address; a < s->address + DEVICES; a++) {
+        bus.transfers += emu_stat[a].transfers;
+        bus.busy_us += emu_stat[a].busy_us;
+    }
+    return bus;
+}
+
+static void account(driver_stats * s, uint64_t start) {
+    uint64_t us = host_time_us() - start;
+    s->calls++;
+    s->total_us += us;
+    if (us > s->worst_us) s->worst_us = us;
+}
+
+// Every call of Sensor Manager into a driver is timed (the test is linked with --wrap=<driver>_read, _open and _fsm)
+#define X(D, A, T, B)                                                                                   \
+    sm_sensor_status __real_##D##_read(sm_handle handle, int32_t * data);                              \
+    sm_sensor_status __wrap_##D##_read(sm_handle handle, int32_t * data) {                             \
+        uint64_t start = host_time_us();                                                                \
+        sm_sensor_status status = __real_##D##_read(handle, data);                                      \
+        driver_stats * s = &stats[KIT_##D];                                                          \
+        account(s, start);                                                                              \
+        if (SM_SENSOR_DATA_VALID == status) module_sample(handle, *data);                               \
+        if (0 == handle.channel) {                                                                      \
+            if (SM_SENSOR_DATA_VALID == status) {                                                       \
+                s->samples++;                                                                           \
+                if (s->truth != *data) s->wrong++;                                                      \
+            } else if (SM_SENSOR_INVALID_DATA == status) {                                              \
+                s->invalid++;                                                                           \
+            } else if (SM_SENSOR_ERROR == status) {                                                     \
+                s->errors++;                                                                            \
+            }                                                                                           \
+        }                                                                                               \
+        return status;                                                                                  \
+    }                                                                                                   \
+    void __real_##D##_open(sm_handle * handle, uint8_t address, uint8_t channel);                      \
+    void __wrap_##D##_open(sm_handle * handle, uint8_t address, uint8_t channel) {                     \
+        uint64_t start = host_time_us();                                                                \
+        __real_##D##_open(handle, address, channel);                                                    \
+        account(&stats[KIT_##D], start);                                                             \
+    }
+DRIVERS(X)
+#undef X
+
+#ifdef KIT_FIGARO
+void __real_tgs6810_sensor_fsm(void);
+void __wrap_tgs6810_sensor_fsm(void) {
+    uint64_t start = host_time_us();
+    __real_tgs6810_sensor_fsm();
+    account(&stats[KIT_tgs6810_sensor], start);
+}
+static figaro_model figaro[FIGARO_MODULES];
+static emu_model figaro_device[FIGARO_MODULES];
+#else
+void __real_hs3001_sensor_fsm(void);
+void __wrap_hs3001_sensor_fsm(void) {
+    uint64_t start = host_time_us();
+    __real_hs3001_sensor_fsm();
+    account(&stats[KIT_hs3001_sensor], start);
+}
+void __real_dummy_sensor_fsm(void);
+void __wrap_dummy_sensor_fsm(void) {
+    uint64_t start = host_time_us();
+    __real_dummy_sensor_fsm();
+    account(&stats[KIT_dummy_sensor], start);
+}
+// 25.00 C and 50 %RH: raw = (T + 40) / 165 * 16383, RH / 100 * 16383
+static hs3001_model hs3001 = {.raw_humidity = 8192, .raw_temperature = 6454};
+static emu_model hs3001_device;
+// Registers of Sensor Dummy: temperature 25.00 C (0x09C4) and humidity 60.00 %RH (0x1770)
+static regmap_model dummy = {.regs = {[2] = 0xC4, [3] = 0x09, [4] = 0x70, [5] = 0x17}};
+static emu_model dummy_device;
+#endif
+
+typedef struct {
+    char const * name;
+    uint32_t seconds;
+    uint32_t interval;
+    emu_faults faults;
+} scenario;
+
+static scenario const scenarios[] = {
+    {"nominal", 20, 100, {0}},
+    {"latency 2ms", 20, 100, {.latency_us = 2000}},
+    {"nack 1%", 20, 100, {.nack_ppm = 10000}},
+    {"corrupt 1%", 20, 100, {.corrupt_ppm = 10000}},
+    {"drop 0.1%", 20, 100, {.drop_ppm = 1000}},
+};
+
+// Boot ends when every driver published a sample
+#define FIRST_PUBLISH_WAIT_US   (2000000U)
+// First sample of a driver without fault: the HS3001 conversion (35 ms) and the bus, it does not wait for an
+// acquisition interval (1000 ms) nor for the other sensors to open
+#define FIRST_PUBLISH_MAX_US    (40000U)
+
+// Longest call of a driver, every driver is split-phase and never waits for the bus
+#define CALL_MAX_US             (100U)
+// Longest sm_run(): a call of each driver and a bus recovery, not a transfer timeout
+#define RUN_MAX_US              (1000U)
+
+static uint64_t boot_us;
+
+static void first_publish(sm_handle handle, uint8_t * data, uint16_t size) {
+    (void) data;
+    (void) size;
+    for (int d = 0; d < NUM_DRIVERS; d++) {
+        if ((0 == stats[d].first_publish_us) && (0 == strcmp(stats[d].name, sm_get_sensor_id(handle)))) {
+            stats[d].first_publish_us = host_time_us() - boot_us;
+        }
+    }
+}
+
+static int run(scenario const * p_scenario) {
+    emu_fault = p_scenario->faults;
+#ifdef KIT_FIGARO
+    for (int m = 0; m < FIGARO_MODULES; m++) {
+        figaro[m] = (figaro_model) {.temperature = 25.5F, .humidity = 40.25F, .gas = module_gas(m) / 100.0F,
+                                    .prepare_us = 200};
+        figaro_model_init(&figaro_device[m], &figaro[m], (uint8_t) (FIGARO_ADDRESS + m));
+    }
+#else
+    hs3001_model_init(&hs3001_device, &hs3001, 0x44);
+    regmap_model_init(&dummy_device, &dummy, 0x50);
+#endif
+    boot_us = host_time_us();
+    sm_init();
+    sm_register_callback_any_type(first_publish);
+    // Boot: sm_init() does not open the sensors, sm_run() opens them and publishes the first samples
+    for (int pending = NUM_DRIVERS; (0 < pending) && (host_time_us() - boot_us < FIRST_PUBLISH_WAIT_US); ) {
+        sm_run();
+        emu_advance(100);
+        pending = 0;
+        for (int d = 0; d < NUM_DRIVERS; d++) pending += (0 == stats[d].first_publish_us);
+    }
+    printf("%s: first samples after", p_scenario->name);
+    for (int d = 0; d < NUM_DRIVERS; d++) {
+        printf(" %s %.1f ms", stats[d].name, stats[d].first_publish_us / 1000.0);
+        CHECK(0 < stats[d].first_publish_us);
+        if (0 == memcmp(&p_scenario->faults, &(emu_faults) {0}, sizeof(emu_faults))) {
+            CHECK(stats[d].first_publish_us <= FIRST_PUBLISH_MAX_US);
+        }
+    }
+    printf("\n");
+    uint16_t index = 0;
+    sm_handle handle;
+    while (0 == sm_get_sensor_handle(SENSOR_ANY_TYPE, &handle, &index)) {
+        sm_set_sensor_attribute(handle, SM_ACQUISITION_INTERVAL, p_scenario->interval);
+    }
+    emu_reset_stats();
+#ifdef KIT_FIGARO
+    memset(modules, 0, sizeof(modules));
+#endif
+    for (int d = 0; d < NUM_DRIVERS; d++) {
+        stats[d].samples = stats[d].errors = stats[d].invalid = stats[d].wrong = stats[d].calls = 0;
+        stats[d].worst_us = stats[d].total_us = 0;
+    }
+
+    uint64_t start = host_time_us();
+    uint64_t worst_run = 0;
+    while (host_time_us() - start < (uint64_t) p_scenario->seconds * 1000000U) {
+        uint64_t t0 = host_time_us();
+        sm_run();
+        if (host_time_us() - t0 > worst_run) worst_run = host_time_us() - t0;
+        emu_advance(100);
+    }
+
+    printf("%s, %u s at %u ms\n", p_scenario->name, p_scenario->seconds, p_scenario->interval);
+    printf("  %-15s %8s %7s %7s %6s %9s %10s %10s %9s\n", "driver", "samples", "errors", "invalid", "wrong", "xfer/smp",
+           "busy/smp", "worst call", "mean call");
+    double busy = 0;
+    uint32_t expected = p_scenario->seconds * 1000U / p_scenario->interval;
+    for (int d = 0; d < NUM_DRIVERS; d++) {
+        driver_stats * s = &stats[d];
+        emu_stats e = driver_bus(s);
+        busy += (double) e.busy_us;
+        double n = s->samples ? (double) s->samples : 1.0;
+        printf("  %-15s %8u %7u %7u %6u %9.2f %8.0fus %8lluus %7.1fus\n", s->name, s->samples, s->errors, s->invalid,
+               s->wrong, e.transfers / n, e.busy_us / n, (unsigned long long) s->worst_us,
+               s->calls ? (double) s->total_us / s->calls : 0.0);
+
+        // Sampling goes on: a fault costs the sample it hits, not the following ones (HS3001 starts its 35 ms
+        // conversion at the end of the interval, it samples every 135 ms)
+        CHECK(s->samples >= expected / 2U);
+        CHECK(s->worst_us <= CALL_MAX_US);
+        if (0 == memcmp(&p_scenario->faults, &(emu_faults) {0}, sizeof(emu_faults))) {
+            CHECK((0 == s->errors) && (0 == s->invalid) && (0 == s->wrong));
+            // A sample of each device can be in progress when the statistics are reset and when the run ends
+            CHECK(e.transfers + transfers_per_sample[d] * DEVICES >= transfers_per_sample[d] * s->samples);
+            CHECK(e.transfers <= transfers_per_sample[d] * (s->samples + DEVICES));
+        }
+        if (0 == p_scenario->faults.corrupt_ppm) {
+            CHECK(0 == s->wrong);
+        }
+    }
+    printf("  bus busy %.2f%%, worst sm_run %llu us\n", 100.0 * busy / (double) (host_time_us() - start),
+           (unsigned long long) worst_run);
+    CHECK(worst_run <= RUN_MAX_US);
+#ifdef KIT_FIGARO
+    // Each module is sampled at the interval, from the instances of its address only
+    uint32_t aggregate = 0;
+    uint32_t fewest = UINT32_MAX;
+    uint32_t most = 0;
+    for (int m = 0; m < FIGARO_MODULES; m++) {
+        emu_stats * e = &emu_stat[FIGARO_ADDRESS + m];
+        double n = modules[m].samples ? (double) modules[m].samples : 1.0;
+        printf("  figaro 0x%02X: %u samples, %u wrong module, %.2f xfer/smp, %u reads before the frame was ready, "
+               "%u transfers refused on a busy bus\n", FIGARO_ADDRESS + m, modules[m].samples, modules[m].wrong,
+               e->transfers / n, figaro[m].early_reads, e->busy_rejects);
+        CHECK(modules[m].samples >= expected / 2U);
+        CHECK(0 == figaro[m].early_reads);
+        if (0 == p_scenario->faults.corrupt_ppm) {
+            CHECK(0 == modules[m].wrong);
+        }
+        aggregate += modules[m].samples;
+        if (modules[m].samples < fewest) fewest = modules[m].samples;
+        if (modules[m].samples > most) most = modules[m].samples;
+    }
+    if (1 < FIGARO_MODULES) {
+        printf("  %d modules: %.1f samples/s\n", FIGARO_MODULES, aggregate / (double) p_scenario->seconds);
+    }
+    CHECK(0 == misrouted);
+    CHECK(aggregate == stats[KIT_tgs6810_sensor].samples);
+    // The modules share the bus in turn, a sample takes 1.4 % of it: each one keeps the rate of a module alone
+    CHECK(fewest >= most - most / 20U);
+    if (0 == memcmp(&p_scenario->faults, &(emu_faults) {0}, sizeof(emu_faults))) {
+        CHECK(aggregate >= FIGARO_MODULES * (expected - expected / 20U));
+    }
+#else
+    // Read once the conversion has ended, no second read after a stale status
+    printf("  hs3001: %u stale reads\n", hs3001.stale_reads);
+    CHECK(0 == hs3001.stale_reads);
+#endif
+    return (0 == host_failures) ? 0 : 1;
+}
+
+int main(int argc, char ** argv) {
+    if (1 < argc) {
+        scenario custom = {"custom", 60, 100, {0}};
+        for (int i = 1; i < argc; i++) {
+            if (!strncmp(argv[i], "seconds=", 8)) custom.seconds = (uint32_t) atoi(argv[i] + 8);
+            else if (!strncmp(argv[i], "interval=", 9)) custom.interval = (uint32_t) atoi(argv[i] + 9);
+            else if (!strncmp(argv[i], "latency=", 8)) custom.faults.latency_us = (uint32_t) atoi(argv[i] + 8);
+            else if (!strncmp(argv[i], "nack=", 5)) custom.faults.nack_ppm = (uint32_t) atoi(argv[i] + 5);
+            else if (!strncmp(argv[i], "corrupt=", 8)) custom.faults.corrupt_ppm = (uint32_t) atoi(argv[i] + 8);
+            else if (!strncmp(argv[i], "drop=", 5)) custom.faults.drop_ppm = (uint32_t) atoi(argv[i] + 5);
+        }
+        host_failures = (uint32_t) run(&custom);
+    } else {
+        // Each scenario starts from a fresh application (drivers, Sensor Manager and bus)
+        for (unsigned i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+            fflush(stdout);
+            pid_t pid = fork();
+            if (0 == pid) {
+                host_failures = 0;
+                exit(run(&scenarios[i]));
+            }
+            int status = 0;
+            waitpid(pid, &status, 0);
+            CHECK(WIFEXITED(status) && (0 == WEXITSTATUS(status)));
+        }
+    }
+#if defined(KIT_FIGARO) && (1 < FIGARO_MODULES)
+    char name[40];
+    snprintf(name, sizeof(name), "rm_comms figaro, %d modules", FIGARO_MODULES);
+    return host_result(name);
+#elif defined(KIT_FIGARO)
+    return host_result("rm_comms figaro");
+#elif I2C_CFG_SCHEDULE_ENABLE
+    return host_result("rm_comms generic, transaction queue");
+#else
+    return host_result("rm_comms generic");
+#endif
+}
@@ -0,0 +1,65 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+#include <string.h>
+#include "host.h"
+#include "models.h"
+
+static bool figaro_write(emu_model * m, uint8_t const * p, uint32_t n) {
+    figaro_model * s = m->state;
+    if ((1 != n) || (0x80 != p[0])) return false;
+    s->requests++;
+    s->ready_us = host_time_us() + s->prepare_us;
+    return true;
+}
+static bool figaro_read(emu_model * m, uint8_t * p, uint32_t n) {
+    figaro_model * s = m->state;
+    float frame[3] = {s->temperature, s->humidity, s->gas};
+    if (host_time_us() < s->ready_us) s->early_reads++;
+    memcpy(p, frame, (n < sizeof(frame)) ? n : sizeof(frame));
+    return true;
+}
+void figaro_model_init(emu_model * m, figaro_model * s, uint8_t address) {
+    *m = (emu_model) {.address = address, .write = figaro_write, .read = figaro_read, .state = s};
+    emu_add_model(m);
+}
+
+static bool hs3001_write(emu_model * m, uint8_t const * p, uint32_t n) {
+    hs3001_model * s = m->state;
+    s->ready_us = host_time_us() + 35000U;
+    s->fresh = true;
+    return true;
+}
+static bool hs3001_read(emu_model * m, uint8_t * p, uint32_t n) {
+    hs3001_model * s = m->state;
+    uint8_t status = (s->fresh && (host_time_us() >= s->ready_us)) ? 0x00 : 0x40;
+    if (0x40 == status) s->stale_reads++;
+    uint8_t frame[4] = {(uint8_t) (status | (s->raw_humidity >> 8)), (uint8_t) s->raw_humidity,
+                        (uint8_t) (s->raw_temperature >> 6), (uint8_t) (s->raw_temperature << 2)};
+    memcpy(p, frame, (n < sizeof(frame)) ? n : sizeof(frame));
+    if (0 == status) s->fresh = false;
+    return true;
+}
+void hs3001_model_init(emu_model * m, hs3001_model * s, uint8_t address) {
+    *m = (emu_model) {.address = address, .write = hs3001_write, .read = hs3001_read, .state = s};
+    emu_add_model(m);
+}
+
+static bool regmap_write(emu_model * m, uint8_t const * p, uint32_t n) {
+    regmap_model * s = m->state;
+    if (0 == n) return true;
+    s->pointer = p[0];
+    for (uint32_t i = 1; i < n; i++) s->regs[s->pointer++] = p[i];
+    return true;
+}
+static bool regmap_read(emu_model * m, uint8_t * p, uint32_t n) {
+    regmap_model * s = m->state;
+    for (uint32_t i = 0; i < n; i++) p[i] = s->regs[s->pointer++];
+    return true;
+}
+void regmap_model_init(emu_model * m, regmap_model * s, uint8_t address) {
+    *m = (emu_model) {.address = address, .write = regmap_write, .read = regmap_read, .state = s};
+    emu_add_model(m);
+}
@@ -0,0 +1,41 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Device models of the emulated bus
+#ifndef MODELS_H_
+#define MODELS_H_
+#include "emu.h"
+
+// Figaro module: 0x80 requests a frame, its 12 bytes (3 x float32 LE) can be read prepare_us later
+typedef struct {
+    float temperature;
+    float humidity;
+    float gas;
+    uint32_t prepare_us;
+    uint64_t ready_us;
+    uint32_t early_reads;       // reads before the frame was ready
+    uint32_t requests;
+} figaro_model;
+
+// HS3001: a write starts a 35 ms conversion, 4 bytes are read, the status is stale (01) until the conversion ends
+typedef struct {
+    uint16_t raw_humidity;
+    uint16_t raw_temperature;
+    uint64_t ready_us;
+    bool fresh;
+    uint32_t stale_reads;
+} hs3001_model;
+
+// Register map with auto-increment, the first byte written selects the register
+typedef struct {
+    uint8_t regs[256];
+    uint8_t pointer;
+} regmap_model;
+
+void figaro_model_init(emu_model * m, figaro_model * s, uint8_t address);
+void hs3001_model_init(emu_model * m, hs3001_model * s, uint8_t address);
+void regmap_model_init(emu_model * m, regmap_model * s, uint8_t address);
+
+#endif
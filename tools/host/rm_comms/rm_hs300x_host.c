@@ -0,0 +1,69 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Host version of the FSP rm_hs300x driver (generated into ra/, not part of the tree), over the emulated rm_comms, and
+// its configured instance g_hs300x_sensor0
+#include "hal_data.h"
+
+static rm_comms_instance_t const * hs300x_comms(void * p_ctrl) {
+    return ((rm_hs300x_cfg_t const *) ((rm_hs300x_instance_ctrl_t *) p_ctrl)->p_context)->p_instance;
+}
+
+static fsp_err_t hs300x_open(void * p_ctrl, void const * p_cfg) {
+    rm_hs300x_instance_ctrl_t * ctrl = p_ctrl;
+    rm_hs300x_cfg_t const * cfg = p_cfg;
+    if (ctrl->open) return FSP_ERR_ALREADY_OPEN;
+    ctrl->open = 1;
+    ctrl->p_context = cfg;
+    return cfg->p_instance->p_api->open(cfg->p_instance->p_ctrl, cfg->p_instance->p_cfg);
+}
+static fsp_err_t hs300x_close(void * p_ctrl) {
+    rm_comms_instance_t const * comms = hs300x_comms(p_ctrl);
+    ((rm_hs300x_instance_ctrl_t *) p_ctrl)->open = 0;
+    return comms->p_api->close(comms->p_ctrl);
+}
+// A write without data starts a measurement
+static uint8_t hs300x_no_data;
+static fsp_err_t hs300x_measurement_start(void * p_ctrl) {
+    rm_comms_instance_t const * comms = hs300x_comms(p_ctrl);
+    return comms->p_api->write(comms->p_ctrl, &hs300x_no_data, 0);
+}
+static fsp_err_t hs300x_read(void * p_ctrl, rm_hs300x_raw_data_t * p_raw) {
+    rm_comms_instance_t const * comms = hs300x_comms(p_ctrl);
+    return comms->p_api->read(comms->p_ctrl, (uint8_t *) p_raw, 4);
+}
+static fsp_err_t hs300x_data_calculate(void * p_ctrl, rm_hs300x_raw_data_t * p_raw, rm_hs300x_data_t * p_data) {
+    if (0 != (p_raw->humidity[0] & 0xC0)) return FSP_ERR_SENSOR_INVALID_DATA;
+    uint32_t h = ((uint32_t) (p_raw->humidity[0] & 0x3F) << 8) | p_raw->humidity[1];
+    uint32_t t = (((uint32_t) p_raw->temperature[0] << 8) | p_raw->temperature[1]) >> 2;
+    int32_t humidity = (int32_t) (h * 10000U / 16383U);
+    int32_t temperature = (int32_t) (t * 16500U / 16383U) - 4000;
+    p_data->humidity.integer_part = (int16_t) (humidity / 100);
+    p_data->humidity.decimal_part = (int16_t) (humidity % 100);
+    p_data->temperature.integer_part = (int16_t) (temperature / 100);
+    p_data->temperature.decimal_part = (int16_t) (temperature % 100);
+    return FSP_SUCCESS;
+}
+static rm_hs300x_api_t const hs300x_api = {.open = hs300x_open, .measurementStart = hs300x_measurement_start,
+                                           .read = hs300x_read, .dataCalculate = hs300x_data_calculate,
+                                           .close = hs300x_close};
+
+// Comms callback of the driver, the context is its control block
+void hs300x_callback(rm_hs300x_callback_args_t * p_args);
+void rm_hs300x_callback(rm_comms_callback_args_t * p_args) {
+    rm_hs300x_instance_ctrl_t const * ctrl = p_args->p_context;
+    rm_hs300x_cfg_t const * cfg = ctrl->p_context;
+    rm_hs300x_callback_args_t args = {
+        .p_context = cfg->p_context,
+        .event = (RM_COMMS_EVENT_OPERATION_COMPLETE == p_args->event) ? RM_HS300X_EVENT_SUCCESS : RM_HS300X_EVENT_ERROR};
+    cfg->p_callback(&args);
+}
+
+extern const rm_comms_instance_t g_comms_i2c_device0;
+rm_hs300x_instance_ctrl_t g_hs300x_sensor0_ctrl;
+static rm_hs300x_cfg_t const g_hs300x_sensor0_cfg = {.p_instance = &g_comms_i2c_device0, .p_context = NULL,
+                                                     .p_callback = hs300x_callback};
+const rm_hs300x_instance_t g_hs300x_sensor0 = {.p_ctrl = &g_hs300x_sensor0_ctrl, .p_cfg = &g_hs300x_sensor0_cfg,
+                                               .p_api = &hs300x_api};
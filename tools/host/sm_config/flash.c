@@ -0,0 +1,81 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "common_utils.h"
+#include "sm_config.h"
+#include "flash.h"
+
+flash_stats g_flash = {.cut_at = FLASH_NO_CUT};
+jmp_buf g_flash_cut;
+static uint8_t * area;
+static uint64_t random_state = 88172645463325252ULL;
+
+// Erased or half programmed data flash reads any value
+static uint32_t undefined(void) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return (uint32_t) random_state;
+}
+
+// One word erased or programmed, the power cut leaves it undefined
+static void step(uint32_t offset, uint32_t value) {
+    if (g_flash.steps++ == g_flash.cut_at) {
+        value = undefined();
+        memcpy(&area[offset], &value, sizeof(value));
+        msync(area, SM_CFG_CONFIG_FLASH_SIZE, MS_SYNC);
+        longjmp(g_flash_cut, 1);
+    }
+    memcpy(&area[offset], &value, sizeof(value));
+}
+
+void flash_map(char const * path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if ((0 > fd) || (0 != ftruncate(fd, SM_CFG_CONFIG_FLASH_SIZE))) exit(2);
+    area = mmap(NULL, SM_CFG_CONFIG_FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == area) exit(2);
+    for (uint32_t offset = 0; SM_CFG_CONFIG_FLASH_SIZE > offset; offset += 4) {
+        uint32_t value = undefined();
+        memcpy(&area[offset], &value, sizeof(value));
+    }
+}
+
+uint8_t * flash_area(void) {
+    return area;
+}
+
+sm_result sm_config_flash_open(void) {
+    return (NULL != area) ? SM_OK : SM_ERROR;
+}
+
+uint8_t const * sm_config_flash_data(void) {
+    return area;
+}
+
+sm_result sm_config_flash_erase(uint32_t offset, uint32_t size) {
+    if ((0 != offset % SM_CONFIG_FLASH_BLOCK_SIZE) || (0 != size % SM_CONFIG_FLASH_BLOCK_SIZE) ||
+        (SM_CFG_CONFIG_FLASH_SIZE < offset + size)) return SM_ERROR;
+    g_flash.erases++;
+    g_flash.last_erase = offset;
+    for (uint32_t i = 0; size > i; i += 4) step(offset + i, undefined());
+    return SM_OK;
+}
+
+sm_result sm_config_flash_write(uint32_t offset, uint8_t const * data, uint32_t size) {
+    if ((0 != offset % 4) || (0 != size % 4) || (SM_CFG_CONFIG_FLASH_SIZE < offset + size)) return SM_ERROR;
+    g_flash.writes++;
+    for (uint32_t i = 0; size > i; i += 4) {
+        uint32_t value;
+        memcpy(&value, &data[i], sizeof(value));
+        step(offset + i, value);
+    }
+    return SM_OK;
+}
@@ -0,0 +1,33 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// File-backed storage port of sm_config.c: the area is a file mapped in memory, read in place like the data flash.
+// Erase leaves undefined values, erase and write proceed one 4 byte word at a time and a power cut can stop them at
+// any word
+#ifndef FLASH_H_
+#define FLASH_H_
+#include <setjmp.h>
+#include <stdint.h>
+
+#define FLASH_NO_CUT    (UINT32_MAX)
+
+typedef struct {
+    uint32_t steps;             // words erased or programmed since the last reset of the counters
+    uint32_t cut_at;            // step stopped by the power cut, FLASH_NO_CUT for none
+    uint32_t erases;            // erase calls
+    uint32_t writes;            // write calls
+    uint32_t last_erase;        // offset of the last erase
+} flash_stats;
+
+extern flash_stats g_flash;
+// Where the power cut returns to, the operation in progress is abandoned
+extern jmp_buf g_flash_cut;
+
+// Map the file backing the area, filled with undefined values when it is created
+void flash_map(char const * path);
+// Area in the file, the test alters it to corrupt a record
+uint8_t * flash_area(void);
+
+#endif
@@ -0,0 +1,233 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Persistent configuration of Sensor Manager (built with SM_CFG_CONFIG_ENABLE) on a file-backed storage port
+// (flash.c): a save is cut at every word it erases or programs (during the erase, the header, the entries, the CRC and
+// before the commit word) and the next boot restores the previous record. The commit word is written last, a record
+// with a wrong CRC is ignored, the scan finds the newest record in every slot while the older ones stay intact, and
+// the newest record is still found when the sequence number wraps around
+#include <string.h>
+#include "common_utils.h"
+#include "sm.h"
+#include "sm_config.h"
+#include "host.h"
+#include "flash.h"
+
+// Record layout of sm_config.c: header | entries | CRC-32 | commit word, in slots of whole erase blocks
+#define RECORD_MAGIC    (0x464E4353U)
+#define RECORD_COMMIT   (0x54494D43U)
+#define DATA_SIZE       (sizeof(sm_config_header) + (NUM_SENSORS * sizeof(sm_config_entry)))
+#define SLOT_SIZE       (((DATA_SIZE + 8U + SM_CONFIG_FLASH_BLOCK_SIZE - 1U) / SM_CONFIG_FLASH_BLOCK_SIZE) * \
+                         SM_CONFIG_FLASH_BLOCK_SIZE)
+#define NUM_SLOTS       (SM_CFG_CONFIG_FLASH_SIZE / SLOT_SIZE)
+// Words erased, then programmed (header, entries and CRC in one write, the commit word in a second one)
+#define ERASE_STEPS     (SLOT_SIZE / 4U)
+#define ENTRIES_STEP    (ERASE_STEPS + sizeof(sm_config_header) / 4U)
+#define CRC_STEP        (ERASE_STEPS + DATA_SIZE / 4U)
+#define COMMIT_STEP     (CRC_STEP + 1U)
+#define SAVE_STEPS      (COMMIT_STEP + 1U)
+// Acquisition interval of the instances before any save
+#define DEFAULT_MS      (1000U)
+
+static sm_handle handles[NUM_SENSORS];
+static uint32_t driver_sample[NUM_SENSORS];
+
+void fake_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
+    handle->address = address;
+    handle->channel = channel;
+}
+void fake_sensor_close(sm_handle handle) { (void) handle; }
+sm_sensor_status fake_sensor_read(sm_handle handle, int32_t * data) {
+    (void) handle;
+    *data = 0;
+    return SM_SENSOR_DATA_VALID;
+}
+sm_result fake_sensor_set_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t value) {
+    int16_t i = sm_get_sensor_index(handle);
+    if ((SM_SAMPLE_INTERVAL != attr) || (0 > i)) return SM_NOT_SUPPORTED;
+    driver_sample[i] = value;
+    return SM_OK;
+}
+
+// CRC-32 (IEEE 802.3) one bit at a time, the reference of the nibble table of sm_config.c
+static uint32_t crc32(uint8_t const * data, uint32_t size) {
+    uint32_t crc = 0xFFFFFFFFU;
+    while (0 < size--) {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+    return ~crc;
+}
+
+static sm_config_header * record(uint32_t slot) {
+    return (sm_config_header *) (flash_area() + slot * SLOT_SIZE);
+}
+
+static uint32_t * trailer(uint32_t slot) {
+    return (uint32_t *) (flash_area() + slot * SLOT_SIZE + DATA_SIZE);
+}
+
+static bool committed(uint32_t slot) {
+    return (RECORD_MAGIC == record(slot)->magic) && (RECORD_COMMIT == trailer(slot)[1]) &&
+           (crc32((uint8_t const *) record(slot), DATA_SIZE) == trailer(slot)[0]);
+}
+
+// Reset: SM reads the newest record in sm_init() and gives the drivers their attributes when it opens them
+static void boot(void) {
+    // RAM is initialized by the reset, sm_init() leaves the intervals of the instance definitions to it
+    for (int i = 0; i < NUM_SENSORS; i++) sm_set_sensor_attribute(handles[i], SM_ACQUISITION_INTERVAL, DEFAULT_MS);
+    memset(driver_sample, 0, sizeof(driver_sample));
+    sm_init();
+    for (int n = 0; n < 4; n++) sm_run();
+    uint16_t index = 0;
+    for (int i = 0; i < NUM_SENSORS; i++) sm_get_sensor_handle(SENSOR_ANY_TYPE, &handles[i], &index);
+}
+
+// Configuration restored by the last boot: value if every instance has the attributes of the save of value, 0 for
+// the defaults, UINT32_MAX for a mix
+static uint32_t restored(void) {
+    uint32_t value = 0;
+    for (int i = 0; i < NUM_SENSORS; i++) {
+        uint32_t interval = 0;
+        sm_get_sensor_attribute(handles[i], SM_ACQUISITION_INTERVAL, &interval);
+        uint32_t instance = ((DEFAULT_MS == interval) && (0 == driver_sample[i])) ? 0 : interval - (uint32_t) i;
+        if ((0 != instance) && (driver_sample[i] != instance / 2U + (uint32_t) i)) return UINT32_MAX;
+        if ((0 < i) && (instance != value)) return UINT32_MAX;
+        value = instance;
+    }
+    return value;
+}
+
+// Sets the attributes of every instance from value and saves them, the power is cut at step cut
+static bool save(uint32_t value, uint32_t cut) {
+    for (int i = 0; i < NUM_SENSORS; i++) {
+        sm_set_sensor_attribute(handles[i], SM_ACQUISITION_INTERVAL, value + (uint32_t) i);
+        sm_set_sensor_attribute(handles[i], SM_SAMPLE_INTERVAL, value / 2U + (uint32_t) i);
+    }
+    g_flash.steps = 0;
+    g_flash.cut_at = cut;
+    bool saved = false;
+    if (0 == setjmp(g_flash_cut)) saved = (SM_OK == sm_save_config());
+    g_flash.cut_at = FLASH_NO_CUT;
+    return saved;
+}
+
+static void test_cuts(void) {
+    boot();
+    CHECK(0 == restored());
+    uint32_t writes = g_flash.writes;
+    CHECK(save(2000, FLASH_NO_CUT));
+    // The commit word goes in a write of its own, after the data and the CRC
+    CHECK(SAVE_STEPS == g_flash.steps);
+    CHECK(2 == g_flash.writes - writes);
+    boot();
+    CHECK(2000 == restored());
+    uint32_t previous = 2000;
+    uint32_t cuts[4] = {0};
+    for (uint32_t cut = 0; cut < SAVE_STEPS; cut++) {
+        CHECK(!save(3000 + cut, cut));
+        uint32_t torn = g_flash.last_erase / SLOT_SIZE;
+        boot();
+        CHECK(previous == restored());
+        if (cut < ENTRIES_STEP) {
+            cuts[0]++;
+        } else if (cut < CRC_STEP) {
+            cuts[1]++;
+        } else if (cut == CRC_STEP) {
+            cuts[2]++;
+        } else {
+            // Data and CRC are complete, only the commit word is missing
+            CHECK(crc32((uint8_t const *) record(torn), DATA_SIZE) == trailer(torn)[0]);
+            CHECK(RECORD_COMMIT != trailer(torn)[1]);
+            cuts[3]++;
+        }
+        // A save after the cut goes in the slot of the torn record, the previous one is kept
+        if (0 == cut % 8) {
+            CHECK(save(4000 + cut, FLASH_NO_CUT));
+            CHECK(torn == g_flash.last_erase / SLOT_SIZE);
+            previous = 4000 + cut;
+            boot();
+            CHECK(previous == restored());
+        }
+    }
+    printf("%u bytes per slot, %u slots, %u steps per save: %u cuts in the erase and the header, %u in the entries, "
+           "%u in the CRC, %u before the commit word, previous record restored\n", (unsigned) SLOT_SIZE,
+           (unsigned) NUM_SLOTS, (unsigned) SAVE_STEPS, cuts[0], cuts[1], cuts[2], cuts[3]);
+}
+
+// A bit flip in the entries or in the CRC of the newest record falls back to the previous record
+static void test_crc(void) {
+    CHECK(save(5000, FLASH_NO_CUT));
+    CHECK(save(5100, FLASH_NO_CUT));
+    uint32_t newest = g_flash.last_erase / SLOT_SIZE;
+    CHECK(committed(newest));
+    uint8_t * entry = (uint8_t *) (record(newest) + 1) + sizeof(sm_config_entry) + 4;
+    *entry ^= 0x10;
+    boot();
+    CHECK(5000 == restored());
+    *entry ^= 0x10;
+    boot();
+    CHECK(5100 == restored());
+    trailer(newest)[0] ^= 0x80000000U;
+    boot();
+    CHECK(5000 == restored());
+    trailer(newest)[0] ^= 0x80000000U;
+    boot();
+    CHECK(5100 == restored());
+}
+
+// Saves go to the slots in turn, the scan finds the newest record wherever it is and the older ones stay intact
+static void test_slot_scan(void) {
+    uint32_t misplaced = 0;
+    uint32_t lost = 0;
+    for (uint32_t k = 0; k < 3 * NUM_SLOTS; k++) {
+        uint32_t slot = (g_flash.last_erase / SLOT_SIZE + 1U) % NUM_SLOTS;
+        CHECK(save(6000 + 10 * k, FLASH_NO_CUT));
+        if (slot != g_flash.last_erase / SLOT_SIZE) misplaced++;
+        boot();
+        if (6000 + 10 * k != restored()) lost++;
+    }
+    uint32_t records = 0;
+    for (uint32_t slot = 0; slot < NUM_SLOTS; slot++) {
+        if (committed(slot)) records++;
+    }
+    CHECK(0 == misplaced);
+    CHECK(0 == lost);
+    CHECK(NUM_SLOTS == records);
+}
+
+// The sequence numbers of the records are moved next to the wrap around, saves go on through it
+static void test_rollover(void) {
+    uint32_t newest = g_flash.last_erase / SLOT_SIZE;
+    uint32_t shift = 0xFFFFFFFDU - record(newest)->sequence;
+    for (uint32_t slot = 0; slot < NUM_SLOTS; slot++) {
+        if (!committed(slot)) continue;
+        record(slot)->sequence += shift;
+        trailer(slot)[0] = crc32((uint8_t const *) record(slot), DATA_SIZE);
+    }
+    uint32_t value = 7000;
+    boot();
+    CHECK(restored() == 6000 + 10 * (3 * NUM_SLOTS - 1));
+    for (uint32_t k = 0; k < NUM_SLOTS + 2; k++) {
+        CHECK(save(value + k, FLASH_NO_CUT));
+        if (k < 4) CHECK(0xFFFFFFFEU + k == record(g_flash.last_erase / SLOT_SIZE)->sequence);
+        boot();
+        CHECK(value + k == restored());
+    }
+    CHECK(SM_OK == sm_clear_config());
+    boot();
+    CHECK(0 == restored());
+}
+
+int main(int argc, char ** argv) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s.flash", argv[0]);
+    flash_map(path);
+    test_cuts();
+    test_crc();
+    test_slot_scan();
+    test_rollover();
+    return host_result("sm_config");
+}
@@ -0,0 +1,101 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Address discovery of Sensor Manager (SM_PROBE) on a simulated bus with 0 to 32 devices: every device is found at
+// its address, instances without a device are disabled, and sm_init() stays within SM_CFG_DISCOVERY_TIMEOUT_MS
+// (plus the probe in progress) on a bus where each probe waits for a timeout. Built with SM_CFG_DISCOVERY_ENABLE
+#include "common_utils.h"
+#include "sm.h"
+#include "host.h"
+
+#define INSTANCES       (32)
+#define RANGE_FIRST     (0x10)
+#define RANGE_SIZE      (3)
+// Probe of an empty address (address byte NACKed) and of a device (address and a register read), at 100 kHz
+#define NACK_US         (100U)
+#define FOUND_US        (400U)
+// A bus where the probes of empty addresses end on the 5 ms timeout of the comms layer
+#define STUCK_US        (5000U)
+
+static bool bus[128];
+static uint32_t nack_us;
+static uint32_t probes;
+static uint32_t reads[128];
+
+sm_result fake_sensor_probe(uint8_t address) {
+    probes++;
+    host_advance_us(bus[address] ? FOUND_US : nack_us);
+    return bus[address] ? SM_OK : SM_ERROR;
+}
+void fake_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
+    handle->address = address;
+    handle->channel = channel;
+}
+void fake_sensor_close(sm_handle handle) { (void) handle; }
+sm_sensor_status fake_sensor_read(sm_handle handle, int32_t * data) {
+    reads[handle.address & 0x7f]++;
+    *data = 0;
+    return SM_SENSOR_DATA_VALID;
+}
+
+// Devices in n of the ranges, spread over the bus and at different positions in their range
+static uint8_t device_address(int k, int n) {
+    if ((k * 13) % INSTANCES >= n) return 0;
+    return (uint8_t) (RANGE_FIRST + k * RANGE_SIZE + (k % RANGE_SIZE));
+}
+
+static void run(int n, uint32_t probe_us) {
+    memset(bus, 0, sizeof(bus));
+    memset(reads, 0, sizeof(reads));
+    uint32_t expected_probes = 0;
+    for (int k = 0; k < INSTANCES; k++) {
+        uint8_t address = device_address(k, n);
+        if (0 != address) bus[address] = true;
+        expected_probes += (0 != address) ? (uint32_t) (k % RANGE_SIZE) + 1 : RANGE_SIZE;
+    }
+    nack_us = probe_us;
+    probes = 0;
+    uint64_t start = host_time_us();
+    sm_init();
+    uint32_t init_us = (uint32_t) (host_time_us() - start);
+
+    // Enabled instances have a handle with the address of their device
+    sm_handle handle;
+    uint16_t index = 0;
+    int found = 0;
+    while (0 == sm_get_sensor_handle(SENSOR_ANY_TYPE, &handle, &index)) {
+        int k = (handle.address - RANGE_FIRST) / RANGE_SIZE;
+        CHECK(handle.address == device_address(k, n));
+        found++;
+    }
+    // One interval of sampling, only the devices found are read
+    for (int t = 0; t < 200; t++) {
+        sm_run();
+        host_advance_us(1000);
+    }
+    int read = 0;
+    for (int a = 0; a < 128; a++) {
+        CHECK(bus[a] || (0 == reads[a]));
+        if (0 < reads[a]) read++;
+    }
+    printf("%2d devices, %4u us probes: %3u probes, sm_init %6u us, %2d found, %2d read\n", n, probe_us, probes,
+           init_us, found, read);
+    if (NACK_US == probe_us) {
+        CHECK(n == found);
+        CHECK(n == read);
+        CHECK(expected_probes == probes);
+    } else {
+        // Bounded by the budget, the ranges probed in time are found
+        CHECK(init_us <= SM_CFG_DISCOVERY_TIMEOUT_MS * 1000U + probe_us);
+        CHECK(found <= n);
+    }
+}
+
+int main(void) {
+    static int const devices[] = {0, 1, 2, 4, 8, 16, 32};
+    for (unsigned i = 0; i < sizeof(devices) / sizeof(devices[0]); i++) run(devices[i], NACK_US);
+    for (unsigned i = 0; i < sizeof(devices) / sizeof(devices[0]); i++) run(devices[i], STUCK_US);
+    return host_result("sm_discovery");
+}
@@ -0,0 +1,126 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Deferred dispatch of Sensor Manager (built with SM_CFG_DEFERRED_DISPATCH): four instances due at the same time and a
+// callback slower than SM_CFG_DISPATCH_BUDGET_US. The callbacks carry over to the next sm_run() calls, a sample
+// replaced before its callback ran is counted by sm_get_dispatch_drops(), and the acquisition is not delayed by the
+// callbacks: the four instances are read in the same pass, late by two passes of sm_run() at most.
+#include <string.h>
+#include "common_utils.h"
+#include "sm.h"
+#include "host.h"
+
+#define INSTANCES       (4)
+#define INTERVAL_US     (10000U)
+#define RUN_US          (2000000ULL)
+// Time between two calls of sm_run() by the main loop
+#define LOOP_US         (100U)
+#define ROUNDS          (1024)
+
+static uint32_t callback_us;
+static uint32_t runs;
+static uint32_t reads;
+static uint32_t callbacks;
+static uint32_t run_callbacks;
+static uint32_t max_run_callbacks;
+static uint32_t carried;                // callbacks run in a later sm_run() than the read of their sample
+static uint32_t lost;
+static uint32_t run_lost;
+static uint64_t read_us[INSTANCES][ROUNDS];
+static uint32_t read_run[INSTANCES][ROUNDS];
+static uint32_t rounds[INSTANCES];
+static sm_sequence_tracker trackers[INSTANCES];
+
+void fake_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
+    handle->address = address;
+    handle->channel = channel;
+}
+void fake_sensor_close(sm_handle handle) { (void) handle; }
+sm_sensor_status fake_sensor_read(sm_handle handle, int32_t * data) {
+    uint32_t n = rounds[handle.address]++ % ROUNDS;
+    read_us[handle.address][n] = host_time_us();
+    read_run[handle.address][n] = runs;
+    *data = (int32_t) n;
+    reads++;
+    return SM_SENSOR_DATA_VALID;
+}
+
+static void slow_callback(sm_handle handle, uint8_t * data, uint16_t size) {
+    (void) size;
+    uint32_t n = (uint32_t) *(int32_t *) data;
+    if (read_run[handle.address][n] != runs) carried++;
+    lost += sm_sequence_check(&trackers[handle.address], sm_get_sample_sequence(handle));
+    callbacks++;
+    run_callbacks++;
+    host_advance_us(callback_us);
+}
+
+// Runs the main loop with callbacks of cost us, checks the acquisition timing and the budget
+static void run(uint32_t us) {
+    callback_us = us;
+    reads = callbacks = carried = 0;
+    // Samples of the previous run can still be pending, the rounds and the sequence checks go on
+    uint32_t first_round = rounds[0];
+    uint32_t drops = sm_get_dispatch_drops();
+    uint32_t lost_before = lost;
+    max_run_callbacks = 0;
+    uint64_t max_run_us = 0;
+    uint64_t end = host_time_us() + RUN_US;
+    while (host_time_us() < end) {
+        uint64_t start = host_time_us();
+        run_callbacks = 0;
+        sm_run();
+        if (run_callbacks > max_run_callbacks) max_run_callbacks = run_callbacks;
+        if (host_time_us() - start > max_run_us) max_run_us = host_time_us() - start;
+        runs++;
+        host_advance_us(LOOP_US);
+    }
+    drops = sm_get_dispatch_drops() - drops;
+    run_lost = lost - lost_before;
+    // The instances of a round are read in the same pass, each round starts an interval after the previous one
+    uint64_t max_spread_us = 0;
+    uint64_t max_late_us = 0;
+    for (uint32_t n = first_round + 1; n < rounds[0]; n++) {
+        for (int i = 0; i < INSTANCES; i++) {
+            uint64_t spread = read_us[i][n] - read_us[0][n];
+            uint64_t late = read_us[i][n] - read_us[i][n - 1] - INTERVAL_US;
+            if (spread > max_spread_us) max_spread_us = spread;
+            if (late > max_late_us) max_late_us = late;
+        }
+    }
+    printf("callback %4u us: %u reads, %u callbacks, %u carried over, %u dropped, up to %u callbacks and %llu us "
+           "per sm_run, reads late by %llu us\n", us, reads, callbacks, carried, drops, max_run_callbacks,
+           (unsigned long long) max_run_us, (unsigned long long) max_late_us);
+    CHECK(rounds[0] <= ROUNDS);
+    CHECK(0 == max_spread_us);
+    // The budget is checked after each callback, so one callback can exceed it
+    CHECK(max_run_us <= SM_CFG_DISPATCH_BUDGET_US + us);
+    // An instance becomes due on one pass and is read on the next, a pass is bounded by the budget whatever the
+    // number of pending callbacks, plus 2 ms of systime resolution (SM reads after more than the interval)
+    CHECK(max_late_us <= 2 * (max_run_us + LOOP_US) + 2000U);
+    CHECK(0 < carried);
+    CHECK(run_lost == drops);
+    CHECK(reads - callbacks - drops <= INSTANCES);
+    for (int i = 0; i < INSTANCES; i++) {
+        CHECK(0 == trackers[i].reordered);
+    }
+}
+
+int main(void) {
+    sm_init();
+    sm_register_callback_any_type(slow_callback);
+    // The samples of an instance are numbered from 1, the first ones can be dropped too
+    for (int i = 0; i < INSTANCES; i++) trackers[i].next = 1;
+    // 1.2 ms for three callbacks, the fourth runs on the next sm_run(), soon enough for nothing to be dropped
+    run(400);
+    CHECK(3 == max_run_callbacks);
+    CHECK(0 == run_lost);
+    // A single callback exceeds the budget and fewer passes than instances fit in an interval: the pending samples
+    // are replaced
+    run(6000);
+    CHECK(1 == max_run_callbacks);
+    CHECK(0 < run_lost);
+    return host_result("sm_dispatch");
+}
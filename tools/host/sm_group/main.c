@@ -0,0 +1,151 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Acquisition groups of Sensor Manager (built with SM_CFG_GROUP_ENABLE): the two members of DEFINE_SENSOR_GROUP are
+// triggered together at the group interval, the polled member is read once the measurement started by the trigger is
+// flagged, both samples are published together with the set, and the skew of the set and of sm_get_group_stats() is
+// the time between the two reads. A member that ignores its triggers is released by the group timeout without it
+#include <string.h>
+#include "common_utils.h"
+#include "sm.h"
+#include "host.h"
+
+#define GROUP_INTERVAL_MS   (1000U)
+#define GROUP_TIMEOUT_MS    (100U)
+#define MEASURE_US          (35000U)
+#define READ_US             (150U)
+// Time between two calls of sm_run() by the main loop
+#define LOOP_US             (1000U)
+#define RUN_MS              (20000U)
+// Sets in which the measuring member ignores its trigger
+#define STUCK_FIRST         (10U)
+#define STUCK_LAST          (12U)
+
+static uint8_t flag;
+static bool measuring;
+static uint64_t measure_end_us;
+static uint32_t triggers;
+static uint32_t trigger_ms;
+static uint32_t measuring_reads;
+static uint32_t polled_reads;
+static uint64_t measuring_read_us;
+static uint64_t polled_read_us;
+static uint32_t published;
+static uint32_t sets;
+static uint32_t timeout_sets;
+static uint32_t previous_timestamp;
+static uint32_t last_skew_us;
+static uint32_t max_skew_us;
+
+void measuring_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
+    handle->address = address;
+    handle->channel = channel;
+}
+void measuring_sensor_close(sm_handle handle) { (void) handle; }
+uint8_t * measuring_sensor_get_flag(sm_handle handle) {
+    (void) handle;
+    return &flag;
+}
+void measuring_sensor_trigger(sm_handle handle) {
+    (void) handle;
+    triggers++;
+    trigger_ms = host_time_ms;
+    if ((STUCK_FIRST <= sets) && (STUCK_LAST >= sets)) return;
+    measuring = true;
+    measure_end_us = host_time_us() + MEASURE_US;
+}
+void measuring_sensor_fsm(void) {
+    if (measuring && (host_time_us() >= measure_end_us)) {
+        measuring = false;
+        flag = 1;
+    }
+}
+sm_sensor_status measuring_sensor_read(sm_handle handle, int32_t * data) {
+    (void) handle;
+    host_advance_us(READ_US);
+    measuring_read_us = host_time_us();
+    measuring_reads++;
+    *data = 2500;
+    return SM_SENSOR_DATA_VALID;
+}
+
+void polled_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
+    handle->address = address;
+    handle->channel = channel;
+}
+void polled_sensor_close(sm_handle handle) { (void) handle; }
+sm_sensor_status polled_sensor_read(sm_handle handle, int32_t * data) {
+    (void) handle;
+    host_advance_us(READ_US);
+    polled_read_us = host_time_us();
+    polled_reads++;
+    *data = 150;
+    return SM_SENSOR_DATA_VALID;
+}
+
+static void on_sample(sm_handle handle, uint8_t * data, uint16_t size) {
+    (void) handle;
+    (void) data;
+    (void) size;
+    published++;
+}
+
+static void on_set(sm_group_set const * set) {
+    CHECK(GROUP_compensation == set->group);
+    CHECK(2 == set->members);
+    // Both members were triggered by the group, at the time of the set
+    CHECK(trigger_ms == set->timestamp);
+    if (0 < sets) CHECK(GROUP_INTERVAL_MS == set->timestamp - previous_timestamp);
+    // The samples of the set were published just before it, and none in between
+    CHECK(published == set->complete);
+    if (set->complete < set->members) {
+        CHECK(1 == set->complete);
+        CHECK(0 == set->skew_us);
+        // The polled member is read once the timeout expired
+        CHECK(set->timestamp + GROUP_TIMEOUT_MS <= polled_read_us / 1000U);
+        timeout_sets++;
+    } else {
+        // The polled member is read after the measurement, the skew is the time between the two reads
+        CHECK(polled_read_us > measuring_read_us);
+        CHECK(polled_read_us - measuring_read_us == set->skew_us);
+        CHECK(set->timestamp + MEASURE_US / 1000U <= measuring_read_us / 1000U);
+    }
+    last_skew_us = set->skew_us;
+    if (set->skew_us > max_skew_us) max_skew_us = set->skew_us;
+    previous_timestamp = set->timestamp;
+    published = 0;
+    sets++;
+}
+
+int main(void) {
+    sm_init();
+    sm_register_callback_any_type(on_sample);
+    CHECK(SM_OK == sm_register_group_callback(GROUP_compensation, on_set));
+    CHECK(SM_ERROR == sm_register_group_callback(SM_GROUP_NONE, on_set));
+    while (host_time_ms < RUN_MS) {
+        sm_run();
+        host_advance_us(LOOP_US);
+    }
+    sm_group_stats stats;
+    CHECK(SM_OK == sm_get_group_stats(GROUP_compensation, &stats));
+    printf("%u ms: %u sets, %u timeouts, %u triggers, %u and %u reads, skew %u us, %u us at most\n", RUN_MS,
+           stats.sets, stats.timeouts, triggers, measuring_reads, polled_reads, stats.last_skew_us,
+           stats.max_skew_us);
+    CHECK(RUN_MS / GROUP_INTERVAL_MS - 1 <= sets);
+    CHECK(stats.sets == sets);
+    CHECK(STUCK_LAST - STUCK_FIRST + 1 == timeout_sets);
+    CHECK(stats.timeouts == timeout_sets);
+    CHECK(stats.last_skew_us == last_skew_us);
+    CHECK(stats.max_skew_us == max_skew_us);
+    // Each member is read once per set, at the group interval and not at the interval of the instance, the last set
+    // can still be acquiring
+    CHECK((triggers == sets) || (triggers == sets + 1));
+    CHECK(measuring_reads == sets - timeout_sets);
+    CHECK(polled_reads == sets);
+    // The polled member is read in the pass after the flagged one
+    CHECK(LOOP_US + READ_US <= max_skew_us);
+    CHECK(LOOP_US + 2 * READ_US >= max_skew_us);
+    return host_result("sm_group");
+}
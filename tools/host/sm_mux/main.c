@@ -0,0 +1,135 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Sensor Manager with 256 instances behind 8 I2C muxes (SM_MUX): every driver call reaches its device with only its
+// port enabled on the bus, the instances of a port are serviced together (below one selection per read, a port is
+// selected once per sm_run() except the port split by the rotating start of the pass), every instance is read at its
+// interval, the identical modules get distinct handles, and the scheduling cost per sensor and pass on the host
+#include <string.h>
+#include "common_utils.h"
+#include "sm.h"
+#include "host.h"
+
+#define MUXES           (8)
+#define PORTS           (8)
+#define CHANNELS        (4)
+#define RUN_MS          (10000U)
+#define BENCH_PASSES    (200000)
+// Port state of a mux before its first selection
+#define PORT_UNKNOWN    (0xFEU)
+
+static uint8_t enabled[MUXES];
+static uint32_t selects;
+static uint32_t reselects;              // ports selected again in the same sm_run()
+static uint32_t opens;
+static uint32_t reads;
+static uint32_t misrouted;              // driver calls with another port enabled or a second port enabled
+static uint32_t instance_reads[MUXES * PORTS * CHANNELS];
+static uint8_t selected[MUXES][PORTS];  // selections of each port in the current sm_run()
+
+// Instances are declared port after port, port p of mux m holds the instances 4 * (8 * p + m) to 4 * (8 * p + m) + 3
+static bool routed(sm_handle handle) {
+    int16_t i = sm_get_sensor_index(handle);
+    if (0 > i) return false;
+    int line = i / CHANNELS;
+    for (int m = 0; m < MUXES; m++) {
+        uint8_t expected = (m == line % MUXES) ? (uint8_t) (line / MUXES) : SM_MUX_PORT_NONE;
+        if (enabled[m] != expected) return false;
+    }
+    return true;
+}
+
+static sm_result mux_select(int mux, uint8_t port) {
+    selects++;
+    enabled[mux] = port;
+    if ((SM_MUX_PORT_NONE != port) && (0 < selected[mux][port]++)) reselects++;
+    return SM_OK;
+}
+
+#define MUX_SELECT(M) sm_result m##M##_select(uint8_t port) { return mux_select(M, port); }
+MUX_SELECT(0) MUX_SELECT(1) MUX_SELECT(2) MUX_SELECT(3) MUX_SELECT(4) MUX_SELECT(5) MUX_SELECT(6) MUX_SELECT(7)
+
+void fake_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
+    handle->address = address;
+    handle->channel = channel;
+    opens++;
+}
+void fake_sensor_close(sm_handle handle) { (void) handle; }
+sm_sensor_status fake_sensor_read(sm_handle handle, int32_t * data) {
+    if (!routed(handle)) misrouted++;
+    int16_t i = sm_get_sensor_index(handle);
+    if (0 <= i) instance_reads[i]++;
+    reads++;
+    *data = 2500;
+    return SM_SENSOR_DATA_VALID;
+}
+
+static uint32_t interval_ms(int i) {
+    int line = i / CHANNELS;
+    static uint32_t const intervals[] = {100, 200, 500, 1000};
+    return intervals[(line % MUXES + line / MUXES) % 4];
+}
+
+// Every instance has its own handle and index
+static void test_handles(void) {
+    static bool seen[MUXES * PORTS * CHANNELS];
+    uint16_t index = 0;
+    uint32_t count = 0;
+    sm_handle handle;
+    CHECK(MUXES * PORTS * CHANNELS == sm_get_total_sensor_count());
+    while (0 == sm_get_sensor_handle(SENSOR_ANY_TYPE, &handle, &index)) {
+        int16_t i = sm_get_sensor_index(handle);
+        CHECK((0 <= i) && (MUXES * PORTS * CHANNELS > i));
+        if ((0 <= i) && (MUXES * PORTS * CHANNELS > i)) {
+            CHECK(!seen[i]);
+            seen[i] = true;
+        }
+        count++;
+    }
+    CHECK(MUXES * PORTS * CHANNELS == count);
+}
+
+static void test_routing(void) {
+    uint32_t max_reselects = 0;
+    for (uint32_t t = 0; t < RUN_MS; t++) {
+        memset(selected, 0, sizeof(selected));
+        uint32_t before = reselects;
+        sm_run();
+        if (reselects - before > max_reselects) max_reselects = reselects - before;
+        host_advance_us(1000);
+    }
+    printf("%d sensors, %u ms: %u opens, %u reads, %u mux selections (%.2f per read), %u misrouted, %u ports "
+           "selected again in a pass\n", NUM_SENSORS, RUN_MS, opens, reads, selects, (double) selects / reads,
+           misrouted, reselects);
+    CHECK(MUXES * PORTS * CHANNELS == opens);
+    CHECK(0 == misrouted);
+    // sm_run() starts one instance further on each call, the start can fall within the instances of a port
+    CHECK(1 >= max_reselects);
+    CHECK(selects == sm_get_mux_switches());
+    CHECK(selects < reads);
+    // SM sees the instance due once more than the interval has elapsed and reads it on the next pass
+    uint32_t late = 0;
+    for (int i = 0; i < MUXES * PORTS * CHANNELS; i++) {
+        if (instance_reads[i] < RUN_MS / (interval_ms(i) + 2)) late++;
+    }
+    CHECK(0 == late);
+}
+
+// Cost of a pass of sm_run() with nothing due, per sensor
+static void bench_pass(void) {
+    double start = host_ns();
+    for (int n = 0; n < BENCH_PASSES; n++) sm_run();
+    double ns = (host_ns() - start) / BENCH_PASSES;
+    printf("sm_run() on the host: %.0f ns per pass, %.2f ns per sensor\n", ns, ns / NUM_SENSORS);
+}
+
+int main(void) {
+    memset(enabled, PORT_UNKNOWN, sizeof(enabled));
+    sm_init();
+    test_handles();
+    test_routing();
+    bench_pass();
+    return host_result("sm_mux");
+}
@@ -0,0 +1,138 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Instances paced by their driver (interval 0): a device that fails to open is recovered instead of waiting for a
+// flag forever, and SM_ACQUISITION_INTERVAL is the interval of the driver while it stays the SM interval of a polled
+// instance. Built with SM_CFG_RECOVERY_ENABLE
+#include "common_utils.h"
+#include "sm.h"
+#include "host.h"
+
+// The first opens of the paced device fail
+#define OPEN_FAILURES   (2)
+
+static uint32_t opens;
+static bool device_open;
+static uint8_t flag;
+static uint32_t driver_interval = 1000;
+static uint32_t measure_time;
+static uint32_t flags_set;
+static uint32_t paced_reads;
+static uint32_t poll_reads;
+static uint32_t published[2];
+
+void paced_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
+    handle->address = address;
+    handle->channel = channel;
+    device_open = (++opens > OPEN_FAILURES);
+    measure_time = utils_systime_get();
+}
+void paced_sensor_close(sm_handle handle) {
+    (void) handle;
+    device_open = false;
+}
+// Like the drivers before the fix, a device that failed to open has no flag
+uint8_t * paced_sensor_get_flag(sm_handle handle) {
+    (void) handle;
+    return device_open ? &flag : NULL;
+}
+void paced_sensor_fsm(void) {
+    if (!device_open || (utils_systime_get() - measure_time < driver_interval)) return;
+    measure_time = utils_systime_get();
+    flag = 1;
+    flags_set++;
+}
+sm_sensor_status paced_sensor_read(sm_handle handle, int32_t * data) {
+    (void) handle;
+    *data = 2000;
+    paced_reads++;
+    return device_open ? SM_SENSOR_DATA_VALID : SM_SENSOR_ERROR;
+}
+sm_result paced_sensor_set_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t value) {
+    (void) handle;
+    if (SM_ACQUISITION_INTERVAL != attr) return SM_NOT_SUPPORTED;
+    driver_interval = value;
+    return SM_OK;
+}
+sm_result paced_sensor_get_attr(sm_handle handle, sm_sensor_attributes attr, uint32_t * value) {
+    (void) handle;
+    if (SM_ACQUISITION_INTERVAL != attr) return SM_NOT_SUPPORTED;
+    *value = driver_interval;
+    return SM_OK;
+}
+
+void poll_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
+    handle->address = address;
+    handle->channel = channel;
+}
+void poll_sensor_close(sm_handle handle) { (void) handle; }
+sm_sensor_status poll_sensor_read(sm_handle handle, int32_t * data) {
+    (void) handle;
+    *data = 5000;
+    poll_reads++;
+    return SM_SENSOR_DATA_VALID;
+}
+
+static void count_callback(sm_handle handle, uint8_t * data, uint16_t size) {
+    (void) data;
+    (void) size;
+    published[(HUMIDITY == sm_get_sensor_type_by_handle(handle)) ? 1 : 0]++;
+}
+
+static void run_ms(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t++) {
+        sm_run();
+        host_advance_us(1000);
+    }
+}
+
+int main(void) {
+    sm_handle paced;
+    sm_handle polled;
+    uint16_t index = 0;
+    uint32_t value = 0;
+    sm_init();
+    CHECK(0 == sm_get_sensor_handle(TEMPERATURE, &paced, &index));
+    index = 0;
+    CHECK(0 == sm_get_sensor_handle(HUMIDITY, &polled, &index));
+    sm_register_callback_any_type(count_callback);
+
+    // Both failed opens are recovered (after 100 and 200 ms of backoff), then the flags are read
+    run_ms(5000);
+    sm_recovery_stats stats;
+    CHECK(SM_OK == sm_get_sensor_recovery_stats(paced, &stats));
+    printf("opens %u, errors %u, recoveries %u, flags %u, published %u\n", opens, stats.errors, stats.recoveries,
+           flags_set, published[0]);
+    CHECK(OPEN_FAILURES + 1 == opens);
+    CHECK(OPEN_FAILURES == stats.errors);
+    CHECK(OPEN_FAILURES == stats.recoveries);
+    CHECK(0 < flags_set);
+    CHECK(flags_set == published[0]);
+
+    // The acquisition interval of the paced instance is the driver's, SM keeps reading on the flag only
+    CHECK(SM_OK == sm_get_sensor_attribute(paced, SM_ACQUISITION_INTERVAL, &value));
+    CHECK(1000 == value);
+    CHECK(SM_OK == sm_set_sensor_attribute(paced, SM_ACQUISITION_INTERVAL, 250));
+    CHECK(250 == driver_interval);
+    CHECK(SM_OK == sm_get_sensor_attribute(paced, SM_ACQUISITION_INTERVAL, &value));
+    CHECK(250 == value);
+    uint32_t reads = paced_reads;
+    uint32_t flags = flags_set;
+    run_ms(2000);
+    printf("at 250 ms: flags %u, reads %u\n", flags_set - flags, paced_reads - reads);
+    CHECK(8 == flags_set - flags);
+    CHECK(paced_reads - reads == flags_set - flags);
+
+    // A polled instance is sampled by SM at the interval
+    CHECK(SM_OK == sm_get_sensor_attribute(polled, SM_ACQUISITION_INTERVAL, &value));
+    CHECK(100 == value);
+    CHECK(SM_OK == sm_set_sensor_attribute(polled, SM_ACQUISITION_INTERVAL, 500));
+    run_ms(1);
+    reads = poll_reads;
+    run_ms(2000);
+    printf("polled at 500 ms: reads %u\n", poll_reads - reads);
+    CHECK(4 == poll_reads - reads);
+    return host_result("sm_paced");
+}
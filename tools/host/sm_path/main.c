@@ -0,0 +1,130 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Path index of Sensor Manager (built with SM_CFG_PATH_INDEX_ENABLE): for every path, with and without its leading
+// '/', sm_get_sensor_handle_by_path() returns the handle found by a linear search over the instances in declaration
+// order, with full FNV-1a collisions, collisions of the table slots, long paths and paths shared by several instances.
+// Paths that are not published (prefixes, extensions, a path with the hash of a published one) are not found. Ends
+// with the cost of a lookup against the linear search on the host
+#include <string.h>
+#include "common_utils.h"
+#include "sm.h"
+#include "host.h"
+
+#define MAX_PATH        (256)
+#define BENCH_RUNS      (20000)
+
+#define DRIVER(D)                                                                       \
+    void D##_open(sm_handle * handle, uint8_t address, uint8_t channel) {               \
+        handle->address = address;                                                      \
+        handle->channel = channel;                                                      \
+    }                                                                                   \
+    void D##_close(sm_handle handle) { (void) handle; }                                 \
+    sm_sensor_status D##_read(sm_handle handle, int32_t * data) {                       \
+        (void) handle;                                                                  \
+        *data = 0;                                                                      \
+        return SM_SENSOR_DATA_VALID;                                                    \
+    }
+DRIVER(x_sensor)
+DRIVER(y_sensor)
+DRIVER(a_driver_with_a_rather_long_identifier_used_as_the_last_part_of_the_path_sensor)
+
+static char paths[NUM_SENSORS][MAX_PATH];
+static sm_handle handles[NUM_SENSORS];
+static int num_paths;
+static volatile uint32_t sink;
+
+static uint32_t fnv1a(char const * s) {
+    uint32_t hash = 2166136261U;
+    while ('\0' != *s) hash = (hash ^ (uint8_t) *s++) * 16777619U;
+    return hash;
+}
+
+// Reference: the first instance with the path, in declaration order
+static sm_handle linear_search(char const * path) {
+    sm_handle handle = INVALID_HANDLE_INIT;
+    if ('/' == *path) path++;
+    for (int i = 0; i < num_paths; i++) {
+        if (0 == strcmp(paths[i] + 1, path)) return handles[i];
+    }
+    return handle;
+}
+
+static void check_path(char const * path) {
+    sm_handle found = sm_get_sensor_handle_by_path(path);
+    sm_handle expected = linear_search(path);
+    if (found.value != expected.value) printf("mismatch %s\n", path);
+    CHECK(found.value == expected.value);
+}
+
+static void check_miss(char const * path) {
+    CHECK(0 == linear_search(path).value);
+    CHECK(0 == sm_get_sensor_handle_by_path(path).value);
+}
+
+int main(void) {
+    sm_init();
+    uint16_t index = 0;
+    sm_handle handle;
+    while ((num_paths < NUM_SENSORS) && (0 == sm_get_sensor_handle(SENSOR_ANY_TYPE, &handle, &index))) {
+        handles[num_paths] = handle;
+        snprintf(paths[num_paths], MAX_PATH, "/%s/%s", sm_get_sensor_path_by_handle(handle), sm_get_sensor_id(handle));
+        num_paths++;
+    }
+    CHECK(NUM_SENSORS == num_paths);
+
+    // The index is built with full hash collisions and with collisions of the home slots of different hashes
+    CHECK(fnv1a("costarring/x_sensor") == fnv1a("liquid/x_sensor"));
+    CHECK(fnv1a("declinate/y_sensor") == fnv1a("macallums/y_sensor"));
+    uint32_t slot_collisions = 0;
+    for (int i = 0; i < num_paths; i++) {
+        for (int j = 0; j < i; j++) {
+            uint32_t a = fnv1a(paths[i] + 1);
+            uint32_t b = fnv1a(paths[j] + 1);
+            if ((a != b) && (a % (2U * NUM_SENSORS) == b % (2U * NUM_SENSORS))) slot_collisions++;
+        }
+    }
+    printf("%d instances, %u slot collisions, longest path %zu characters\n", num_paths, slot_collisions,
+           strlen(paths[NUM_SENSORS - 2]));
+    CHECK(0 < slot_collisions);
+
+    for (int i = 0; i < num_paths; i++) {
+        check_path(paths[i]);
+        check_path(paths[i] + 1);
+    }
+    // Instances declared after another one with the same path are not returned
+    CHECK(sm_get_sensor_handle_by_path("/liquid/x_sensor").value != handles[NUM_SENSORS - 3].value);
+
+    // altarage has the hash of zinke, and so has the full path
+    CHECK(fnv1a("altarage/x_sensor") == fnv1a("zinke/x_sensor"));
+    check_miss("/altarage/x_sensor");
+    check_miss("/zinke");
+    check_miss("/zinke/");
+    check_miss("zinke/x_sensor/");
+    check_miss("/zinke/x_senso");
+    check_miss("/zinke/x_sensorx");
+    check_miss("/zinke//x_sensor");
+    check_miss("/x_sensor/zinke");
+    check_miss("");
+    check_miss("/");
+    char changed[MAX_PATH];
+    strcpy(changed, paths[NUM_SENSORS - 2]);
+    changed[100] = '_';
+    check_miss(changed);
+    CHECK(0 == sm_get_sensor_handle_by_path(NULL).value);
+
+    double start = host_ns();
+    for (int n = 0; n < BENCH_RUNS; n++) {
+        for (int i = 0; i < num_paths; i++) sink += sm_get_sensor_handle_by_path(paths[i]).value;
+    }
+    double indexed = (host_ns() - start) / ((double) BENCH_RUNS * num_paths);
+    start = host_ns();
+    for (int n = 0; n < BENCH_RUNS; n++) {
+        for (int i = 0; i < num_paths; i++) sink += linear_search(paths[i]).value;
+    }
+    double linear = (host_ns() - start) / ((double) BENCH_RUNS * num_paths);
+    printf("lookup on the host: %.1f ns with the index, %.1f ns with strcmp() over the instances\n", indexed, linear);
+    return host_result("sm_path");
+}
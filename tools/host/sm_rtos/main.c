@@ -0,0 +1,347 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Sensor Manager on FreeRTOS, polled (sm_run() with a one tick sleep) against event driven (sm_task(), built with
+// SM_CFG_EVENT_DRIVEN): passes and wakeups per second, CPU load and latency from the data ready interrupt of a flagged
+// driver to its read. The scheduler below runs the SM task alone on the simulated time of host.c, a pass of SM costs
+// HOST_PASS_US. Runs at 1000 Hz and 100 Hz ticks, at 100 Hz most deadlines are shorter than a tick. A last run stalls
+// the consumer of the sample queue for STALL_US to overflow it, the test is built once per SM_CFG_QUEUE_OVERFLOW: the
+// counters of sm_get_queue_stats(), the samples lost and kept, and for the policies that never wait, the acquisition
+// timing of the runs without overflow.
+#include <setjmp.h>
+#include <string.h>
+#include "common_utils.h"
+#include "sm.h"
+#include "host.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+
+#define RUN_US          (10000000ULL)
+// Cost of a pass over the three instances, in the order measured on the RA6M4 at 200 MHz
+#define HOST_PASS_US    (20U)
+// Data ready interrupts of flag_sensor, not aligned on the ticks
+#define IRQ_FIRST_US    (37300ULL)
+#define IRQ_PERIOD_US   (250000ULL)
+// The consumer takes nothing for the first 8 s of the overflow run, about 120 samples for a queue of 60
+#define STALL_US        (8000000ULL)
+
+uint32_t host_tick_rate_hz = 1000;
+
+static jmp_buf run_end;
+static uint64_t end_us;
+static uint64_t next_irq_us;
+static uint32_t notified;
+static uint32_t passes;
+static uint32_t wakeups;
+static uint32_t queued;
+static uint32_t poll_reads;
+// Data of the samples, in the order of the reads
+static int32_t next_value;
+static uint64_t stall_end_us;
+static uint32_t stall_reads;
+static int32_t stall_last_value;
+
+static uint8_t flag;
+static uint64_t irq_us;
+static uint32_t flag_reads;
+static uint64_t latency_sum_us;
+static uint64_t latency_max_us;
+
+// Interrupt of flag_sensor: new data
+static void host_irq(void) {
+    flag = 1;
+    irq_us = next_irq_us;
+    next_irq_us += IRQ_PERIOD_US;
+    sm_wake();
+}
+
+// Advance to t, interrupts on the way are taken at their time. Returns at the first interrupt that notified the
+// task when stop_on_notify, the run ends after RUN_US
+static void host_run_until(uint64_t t, bool stop_on_notify) {
+    while (next_irq_us <= t) {
+        if (next_irq_us >= end_us) break;
+        host_advance_us((uint32_t) (next_irq_us - host_time_us()));
+        host_irq();
+        if (stop_on_notify && (0 < notified)) return;
+    }
+    if (t >= end_us) longjmp(run_end, 1);
+    host_advance_us((uint32_t) (t - host_time_us()));
+}
+
+// Time of the tick that ends a wait of n ticks started now
+static uint64_t host_tick_after(TickType_t n) {
+    uint64_t period = 1000000U / host_tick_rate_hz;
+    return (host_time_us() / period + n) * period;
+}
+
+void vTaskDelay(TickType_t n) {
+    host_run_until(host_tick_after(n), false);
+    wakeups++;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t n) {
+    (void) clear;
+    if (0 == notified) host_run_until((portMAX_DELAY == n) ? end_us : host_tick_after(n), true);
+    uint32_t count = notified;
+    notified = 0;
+    wakeups++;
+    return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    (void) task;
+    notified++;
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t * woken) {
+    (void) task;
+    notified++;
+    *woken = pdTRUE;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return (TaskHandle_t) &run_end;
+}
+
+// Queues of SM, bounded as on FreeRTOS. The application task consumes the samples as soon as they are queued, except
+// before stall_end_us
+typedef struct {
+    uint8_t * storage;
+    UBaseType_t length;
+    UBaseType_t size;
+    UBaseType_t head;
+    UBaseType_t count;
+} host_queue;
+
+static host_queue queues[2];
+static uint32_t num_queues;
+static uint32_t removed;            // taken by SM itself (SM_QUEUE_DROP_OLDEST)
+static uint32_t consumed;
+static uint32_t lost;               // gaps in the sequence numbers seen by the consumer
+static int32_t resume_value;        // first sample consumed after the stall
+static uint64_t blocked_us;
+static struct {
+    uint32_t handle;
+    sm_sequence_tracker tracker;
+} seen[3];
+
+static void host_consume_sample(sm_sensor_data const * p_data) {
+    if ((host_time_us() >= stall_end_us) && (0 > resume_value)) resume_value = p_data->data;
+    for (int i = 0; i < 3; i++) {
+        if (0 == seen[i].tracker.next) {
+            // The samples of an instance are numbered from 1, the first ones can be lost too
+            seen[i].handle = p_data->handle.value;
+            seen[i].tracker.next = 1;
+        }
+        if (seen[i].handle != p_data->handle.value) continue;
+        lost += sm_sequence_check(&seen[i].tracker, p_data->sequence);
+        // Samples of an instance arrive in their order
+        CHECK(0 == seen[i].tracker.reordered);
+        break;
+    }
+    consumed++;
+}
+
+static void host_consume(void) {
+    if (host_time_us() < stall_end_us) return;
+    for (uint32_t n = 0; n < num_queues; n++) {
+        host_queue * q = &queues[n];
+        for (; 0 < q->count; q->count--) {
+            if (sizeof(sm_sensor_data) == q->size) host_consume_sample((sm_sensor_data *) &q->storage[q->head * q->size]);
+            q->head = (q->head + 1) % q->length;
+        }
+    }
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t size, uint8_t * storage, StaticQueue_t * queue) {
+    (void) queue;
+    host_queue * q = &queues[num_queues++];
+    *q = (host_queue) {.storage = storage, .length = length, .size = size};
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void * item, TickType_t wait) {
+    host_queue * q = queue;
+    host_consume();
+    if ((q->length == q->count) && (0 < wait)) {
+        // Blocked until the consumer makes room or the wait ends
+        uint64_t start = host_time_us();
+        uint64_t t = host_tick_after(wait);
+        host_run_until((stall_end_us < t) ? stall_end_us : t, false);
+        blocked_us += host_time_us() - start;
+        host_consume();
+    }
+    if (q->length == q->count) return pdFALSE;
+    memcpy(&q->storage[((q->head + q->count) % q->length) * q->size], item, q->size);
+    q->count++;
+    queued++;
+    host_consume();
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void * item, TickType_t wait) {
+    (void) wait;
+    host_queue * q = queue;
+    if (0 == q->count) return pdFALSE;
+    memcpy(item, &q->storage[q->head * q->size], q->size);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    removed++;
+    return pdPASS;
+}
+
+// Data of a new sample
+static int32_t host_sample(void) {
+    if (host_time_us() < stall_end_us) {
+        stall_reads++;
+        stall_last_value = next_value;
+    }
+    return next_value++;
+}
+
+void poll_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
+    handle->address = address;
+    handle->channel = channel;
+}
+void poll_sensor_close(sm_handle handle) { (void) handle; }
+sm_sensor_status poll_sensor_read(sm_handle handle, int32_t * data) {
+    (void) handle;
+    *data = host_sample();
+    poll_reads++;
+    return SM_SENSOR_DATA_VALID;
+}
+
+void flag_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
+    handle->address = address;
+    handle->channel = channel;
+}
+void flag_sensor_close(sm_handle handle) { (void) handle; }
+uint8_t * flag_sensor_get_flag(sm_handle handle) {
+    (void) handle;
+    return &flag;
+}
+sm_sensor_status flag_sensor_read(sm_handle handle, int32_t * data) {
+    (void) handle;
+    *data = host_sample();
+    uint64_t latency = host_time_us() - irq_us;
+    latency_sum_us += latency;
+    if (latency > latency_max_us) latency_max_us = latency;
+    flag_reads++;
+    return SM_SENSOR_DATA_VALID;
+}
+
+// Called once per pass of SM, charges its cost
+void flag_sensor_fsm(void) {
+    passes++;
+    host_consume();
+    host_run_until(host_time_us() + HOST_PASS_US, false);
+}
+
+static char const * const policy_names[] = {"block", "drop newest", "drop oldest", "coalesce"};
+
+// Samples lost and kept when the consumer stalls, SM_CFG_QUEUE_LENGTH samples fit in the queue
+static void check_overflow(uint32_t tick_rate_hz) {
+    sm_queue_stats stats;
+    CHECK(SM_OK == sm_get_queue_stats(&stats));
+    host_consume();
+    uint32_t reads = flag_reads + poll_reads;
+    uint32_t overflow = stall_reads - SM_CFG_QUEUE_LENGTH;
+    printf("%-6s overflow, %s: %u samples during the stall, sent %u dropped %u coalesced %u lost %u, "
+           "blocked %llu ms\n", SM_CFG_EVENT_DRIVEN ? "event" : "polled", policy_names[SM_CFG_QUEUE_OVERFLOW],
+           stall_reads, stats.sent, stats.dropped, stats.coalesced, lost, (unsigned long long) (blocked_us / 1000));
+    CHECK(stall_reads > SM_CFG_QUEUE_LENGTH + 3);
+    CHECK(queued == stats.sent);
+    CHECK(consumed == queued - removed);
+    CHECK(0 == stats.backlog);
+#if SM_QUEUE_COALESCE == SM_CFG_QUEUE_OVERFLOW
+    // The queue keeps the oldest samples, the freshest sample of each of the three instances waits for room, the
+    // others are replaced
+    CHECK(0 == stats.dropped);
+    CHECK(overflow - 3 == stats.coalesced);
+    CHECK(reads == stats.sent + stats.coalesced);
+    CHECK(lost == stats.coalesced);
+    CHECK(0 == resume_value);
+#elif SM_QUEUE_DROP_OLDEST == SM_CFG_QUEUE_OVERFLOW
+    // Every new sample is queued, the queue keeps the latest SM_CFG_QUEUE_LENGTH samples
+    CHECK(overflow == stats.dropped);
+    CHECK(removed == stats.dropped);
+    CHECK(reads == stats.sent);
+    CHECK(lost == stats.dropped);
+    CHECK(stall_last_value - (int32_t) SM_CFG_QUEUE_LENGTH + 1 == resume_value);
+#else
+    // The queue keeps the oldest samples, the new ones are dropped
+    CHECK(reads == stats.sent + stats.dropped);
+    CHECK(lost == stats.dropped);
+    CHECK(0 == resume_value);
+#if SM_QUEUE_BLOCK == SM_CFG_QUEUE_OVERFLOW
+    // SM waits up to SM_CFG_QUEUE_SEND_WAIT ticks for room, the last send may succeed when the consumer resumes
+    CHECK((overflow == stats.dropped) || (overflow - 1 == stats.dropped));
+    CHECK(blocked_us >= (uint64_t) stats.dropped * (SM_CFG_QUEUE_SEND_WAIT - 1) * (1000000U / tick_rate_hz));
+#else
+    CHECK(overflow == stats.dropped);
+    CHECK(0 == blocked_us);
+#endif
+#endif
+}
+
+static void run(uint32_t tick_rate_hz, uint64_t stall_us) {
+    host_tick_rate_hz = tick_rate_hz;
+    host_advance_us((uint32_t) (1000000ULL - host_time_us() % 1000000ULL));
+    uint64_t start = host_time_us();
+    end_us = start + RUN_US;
+    next_irq_us = start + IRQ_FIRST_US;
+    stall_end_us = start + stall_us;
+    notified = passes = wakeups = queued = poll_reads = flag_reads = 0;
+    num_queues = removed = consumed = lost = stall_reads = 0;
+    next_value = 0;
+    resume_value = stall_last_value = -1;
+    memset(seen, 0, sizeof(seen));
+    latency_sum_us = latency_max_us = blocked_us = 0;
+    flag = 0;
+    sm_init();
+    if (0 == setjmp(run_end)) {
+        sm_task();
+    }
+    double seconds = (double) (host_time_us() - start) / 1e6;
+    uint32_t irqs = (uint32_t) ((RUN_US - IRQ_FIRST_US) / IRQ_PERIOD_US) + 1U;
+    printf("%-6s %4u Hz tick: %7.1f passes/s %7.1f wakeups/s  CPU %5.2f %%  latency mean %6.1f us max %6llu us  "
+           "reads %u/%u\n", SM_CFG_EVENT_DRIVEN ? "event" : "polled", tick_rate_hz, passes / seconds, wakeups / seconds,
+           100.0 * passes * HOST_PASS_US / (seconds * 1e6), flag_reads ? (double) latency_sum_us / flag_reads : 0.0,
+           (unsigned long long) latency_max_us, flag_reads, poll_reads);
+    if (0 < stall_us) {
+        check_overflow(tick_rate_hz);
+        // A blocked send delays the acquisition, the other policies never wait
+        if (SM_QUEUE_BLOCK == SM_CFG_QUEUE_OVERFLOW) return;
+    } else {
+        CHECK(queued == flag_reads + poll_reads);
+    }
+    // Every interrupt is read, the polled sensor at its interval (the read is late by up to a tick plus 1 ms)
+    CHECK(irqs == flag_reads);
+    uint32_t tick_ms = 1000U / tick_rate_hz;
+    CHECK(poll_reads >= (uint32_t) (seconds * 1000 / (100 + 1 + tick_ms)) +
+                        (uint32_t) (seconds * 1000 / (1000 + 1 + tick_ms)));
+#if SM_CFG_EVENT_DRIVEN
+    CHECK(latency_max_us <= 2 * HOST_PASS_US);
+    // The task only runs for the samples: no spinning on deadlines shorter than a tick, no waiting for a tick to
+    // read a flagged driver. With SM_QUEUE_COALESCE, SM retries on every tick while samples wait for room
+    CHECK((0 < stall_us) || (passes / seconds < 3 * (flag_reads + poll_reads) / seconds));
+#else
+    // The polled loop wakes up on every tick, a flagged driver is read on the next one
+    CHECK(wakeups / seconds >= 0.9 * tick_rate_hz);
+    CHECK(latency_max_us <= 1000000U / tick_rate_hz + 2 * HOST_PASS_US);
+#endif
+}
+
+int main(void) {
+    run(1000, 0);
+    run(100, 0);
+    run(1000, STALL_US);
+    char name[64];
+    snprintf(name, sizeof(name), "sm_rtos %s, %s", SM_CFG_EVENT_DRIVEN ? "event driven" : "polled",
+             policy_names[SM_CFG_QUEUE_OVERFLOW]);
+    return host_result(name);
+}
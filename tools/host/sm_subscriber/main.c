@@ -0,0 +1,167 @@
+/*
+* Copyright (c) 2020 - 2024 Renesas Electronics Corporation and/or its affiliates
+*
+* SPDX-License-Identifier:  BSD-3-Clause
+*/
+// Sample fan-out of Sensor Manager: delivery to every subscriber, reference counting of the shared records with
+// more subscribers than an 8-bit count holds, and the dispatch cost at 1, 4 and 16 subscribers. The FSM of the driver
+// of the three instances runs once per sm_run() call (built with SM_CFG_FSM_TIMING_ENABLE)
+#include "common_utils.h"
+#include "sm.h"
+#include "sm_subscriber.h"
+#include "host.h"
+
+// More ring subscribers than an 8-bit reference count holds
+#define MANY_SUBSCRIBERS    (300)
+#define BENCH_SAMPLES       (1000000)
+#define FSM_US              (5U)
+#define RUN_MS              (1000U)
+
+static int32_t counter;
+static uint32_t delivered;
+static uint32_t fsm_calls;
+static uint32_t reads;
+
+void fake_sensor_open(sm_handle * handle, uint8_t address, uint8_t channel) {
+    handle->address = address;
+    handle->channel = channel;
+}
+void fake_sensor_close(sm_handle handle) { (void) handle; }
+sm_sensor_status fake_sensor_read(sm_handle handle, int32_t * data) {
+    (void) handle;
+    *data = counter++;
+    reads++;
+    return SM_SENSOR_DATA_VALID;
+}
+void fake_sensor_fsm(void) {
+    fsm_calls++;
+    host_advance_us(FSM_US);
+}
+
+static void count_callback(sm_sample const * p_sample, void * p_context) {
+    (void) p_sample;
+    (*(uint32_t *) p_context)++;
+    delivered++;
+}
+
+static sm_subscriber subscribers[MANY_SUBSCRIBERS];
+static sm_sample const * rings[MANY_SUBSCRIBERS][1];
+
+static void unsubscribe_all(void) {
+    for (int i = 0; i < MANY_SUBSCRIBERS; i++) sm_unsubscribe(&subscribers[i]);
+}
+
+// Every subscriber of a type gets each sample of that type once
+static void test_fan_out(void) {
+    uint32_t counts[3] = {0};
+    sm_handle handle = {.value = 0};
+    handle.channel = SM_CH0;
+    handle.address = 0;
+    for (int i = 0; i < 3; i++) {
+        sm_subscriber_init(&subscribers[i], count_callback, &counts[i], NULL, 0, SM_OVERFLOW_DROP_NEWEST);
+        CHECK(SM_OK == sm_subscribe_by_type(&subscribers[i], (i < 2) ? TEMPERATURE : HUMIDITY));
+    }
+    int32_t value = 1;
+    for (int n = 0; n < 10; n++) sm_subscriber_publish(TEMPERATURE, handle, (uint8_t *) &value, sizeof(value), n);
+    CHECK(10 == counts[0]);
+    CHECK(10 == counts[1]);
+    CHECK(0 == counts[2]);
+    unsubscribe_all();
+}
+
+// A record held by more than 255 rings must not be reused before the last of them releases it
+static void test_many_references(void) {
+    sm_handle handle = {.value = 0};
+    for (int i = 0; i < MANY_SUBSCRIBERS; i++) {
+        sm_subscriber_init(&subscribers[i], NULL, NULL, rings[i], 1, SM_OVERFLOW_DROP_NEWEST);
+        CHECK(SM_OK == sm_subscribe_by_type(&subscribers[i], (0 == i) ? HUMIDITY : TEMPERATURE));
+    }
+    int32_t value = 1234;
+    sm_subscriber_publish(TEMPERATURE, handle, (uint8_t *) &value, sizeof(value), 0);
+    // Half of the subscribers are done with the sample, the others still hold it
+    sm_sample const * p_sample;
+    for (int i = 1; i <= MANY_SUBSCRIBERS / 2; i++) {
+        if (SM_OK == sm_subscriber_receive(&subscribers[i], &p_sample)) sm_sample_release(p_sample);
+    }
+    // Cycle through the whole pool, only the subscriber 0 keeps these
+    for (int32_t n = 0; n < 4 * (int32_t) SM_CFG_SAMPLE_POOL_SIZE; n++) {
+        sm_subscriber_publish(HUMIDITY, handle, (uint8_t *) &n, sizeof(n), (uint32_t) n);
+        if (SM_OK == sm_subscriber_receive(&subscribers[0], &p_sample)) sm_sample_release(p_sample);
+    }
+    uint32_t intact = 0;
+    for (int i = MANY_SUBSCRIBERS / 2 + 1; i < MANY_SUBSCRIBERS; i++) {
+        if (SM_OK == sm_subscriber_receive(&subscribers[i], &p_sample)) {
+            if (1234 == p_sample->data) intact++;
+            sm_sample_release(p_sample);
+        }
+    }
+    CHECK((MANY_SUBSCRIBERS - 1 - MANY_SUBSCRIBERS / 2) == intact);
+    CHECK(0 == sm_subscriber_get_pool_drops());
+    unsubscribe_all();
+    // All records are free again
+    sm_subscriber_init(&subscribers[0], NULL, NULL, rings[0], 1, SM_OVERFLOW_DROP_OLDEST);
+    sm_subscribe_by_type(&subscribers[0], SENSOR_ANY_TYPE);
+    for (int32_t n = 0; n < (int32_t) SM_CFG_SAMPLE_POOL_SIZE; n++) {
+        sm_subscriber_publish(TEMPERATURE, handle, (uint8_t *) &n, sizeof(n), (uint32_t) n);
+    }
+    CHECK(0 == sm_subscriber_get_pool_drops());
+    unsubscribe_all();
+}
+
+// One driver behind three instances: its FSM runs once per sm_run(), not once per instance
+static void test_fsm_once_per_pass(void) {
+    uint32_t runs = 0;
+    for (uint32_t t = 0; t < RUN_MS; t++) {
+        sm_run();
+        runs++;
+        host_advance_us(1000U - FSM_US);
+    }
+    sm_driver_stats stats;
+    CHECK(SM_OK == sm_get_driver_fsm_stats(DRIVER_fake_sensor, &stats));
+    printf("%u sm_run() calls: %u reads, %u FSM calls, %llu us in the FSM\n", runs, reads, fsm_calls,
+           (unsigned long long) stats.total_us);
+    CHECK(3 * (RUN_MS / 101) <= reads);
+    CHECK(runs == fsm_calls);
+    CHECK(runs == stats.calls);
+    CHECK(FSM_US == stats.max_us);
+    CHECK((uint64_t) runs * FSM_US == stats.total_us);
+}
+
+// Dispatch cost per published sample, callback subscribers and ring subscribers drained after each sample
+static void bench_dispatch(void) {
+    static int const counts[] = {1, 4, 16};
+    sm_handle handle = {.value = 0};
+    int32_t value = 1;
+    uint32_t calls = 0;
+    for (int k = 0; k < 3; k++) {
+        for (int ring = 0; ring < 2; ring++) {
+            for (int i = 0; i < counts[k]; i++) {
+                sm_subscriber_init(&subscribers[i], ring ? NULL : count_callback, &calls, ring ? rings[i] : NULL,
+                                   ring ? 1 : 0, SM_OVERFLOW_DROP_OLDEST);
+                sm_subscribe_by_type(&subscribers[i], SENSOR_ANY_TYPE);
+            }
+            double start = host_ns();
+            for (uint32_t n = 0; n < BENCH_SAMPLES; n++) {
+                sm_subscriber_publish(TEMPERATURE, handle, (uint8_t *) &value, sizeof(value), n);
+                for (int i = 0; ring && (i < counts[k]); i++) {
+                    sm_sample const * p_sample;
+                    if (SM_OK == sm_subscriber_receive(&subscribers[i], &p_sample)) sm_sample_release(p_sample);
+                }
+            }
+            double ns = (host_ns() - start) / BENCH_SAMPLES;
+            printf("  %2d %s subscribers: %6.1f ns/sample, %5.1f ns/delivery\n", counts[k],
+                   ring ? "ring    " : "callback", ns, ns / counts[k]);
+            unsubscribe_all();
+        }
+    }
+    CHECK(0 == sm_subscriber_get_pool_drops());
+}
+
+int main(void) {
+    sm_init();
+    test_fsm_once_per_pass();
+    test_fan_out();
+    test_many_references();
+    bench_dispatch();
+    return host_result("sm_subscriber");
+}